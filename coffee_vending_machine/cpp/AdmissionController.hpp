@@ -0,0 +1,133 @@
+#ifndef ADMISSION_CONTROLLER_HPP
+#define ADMISSION_CONTROLLER_HPP
+
+#include "BrewQueue.hpp"
+#include "Inventory.hpp"
+#include <cstddef>
+#include <cstdint>
+
+// Admission control for new selections. Under a rush the machine would
+// otherwise accept every order and let the brew queue grow without bound,
+// so the last customers wait many minutes or find the stock gone by the
+// time their cycle starts. Before a selection is accepted the controller
+// projects what the order would face:
+//
+//   wait  = brew backlog (BrewQueue::estimateBacklogMs) + this drink's prep
+//   stock = cups of this recipe left after queued orders' reservations
+//
+// and answers ADMIT, DEFER (over the wait target but the backlog drains
+// soon - "try again in N s") or REJECT (queue too deep, wait far past
+// target, or no projected stock). Rejections and deferrals are "shed" and
+// counted so the operator can see how often the machine turns people away.
+
+struct AdmissionConfig {
+    int64_t targetWaitMs = 180000;  // defer selections projected to wait longer
+    int64_t maxWaitMs = 420000;     // reject them outright beyond this
+    size_t maxQueueDepth = 24;      // orders queued or brewing
+    int minCupsLeft = 1;            // projected stock needed to accept
+};
+
+enum class AdmissionVerdict { ADMIT, DEFER, REJECT };
+
+enum class ShedReason { NONE, QUEUE_DEPTH, WAIT, STOCK };
+
+struct AdmissionDecision {
+    AdmissionVerdict verdict = AdmissionVerdict::ADMIT;
+    ShedReason reason = ShedReason::NONE;
+    int64_t estimatedWaitMs = 0;
+    int64_t retryAfterMs = 0;       // DEFER: when the wait should be back on target
+    size_t queueDepth = 0;
+    int cupsLeft = 0;
+
+    bool admitted() const { return verdict == AdmissionVerdict::ADMIT; }
+};
+
+class AdmissionController {
+public:
+    using Config = AdmissionConfig;
+
+    struct Stats {
+        uint64_t evaluated = 0;
+        uint64_t admitted = 0;
+        uint64_t deferred = 0;
+        uint64_t rejectedDepth = 0;
+        uint64_t rejectedWait = 0;
+        uint64_t rejectedStock = 0;
+        size_t queueDepth = 0;      // at the last evaluation
+        size_t peakQueueDepth = 0;
+        uint64_t depthSum = 0;      // for the mean depth seen by arrivals
+        int64_t lastEstimateMs = 0;
+        double recentShedRate = 0.0; // exponentially weighted, ~last 32 selections
+
+        uint64_t shed() const { return deferred + rejectedDepth + rejectedWait + rejectedStock; }
+        double shedRate() const { return evaluated ? static_cast<double>(shed()) / evaluated : 0.0; }
+        double meanQueueDepth() const { return evaluated ? static_cast<double>(depthSum) / evaluated : 0.0; }
+    };
+
+private:
+    Config config;
+    Stats stats;
+    AdmissionDecision last;
+
+    AdmissionDecision record(AdmissionDecision decision) {
+        last = decision;
+        stats.evaluated++;
+        stats.queueDepth = decision.queueDepth;
+        if (decision.queueDepth > stats.peakQueueDepth) stats.peakQueueDepth = decision.queueDepth;
+        stats.depthSum += decision.queueDepth;
+        stats.lastEstimateMs = decision.estimatedWaitMs;
+
+        switch (decision.reason) {
+            case ShedReason::NONE: stats.admitted++; break;
+            case ShedReason::QUEUE_DEPTH: stats.rejectedDepth++; break;
+            case ShedReason::STOCK: stats.rejectedStock++; break;
+            case ShedReason::WAIT:
+                if (decision.verdict == AdmissionVerdict::DEFER) stats.deferred++;
+                else stats.rejectedWait++;
+                break;
+        }
+        double shedNow = decision.admitted() ? 0.0 : 1.0;
+        stats.recentShedRate += (shedNow - stats.recentShedRate) / 32.0;
+        return decision;
+    }
+
+public:
+    explicit AdmissionController(Config admissionConfig = Config()) : config(admissionConfig) {
+        if (config.maxWaitMs < config.targetWaitMs) config.maxWaitMs = config.targetWaitMs;
+        if (config.maxQueueDepth < 1) config.maxQueueDepth = 1;
+    }
+
+    // Decide on one selection. queue is null when the machine brews
+    // directly, in which case only this order's own prep time counts.
+    AdmissionDecision evaluate(const Inventory& inventory, const BrewQueue* queue,
+                               const Recipe& recipe, int prepSeconds) {
+        AdmissionDecision decision;
+        decision.queueDepth = queue ? queue->getDepth() : 0;
+        decision.cupsLeft = inventory.availableCups(recipe);
+        decision.estimatedWaitMs = (queue ? queue->estimateBacklogMs() : 0)
+                                 + static_cast<int64_t>(prepSeconds) * 1000;
+
+        if (decision.queueDepth >= config.maxQueueDepth) {
+            decision.verdict = AdmissionVerdict::REJECT;
+            decision.reason = ShedReason::QUEUE_DEPTH;
+        } else if (decision.cupsLeft < config.minCupsLeft) {
+            decision.verdict = AdmissionVerdict::REJECT;
+            decision.reason = ShedReason::STOCK;
+        } else if (decision.estimatedWaitMs > config.maxWaitMs) {
+            decision.verdict = AdmissionVerdict::REJECT;
+            decision.reason = ShedReason::WAIT;
+        } else if (decision.estimatedWaitMs > config.targetWaitMs) {
+            decision.verdict = AdmissionVerdict::DEFER;
+            decision.reason = ShedReason::WAIT;
+            decision.retryAfterMs = decision.estimatedWaitMs - config.targetWaitMs;
+        }
+        return record(decision);
+    }
+
+    const Config& getConfig() const { return config; }
+    const Stats& getStats() const { return stats; }
+    const AdmissionDecision& getLastDecision() const { return last; }
+    void resetStats() { stats = Stats(); }
+};
+
+#endif // ADMISSION_CONTROLLER_HPP
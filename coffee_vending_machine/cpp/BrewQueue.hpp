@@ -0,0 +1,343 @@
+#ifndef BREW_QUEUE_HPP
+#define BREW_QUEUE_HPP
+
+#include "CoffeeFactory.hpp"
+#include "Inventory.hpp"
+#include "MenuConfig.hpp"
+#include "MachineEventLog.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Per-order completion notice from a brew cycle
+struct BrewCompletion {
+    uint64_t orderId;
+    CoffeeType type;
+    uint64_t cycleId;
+    int cupsInCycle;
+    int64_t enqueuedAt;
+    int64_t completedAt;
+};
+
+struct BrewQueueConfig {
+    int64_t windowMs = 30000;   // how long the oldest order waits for company
+    int maxCupsPerCycle = 6;
+    int extraCupPercent = 25;   // marginal time per extra cup in a cycle
+};
+
+// Observer Pattern - notified once per order when its cycle finishes
+class BrewObserver {
+public:
+    virtual ~BrewObserver() = default;
+    virtual void onOrderCompleted(const BrewCompletion& completion) = 0;
+};
+
+// Paid orders waiting for the brewer. Orders for the same drink that arrive
+// within the coalescing window of the oldest pending one are merged into a
+// single multi-cup cycle: one prepare(), one consumeIngredients() for the
+// whole group, and a per-order completion for each. A cycle costs the
+// drink's preparation time plus extraCupPercent of it for every extra cup.
+//
+// Driven by poll(): the machine's owner calls it whenever time advances
+// (nextDueTime() says when it next has work). Ingredients are reserved in
+// the Inventory at enqueue time, so new selections only see stock that is
+// not already promised to a queued order.
+class BrewQueue {
+public:
+    using TimeSource = int64_t (*)();
+
+    using Config = BrewQueueConfig;
+
+    struct Stats {
+        uint64_t ordersQueued = 0;
+        uint64_t ordersCompleted = 0;
+        uint64_t cycles = 0;
+        int64_t brewingMs = 0;
+    };
+
+    // Queue contents for handing a machine to another process (see
+    // MachineMigration.hpp). Times are relative to the queue's clock at
+    // export, so the receiving side may run a different clock.
+    struct OrderImage {
+        uint64_t orderId;
+        CoffeeType type;
+        int64_t ageMs;                 // since it was enqueued
+        bool onMenu;                   // placed on a menu version
+        uint64_t menuVersion;
+    };
+
+    struct Image {
+        std::vector<OrderImage> pending;
+        std::vector<OrderImage> active; // the cycle brewing now, if any
+        uint64_t cycleId = 0;
+        int64_t remainingMs = 0;        // until the active cycle finishes
+        uint64_t nextOrderId = 1;
+        Stats stats;
+    };
+
+private:
+    struct PendingOrder {
+        uint64_t orderId;
+        CoffeeType type;
+        int64_t enqueuedAt;
+        MenuHandle menu; // version the order was placed on, if any
+    };
+
+    struct Cycle {
+        uint64_t cycleId = 0;
+        CoffeeType type = CoffeeType::ESPRESSO;
+        MenuHandle menu;
+        std::vector<PendingOrder> orders;
+        int64_t finishAt = 0;
+    };
+
+    Inventory* inventory;
+    Config config;
+    TimeSource clock;
+    MachineEventLog* eventLog = nullptr;
+    std::vector<BrewObserver*> observers;
+
+    std::deque<PendingOrder> pending;
+    Cycle active;
+    bool brewing = false;
+    uint64_t nextOrderId = 1;
+    Stats stats;
+
+    static int64_t steadyClockMillis() {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    static const Recipe& recipeFor(CoffeeType type, const MenuHandle& menu) {
+        return menu ? menu->item(type).recipe : Inventory::getRecipe(type);
+    }
+
+    // Only orders for the same drink on the same menu version share a cycle
+    static bool sameBrew(const PendingOrder& a, const PendingOrder& b) {
+        return a.type == b.type && a.menu.get() == b.menu.get();
+    }
+
+    int countPending(const PendingOrder& like) const {
+        int count = 0;
+        for (const auto& order : pending) {
+            if (sameBrew(order, like)) count++;
+        }
+        return count;
+    }
+
+    bool headReady(int64_t now) const {
+        if (pending.empty()) return false;
+        const PendingOrder& head = pending.front();
+        return now - head.enqueuedAt >= config.windowMs
+            || countPending(head) >= config.maxCupsPerCycle;
+    }
+
+    void startCycle(int64_t now) {
+        const PendingOrder head = pending.front();
+        active = Cycle();
+        active.cycleId = ++stats.cycles;
+        active.type = head.type;
+        active.menu = head.menu;
+
+        // Take the head plus compatible orders from its window, in FIFO order
+        for (auto it = pending.begin(); it != pending.end() &&
+                 static_cast<int>(active.orders.size()) < config.maxCupsPerCycle;) {
+            if (sameBrew(*it, head) && it->enqueuedAt - head.enqueuedAt <= config.windowMs) {
+                active.orders.push_back(*it);
+                it = pending.erase(it);
+            } else {
+                ++it;
+            }
+        }
+
+        int cups = static_cast<int>(active.orders.size());
+        auto coffee = CoffeeFactory::createCoffee(head.type);
+        if (cups > 1) {
+            std::cout << "Brew cycle #" << active.cycleId << ": " << cups << " x "
+                      << coffee->getName() << "\n";
+        }
+        coffee->prepare();
+        const Recipe& recipe = recipeFor(head.type, head.menu);
+        inventory->releaseReservation(recipe, cups);
+        inventory->consumeIngredients(recipe, cups);
+
+        int prepSeconds = head.menu ? head.menu->item(head.type).preparationTime : coffee->getPreparationTime();
+        int64_t prepMs = static_cast<int64_t>(prepSeconds) * 1000;
+        int64_t duration = prepMs + prepMs * config.extraCupPercent / 100 * (cups - 1);
+        active.finishAt = now + duration;
+        stats.brewingMs += duration;
+        brewing = true;
+    }
+
+    void finishCycle() {
+        int cups = static_cast<int>(active.orders.size());
+        std::string name = CoffeeFactory::getCoffeeTypeName(active.type);
+        for (const auto& order : active.orders) {
+            std::cout << "*** Order #" << order.orderId << ": your " << name << " is ready! ***\n";
+            if (eventLog) eventLog->append(MachineEventType::COMPLETE, static_cast<int>(active.type));
+            BrewCompletion completion{order.orderId, active.type, active.cycleId, cups,
+                                      order.enqueuedAt, active.finishAt};
+            for (auto* observer : observers) {
+                observer->onOrderCompleted(completion);
+            }
+        }
+        stats.ordersCompleted += static_cast<uint64_t>(cups);
+        active.orders.clear(); // unpins their menu version
+        active.menu.reset();
+        brewing = false;
+    }
+
+public:
+    explicit BrewQueue(Inventory* machineInventory, Config queueConfig = Config())
+        : inventory(machineInventory), config(queueConfig), clock(&steadyClockMillis) {
+        if (config.maxCupsPerCycle < 1) config.maxCupsPerCycle = 1;
+        if (config.windowMs < 0) config.windowMs = 0;
+    }
+
+    BrewQueue(const BrewQueue&) = delete;
+    BrewQueue& operator=(const BrewQueue&) = delete;
+
+    // Replace the clock (simulations)
+    void setTimeSource(TimeSource source) { clock = source ? source : &steadyClockMillis; }
+
+    void setEventLog(MachineEventLog* log) { eventLog = log; }
+
+    // Accept a paid order; returns its order number. An order placed on a
+    // menu version keeps it pinned and is brewed to that version's recipe.
+    uint64_t enqueue(CoffeeType type, MenuHandle menu = MenuHandle()) {
+        inventory->reserveIngredients(recipeFor(type, menu));
+        uint64_t orderId = nextOrderId++;
+        pending.push_back({orderId, type, clock(), std::move(menu)});
+        stats.ordersQueued++;
+        return orderId;
+    }
+
+    // Finish due cycles and start ready ones; returns orders completed
+    int poll() {
+        int64_t now = clock();
+        int completed = 0;
+        while (true) {
+            if (brewing && now >= active.finishAt) {
+                completed += static_cast<int>(active.orders.size());
+                finishCycle();
+            } else if (!brewing && headReady(now)) {
+                startCycle(now);
+            } else {
+                break;
+            }
+        }
+        return completed;
+    }
+
+    // Earliest time poll() has something to do, or INT64_MAX if nothing
+    int64_t nextDueTime() const {
+        if (brewing) return active.finishAt;
+        if (pending.empty()) return INT64_MAX;
+        const PendingOrder& head = pending.front();
+        if (countPending(head) >= config.maxCupsPerCycle) return head.enqueuedAt;
+        return head.enqueuedAt + config.windowMs;
+    }
+
+    // Time until the brewer would finish everything queued now: the rest of
+    // the active cycle, the head's remaining coalescing window, then the
+    // pending orders grouped into cycles the way startCycle() would
+    int64_t estimateBacklogMs() const {
+        int64_t now = clock();
+        int64_t backlog = brewing ? std::max<int64_t>(active.finishAt - now, 0) : 0;
+        if (pending.empty()) return backlog;
+        if (!brewing && countPending(pending.front()) < config.maxCupsPerCycle) {
+            backlog += std::max<int64_t>(pending.front().enqueuedAt + config.windowMs - now, 0);
+        }
+
+        std::vector<bool> grouped(pending.size(), false);
+        for (size_t i = 0; i < pending.size(); ++i) {
+            if (grouped[i]) continue;
+            const PendingOrder& head = pending[i];
+            int cups = 0;
+            for (size_t j = i; j < pending.size() && cups < config.maxCupsPerCycle; ++j) {
+                if (!grouped[j] && sameBrew(pending[j], head) &&
+                    pending[j].enqueuedAt - head.enqueuedAt <= config.windowMs) {
+                    grouped[j] = true;
+                    cups++;
+                }
+            }
+            int prepSeconds = head.menu ? head.menu->item(head.type).preparationTime
+                                        : CoffeeFactory::createCoffee(head.type)->getPreparationTime();
+            int64_t prepMs = static_cast<int64_t>(prepSeconds) * 1000;
+            backlog += prepMs + prepMs * config.extraCupPercent / 100 * (cups - 1);
+        }
+        return backlog;
+    }
+
+    Image exportImage() const {
+        int64_t now = clock();
+        auto imageOf = [now](const PendingOrder& order) {
+            return OrderImage{order.orderId, order.type, now - order.enqueuedAt, static_cast<bool>(order.menu),
+                              order.menu ? order.menu->version : 0};
+        };
+        Image image;
+        for (const auto& order : pending) image.pending.push_back(imageOf(order));
+        if (brewing) {
+            for (const auto& order : active.orders) image.active.push_back(imageOf(order));
+            image.cycleId = active.cycleId;
+            image.remainingMs = std::max<int64_t>(active.finishAt - now, 0);
+        }
+        image.nextOrderId = nextOrderId;
+        image.stats = stats;
+        return image;
+    }
+
+    // Take over an exported queue; false (nothing changed) unless this
+    // queue is idle and menu holds the version of every order placed on a
+    // menu. Reservations are not touched: they travel with the inventory.
+    bool restoreImage(const Image& image, const MenuHandle& menu = MenuHandle()) {
+        if (!isIdle()) return false;
+        auto placedOn = [&menu](const OrderImage& order) {
+            return !order.onMenu || (menu && menu->version == order.menuVersion);
+        };
+        if (!std::all_of(image.pending.begin(), image.pending.end(), placedOn) ||
+            !std::all_of(image.active.begin(), image.active.end(), placedOn)) {
+            return false;
+        }
+        int64_t now = clock();
+        auto orderOf = [now, &menu](const OrderImage& order) {
+            return PendingOrder{order.orderId, order.type, now - order.ageMs, order.onMenu ? menu : MenuHandle()};
+        };
+        for (const auto& order : image.pending) pending.push_back(orderOf(order));
+        if (!image.active.empty()) {
+            active = Cycle();
+            active.cycleId = image.cycleId;
+            active.type = image.active.front().type;
+            for (const auto& order : image.active) active.orders.push_back(orderOf(order));
+            active.menu = active.orders.front().menu;
+            active.finishAt = now + image.remainingMs;
+            brewing = true;
+        }
+        nextOrderId = image.nextOrderId;
+        stats = image.stats;
+        return true;
+    }
+
+    // Orders accepted but not yet handed over, including the active cycle
+    size_t getDepth() const { return pending.size() + (brewing ? active.orders.size() : 0); }
+
+    void addObserver(BrewObserver* observer) {
+        observers.push_back(observer);
+    }
+
+    void removeObserver(BrewObserver* observer) {
+        observers.erase(std::remove(observers.begin(), observers.end(), observer), observers.end());
+    }
+
+    size_t getPendingCount() const { return pending.size(); }
+    bool isBrewing() const { return brewing; }
+    bool isIdle() const { return !brewing && pending.empty(); }
+    const Config& getConfig() const { return config; }
+    const Stats& getStats() const { return stats; }
+};
+
+#endif // BREW_QUEUE_HPP
@@ -1,12 +1,15 @@
 #ifndef COFFEE_HPP
 #define COFFEE_HPP
 
+#include "Money.hpp"
+#include "OrderArena.hpp"
 #include <string>
 #include <iostream>
 
 // Abstract Product - Part of Factory Pattern
 // Demonstrates Abstraction (OOP)
-class Coffee {
+// Allocated from the machine's per-order arena (see OrderArena.hpp)
+class Coffee : public ArenaAllocated {
 protected:
     std::string name;
     double price;
@@ -16,12 +19,12 @@ public:
     virtual ~Coffee() = default;
     virtual void prepare() = 0;
 
-    std::string getName() const { return name; }
+    const std::string& getName() const { return name; }
     double getPrice() const { return price; }
     int getPreparationTime() const { return preparationTime; }
 
     friend std::ostream& operator<<(std::ostream& os, const Coffee& coffee) {
-        os << coffee.name << " - $" << coffee.price;
+        os << coffee.name << " - $" << Dollars{coffee.price};
         return os;
     }
 };
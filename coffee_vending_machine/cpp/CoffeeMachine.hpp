@@ -6,6 +6,17 @@
 #include "PaymentStrategy.hpp"
 #include "Inventory.hpp"
 #include "MachineState.hpp"
+#include "Seqlock.hpp"
+#include "ProfiledMutex.hpp"
+#include "MachineEventLog.hpp"
+#include "TelemetrySegment.hpp"
+#include "BrewQueue.hpp"
+#include "PricingEngine.hpp"
+#include "MenuConfig.hpp"
+#include "AdmissionController.hpp"
+#include "TimerWheel.hpp"
+#include "ReceiptLog.hpp"
+#include <cmath>
 #include <memory>
 #include <mutex>
 #include <iostream>
@@ -16,27 +27,85 @@ class SelectingState;
 class ProcessingState;
 class DispensingState;
 
+// Point-in-time copy of the machine state for monitoring readers
+struct MachineStatusSnapshot {
+    char stateName[16] = {};
+    bool operational = true;
+    int selectedType = -1; // CoffeeType of the pending order, -1 if none
+};
+
+// Deadlines for one customer session at the machine (see attachTimers)
+struct SessionTimeoutConfig {
+    int64_t selectionTimeoutMs = 60000; // unpaid selection is cancelled after this
+    int64_t paymentRetryMs = 30000;     // after a declined payment, time to retry
+    int maxPaymentAttempts = 3;         // declines before the order is cancelled
+    bool holdIngredients = true;        // reserve the recipe while selected
+};
+
+// The customer session and counters of a machine, for handing it to
+// another process (see MachineMigration.hpp)
+struct MachineSessionImage {
+    MachinePhase phase = MachinePhase::IDLE;
+    bool operational = true;
+    int selectedType = -1;
+    bool holdingIngredients = false;   // the selection's recipe is reserved
+    int paymentAttempts = 0;
+    double quotedPrice = 0.0;          // what the selection will be charged
+    uint64_t sessionTimeouts = 0;
+    bool onMenu = false;               // pending order pinned to a menu version
+    uint64_t menuVersion = 0;
+    uint64_t appliedMenuVersion = UINT64_MAX;
+};
+
 // Singleton Pattern - Ensures only one instance of CoffeeMachine exists
 // Demonstrates Encapsulation (OOP)
 class CoffeeMachine {
 private:
+    // Declared first so it outlives every object allocated from it
+    OrderArena orderArena;
     std::unique_ptr<MachineState> currentState;
     std::unique_ptr<Inventory> inventory;
     std::unique_ptr<Coffee> selectedCoffee;
     CoffeeType selectedCoffeeType;
     bool isOperational;
+    Seqlock<MachineStatusSnapshot> status;
+    MachineEventLog* eventLog = nullptr;
+    BrewQueue* brewQueue = nullptr;
+    MachineTelemetry* telemetry = nullptr;
+    const PricingEngine* pricing = nullptr;
+    uint32_t pricingSite = 0;
+    const MenuRegistry* menu = nullptr;
+    AdmissionController* admission = nullptr;
+    TimerWheel* timers = nullptr;
+    SessionTimeoutConfig sessionConfig;
+    TimerWheel::TimerId sessionTimer = 0;
+    uint64_t sessionSeq = 0;              // tags the timer of the current session
+    int paymentAttempts = 0;
+    double quotedPrice = 0.0;             // shown at selection, charged at payment
+    const Recipe* heldRecipe = nullptr;   // ingredients held for the selection
+    uint64_t sessionTimeouts = 0;
+    ReceiptLog* receipts = nullptr;
+    MenuHandle orderMenu;                 // version the pending order runs on
+    uint64_t appliedMenuVersion = UINT64_MAX;
 
     // Singleton instance
     static CoffeeMachine* instance;
-    static std::mutex mutex_;
+    static ProfiledMutex mutex_;
 
     // Private constructor for Singleton
     CoffeeMachine();
 
+    void publishStatus();
+    MachinePhase machinePhase() const;
+
+    void armSessionTimer(int64_t delayMs);
+    static void onSessionTimeout(void* machine, uint64_t seq);
+
 public:
     // Delete copy constructor and assignment operator
     CoffeeMachine(const CoffeeMachine&) = delete;
     CoffeeMachine& operator=(const CoffeeMachine&) = delete;
+    ~CoffeeMachine() { attachTimers(nullptr); }
 
     // Thread-safe Singleton getInstance
     static CoffeeMachine* getInstance();
@@ -44,6 +113,13 @@ public:
     // Cleanup singleton (for proper resource management)
     static void destroyInstance();
 
+    // Contention on the getInstance lock (see ProfiledMutex)
+    static ProfiledMutex::Stats getInstanceLockStats() { return mutex_.getStats(); }
+
+    // Standalone instance outside the Singleton, for processes that host
+    // several machines (e.g. the network order server)
+    static std::unique_ptr<CoffeeMachine> create();
+
     // State Pattern - Delegate actions to current state
     void selectCoffee(int choice);
     void makePayment(std::unique_ptr<PaymentStrategy> payment);
@@ -63,11 +139,144 @@ public:
     CoffeeType getSelectedCoffeeType() const { return selectedCoffeeType; }
     void setSelectedCoffeeType(CoffeeType type) { selectedCoffeeType = type; }
 
+    // Per-order allocations; completeOrder() recycles the arena
+    OrderArena& getOrderArena() { return orderArena; }
+    void completeOrder() {
+        orderMenu.reset();
+        orderArena.completeOrder();
+    }
+
     bool getIsOperational() const { return isOperational; }
-    void setOperational(bool operational) { isOperational = operational; }
+    void setOperational(bool operational) {
+        isOperational = operational;
+        publishStatus();
+        recordEvent(MachineEventType::OPERATIONAL, operational ? 1 : 0);
+    }
+
+    // Consistent state for monitoring threads; never blocks the order path
+    MachineStatusSnapshot readStatus() const { return status.load(); }
+
+    // Event Sourcing - stream every machine and inventory change into log,
+    // starting from the current state; nullptr detaches. The log must
+    // outlive the attachment.
+    void attachEventLog(MachineEventLog* log);
+    MachineEventLog* getEventLog() const { return eventLog; }
+    void recordEvent(MachineEventType type, int arg = 0, int amount = 0, double value = 0.0) {
+        if (telemetry) telemetry->count(type, arg, value);
+        if (eventLog) eventLog->append(type, arg, amount, value);
+    }
 
-    // Observer registration helper
+    // Mirror status, levels and counters into a shared-memory slot (see
+    // TelemetrySegment.hpp); nullptr detaches
+    void attachTelemetry(MachineTelemetry* slot) {
+        telemetry = slot;
+        inventory->attachTelemetry(slot);
+        if (telemetry) publishStatus();
+    }
+
+    // Paid orders go to the queue for (possibly coalesced) brewing instead
+    // of being brewed one at a time; nullptr restores direct brewing
+    void attachBrewQueue(BrewQueue* queue) {
+        brewQueue = queue;
+        if (brewQueue) brewQueue->setEventLog(eventLog);
+    }
+    BrewQueue* getBrewQueue() const { return brewQueue; }
+
+    // Dynamic pricing (see PricingEngine.hpp) for this machine's site.
+    // Precedence: the menu version's price (or, without a menu, the Coffee
+    // classes' own) is the base, and the engine's rules apply on top of it.
+    void attachPricing(const PricingEngine* engine, uint32_t site = 0) {
+        pricing = engine;
+        pricingSite = site;
+    }
+
+    // Price of a drink right now on the given base: one table lookup
+    double priceOn(CoffeeType type, double base) const {
+        return pricing ? pricing->price(type, pricingSite, base) : base;
+    }
+
+    // Price of the selected drink on the order's pinned menu version
+    double quotePrice(const Coffee* coffee, CoffeeType type) const {
+        return priceOn(type, orderMenu ? orderMenu->item(type).price : coffee->getPrice());
+    }
+
+    // Hot-reloadable menu (see MenuConfig.hpp); nullptr restores the
+    // built-in menu. Each order runs on the version current when it was
+    // selected, even if the menu is reloaded before it is dispensed.
+    void attachMenu(const MenuRegistry* registry) { menu = registry; }
+    const MenuRegistry* getMenu() const { return menu; }
+
+    // Pin the current menu version for a new order; a version's thresholds
+    // are adopted by the inventory the first time an order uses it
+    void pinMenu() {
+        if (!menu) return;
+        orderMenu = menu->acquire();
+        if (orderMenu->version != appliedMenuVersion) {
+            inventory->applyThresholds(orderMenu->thresholds);
+            appliedMenuVersion = orderMenu->version;
+        }
+    }
+    void unpinMenu() { orderMenu.reset(); }
+    const MenuSnapshot* getOrderMenu() const { return orderMenu.get(); }
+    MenuHandle getOrderMenuHandle() const { return orderMenu; }
+
+    const Recipe& orderRecipe(CoffeeType type) const {
+        return orderMenu ? orderMenu->item(type).recipe : Inventory::getRecipe(type);
+    }
+
+    int preparationTime(const Coffee* coffee, CoffeeType type) const {
+        return orderMenu ? orderMenu->item(type).preparationTime : coffee->getPreparationTime();
+    }
+
+    // Admission control (see AdmissionController.hpp): selections projected
+    // to wait too long, or that the stock cannot cover, are deferred or
+    // rejected instead of queued; nullptr accepts everything
+    void attachAdmission(AdmissionController* controller) { admission = controller; }
+    AdmissionController* getAdmission() const { return admission; }
+    bool admitSelection(CoffeeType type);
+
+    // Session deadlines on a timer wheel driven by the machine's owner (see
+    // TimerWheel.hpp): an unpaid selection is cancelled when it times out,
+    // its ingredients are held until then, and a declined payment opens a
+    // shorter retry window. nullptr disarms; without a wheel a selection
+    // waits for payment or cancelOrder() indefinitely.
+    void attachTimers(TimerWheel* wheel, SessionTimeoutConfig config = SessionTimeoutConfig());
+    TimerWheel* getTimers() const { return timers; }
+    uint64_t getSessionTimeouts() const { return sessionTimeouts; }
+    int getPaymentAttempts() const { return paymentAttempts; } // declines this session
+    double getQuotedPrice() const { return quotedPrice; }
+
+    // Called by the states as a selection starts and ends; the price quoted
+    // at selection is the one payment charges, whatever the rules do meanwhile
+    void beginSession(CoffeeType type, double price);
+    void endSession();
+    bool retryPayment(); // false once the attempts are used up
+
+    // A receipt line for every paid order in a batched per-machine log (see
+    // ReceiptLog.hpp); nullptr detaches. The log must outlive the attachment.
+    void attachReceipts(ReceiptLog* log) { receipts = log; }
+    ReceiptLog* getReceipts() const { return receipts; }
+    void issueReceipt(const PaymentStrategy& payment, double price) {
+        if (!receipts || !selectedCoffee) return;
+        receipts->append({selectedCoffee->getName(), std::llround(price * 100.0),
+                          payment.getPaymentMethod(), payment.getMaskedReference()});
+    }
+
+    // Session state for migration. Only Idle and Selecting are ever seen
+    // between calls (paid orders are dispensed or queued synchronously).
+    MachineSessionImage exportSession() const;
+    // Resume an exported session on this machine, which must be Idle; a
+    // session pinned to a menu version needs the attached menu to be at
+    // that version. Ingredients held for the selection are not reserved
+    // again - they travel with the inventory (Inventory::restoreLevels) -
+    // and with timers attached the session deadline starts afresh.
+    bool restoreSession(const MachineSessionImage& image);
+
+    // Observer registration helper; the overload subscribes to one
+    // ingredient only (see Inventory::subscribe)
     void registerObserver(InventoryObserver* observer);
+    bool registerObserver(InventoryObserver* observer, const std::string& ingredient,
+                          InventoryEventMask events = eventMask(InventoryEvent::LOW_LEVEL));
     void removeObserver(InventoryObserver* observer);
 };
 
@@ -79,6 +288,7 @@ public:
     void dispense(CoffeeMachine* machine) override;
     void cancel(CoffeeMachine* machine) override;
     std::string getStateName() const override { return "Idle"; }
+    OrderPathPhase getPhase() const override { return OrderPathPhase::IDLE; }
 };
 
 // Concrete State - Selecting State
@@ -89,6 +299,7 @@ public:
     void dispense(CoffeeMachine* machine) override;
     void cancel(CoffeeMachine* machine) override;
     std::string getStateName() const override { return "Selecting"; }
+    OrderPathPhase getPhase() const override { return OrderPathPhase::SELECTING; }
 };
 
 // Concrete State - Processing State
@@ -99,6 +310,7 @@ public:
     void dispense(CoffeeMachine* machine) override;
     void cancel(CoffeeMachine* machine) override;
     std::string getStateName() const override { return "Processing"; }
+    OrderPathPhase getPhase() const override { return OrderPathPhase::PROCESSING; }
 };
 
 // Concrete State - Dispensing State
@@ -109,21 +321,43 @@ public:
     void dispense(CoffeeMachine* machine) override;
     void cancel(CoffeeMachine* machine) override;
     std::string getStateName() const override { return "Dispensing"; }
+    OrderPathPhase getPhase() const override { return OrderPathPhase::DISPENSING; }
 };
 
 // Static member definitions
 CoffeeMachine* CoffeeMachine::instance = nullptr;
-std::mutex CoffeeMachine::mutex_;
+ProfiledMutex CoffeeMachine::mutex_("CoffeeMachine::getInstance");
 
 // CoffeeMachine Implementation
 CoffeeMachine::CoffeeMachine()
     : inventory(std::make_unique<Inventory>()),
       currentState(std::make_unique<IdleState>()),
       isOperational(true),
-      selectedCoffeeType(CoffeeType::ESPRESSO) {}
+      selectedCoffeeType(CoffeeType::ESPRESSO) {
+    publishStatus();
+}
+
+void CoffeeMachine::publishStatus() {
+    MachineStatusSnapshot snap;
+    std::string stateName = currentState->getStateName();
+    stateName.copy(snap.stateName, sizeof(snap.stateName) - 1);
+    snap.operational = isOperational;
+    snap.selectedType = selectedCoffee ? static_cast<int>(selectedCoffeeType) : -1;
+    status.store(snap);
+    if (telemetry) telemetry->publishStatus(snap.stateName, snap.operational, snap.selectedType);
+}
+
+// Dispensing is still part of the order being processed
+MachinePhase CoffeeMachine::machinePhase() const {
+    switch (currentState->getPhase()) {
+        case OrderPathPhase::IDLE: return MachinePhase::IDLE;
+        case OrderPathPhase::SELECTING: return MachinePhase::SELECTING;
+        default: return MachinePhase::PROCESSING;
+    }
+}
 
 CoffeeMachine* CoffeeMachine::getInstance() {
-    std::lock_guard<std::mutex> lock(mutex_);
+    std::lock_guard<ProfiledMutex> lock(mutex_);
     if (instance == nullptr) {
         instance = new CoffeeMachine();
     }
@@ -131,16 +365,22 @@ CoffeeMachine* CoffeeMachine::getInstance() {
 }
 
 void CoffeeMachine::destroyInstance() {
-    std::lock_guard<std::mutex> lock(mutex_);
+    std::lock_guard<ProfiledMutex> lock(mutex_);
     delete instance;
     instance = nullptr;
 }
 
+std::unique_ptr<CoffeeMachine> CoffeeMachine::create() {
+    return std::unique_ptr<CoffeeMachine>(new CoffeeMachine());
+}
+
 void CoffeeMachine::selectCoffee(int choice) {
     if (!isOperational) {
         std::cout << "Machine is under maintenance. Please try later.\n";
         return;
     }
+    OrderArena::Scope scope(orderArena);
+    OrderPathProfile::Scope phase(currentState->getPhase());
     currentState->selectCoffee(this, choice);
 }
 
@@ -149,39 +389,223 @@ void CoffeeMachine::makePayment(std::unique_ptr<PaymentStrategy> payment) {
         std::cout << "Machine is under maintenance. Please try later.\n";
         return;
     }
+    OrderArena::Scope scope(orderArena);
+    OrderPathProfile::Scope phase(currentState->getPhase());
     currentState->insertPayment(this, std::move(payment));
 }
 
 void CoffeeMachine::cancelOrder() {
+    OrderArena::Scope scope(orderArena);
+    OrderPathProfile::Scope phase(currentState->getPhase());
     currentState->cancel(this);
 }
 
+// Shows what quotePrice() would charge now: the same base, the same rules
 void CoffeeMachine::displayMenu() {
-    CoffeeFactory::displayMenu();
+    if (!menu && !pricing) {
+        CoffeeFactory::displayMenu();
+        return;
+    }
+    MenuHandle version = menu ? menu->acquire() : MenuHandle();
+    std::cout << "\n========== COFFEE MENU ==========\n";
+    for (int i = 0; i < static_cast<int>(CoffeeType::COUNT); ++i) {
+        CoffeeType type = static_cast<CoffeeType>(i);
+        bool available = !version || version->items[i].available;
+        double base = version ? version->items[i].price : CoffeeFactory::createCoffee(type)->getPrice();
+        std::cout << (i + 1) << ". " << CoffeeFactory::getCoffeeTypeName(type)
+                  << " - $" << Dollars{priceOn(type, base)} << (available ? "" : " (unavailable)") << "\n";
+    }
+    std::cout << "==================================\n";
 }
 
 void CoffeeMachine::displayStatus() {
+    MachineStatusSnapshot snap = readStatus();
     std::cout << "\n===== MACHINE STATUS =====\n";
-    std::cout << "State: " << currentState->getStateName() << "\n";
-    std::cout << "Operational: " << (isOperational ? "Yes" : "No (Maintenance)") << "\n";
-    if (selectedCoffee) {
-        std::cout << "Selected: " << selectedCoffee->getName() << "\n";
+    std::cout << "State: " << snap.stateName << "\n";
+    std::cout << "Operational: " << (snap.operational ? "Yes" : "No (Maintenance)") << "\n";
+    if (snap.selectedType >= 0) {
+        std::cout << "Selected: "
+                  << CoffeeFactory::getCoffeeTypeName(static_cast<CoffeeType>(snap.selectedType)) << "\n";
     }
     std::cout << "==========================\n";
 }
 
 void CoffeeMachine::setState(std::unique_ptr<MachineState> state) {
     currentState = std::move(state);
+    // Inside an entry point the rest of the call is the new state's work
+    if (OrderPathProfile::current() != OrderPathPhase::OUTSIDE) OrderPathProfile::enter(currentState->getPhase());
+    publishStatus();
 }
 
 void CoffeeMachine::setSelectedCoffee(std::unique_ptr<Coffee> coffee) {
     selectedCoffee = std::move(coffee);
+    publishStatus();
+}
+
+void CoffeeMachine::attachEventLog(MachineEventLog* log) {
+    eventLog = log;
+    inventory->attachEventLog(log);
+    if (brewQueue) brewQueue->setEventLog(log);
+    if (!log) return;
+
+    MachineImage initial;
+    initial.phase = machinePhase();
+    initial.operational = isOperational;
+    initial.selectedType = selectedCoffee ? static_cast<int>(selectedCoffeeType) : -1;
+    InventorySnapshot levels = inventory->readSnapshot();
+    initial.ingredientCount = std::min<uint32_t>(levels.count, MachineImage::MAX_INGREDIENTS);
+    std::copy(levels.levels, levels.levels + initial.ingredientCount, initial.levels);
+    log->reset(initial, inventory->getIngredientNames());
+}
+
+bool CoffeeMachine::admitSelection(CoffeeType type) {
+    if (!admission) return true;
+    auto coffee = CoffeeFactory::createCoffee(type);
+    AdmissionDecision decision = admission->evaluate(*inventory, brewQueue, orderRecipe(type),
+                                                     preparationTime(coffee.get(), type));
+    switch (decision.reason) {
+        case ShedReason::NONE:
+            return true;
+        case ShedReason::STOCK:
+            std::cout << "Sorry, " << coffee->getName()
+                      << " is currently unavailable due to low ingredients.\n";
+            break;
+        case ShedReason::QUEUE_DEPTH:
+            std::cout << "Sorry, the machine is at capacity (" << decision.queueDepth
+                      << " orders ahead). Please try again shortly.\n";
+            break;
+        case ShedReason::WAIT:
+            if (decision.verdict == AdmissionVerdict::DEFER) {
+                std::cout << "The machine is busy. Please order again in about "
+                          << (decision.retryAfterMs + 999) / 1000 << " seconds.\n";
+            } else {
+                std::cout << "Sorry, the wait is too long right now (about "
+                          << decision.estimatedWaitMs / 60000 << " minutes). Please try later.\n";
+            }
+            break;
+    }
+    return false;
+}
+
+void CoffeeMachine::attachTimers(TimerWheel* wheel, SessionTimeoutConfig config) {
+    if (timers && sessionTimer) timers->cancel(sessionTimer);
+    sessionTimer = 0;
+    timers = wheel;
+    sessionConfig = config;
+    if (timers && selectedCoffee) armSessionTimer(sessionConfig.selectionTimeoutMs);
+}
+
+void CoffeeMachine::armSessionTimer(int64_t delayMs) {
+    if (sessionTimer) timers->cancel(sessionTimer);
+    sessionTimer = timers->scheduleAfter(delayMs, &CoffeeMachine::onSessionTimeout, this, sessionSeq);
+}
+
+void CoffeeMachine::onSessionTimeout(void* context, uint64_t seq) {
+    CoffeeMachine* machine = static_cast<CoffeeMachine*>(context);
+    if (seq != machine->sessionSeq) return; // session already over
+    machine->sessionTimer = 0;
+    if (!machine->selectedCoffee || machine->currentState->getPhase() != OrderPathPhase::SELECTING) return;
+    std::cout << "Selection timed out.\n";
+    machine->sessionTimeouts++;
+    machine->cancelOrder();
+}
+
+void CoffeeMachine::beginSession(CoffeeType type, double price) {
+    sessionSeq++;
+    paymentAttempts = 0;
+    quotedPrice = price;
+    if (!timers) return;
+    if (sessionConfig.holdIngredients) {
+        heldRecipe = &orderRecipe(type);
+        inventory->reserveIngredients(*heldRecipe);
+    }
+    armSessionTimer(sessionConfig.selectionTimeoutMs);
+}
+
+void CoffeeMachine::endSession() {
+    sessionSeq++;
+    if (heldRecipe) {
+        inventory->releaseReservation(*heldRecipe);
+        heldRecipe = nullptr;
+    }
+    if (sessionTimer) {
+        timers->cancel(sessionTimer);
+        sessionTimer = 0;
+    }
+}
+
+bool CoffeeMachine::retryPayment() {
+    if (!timers) return true;
+    paymentAttempts++;
+    if (sessionConfig.maxPaymentAttempts > 0 && paymentAttempts >= sessionConfig.maxPaymentAttempts) {
+        return false;
+    }
+    armSessionTimer(sessionConfig.paymentRetryMs);
+    return true;
+}
+
+MachineSessionImage CoffeeMachine::exportSession() const {
+    MachineSessionImage image;
+    image.phase = machinePhase();
+    image.operational = isOperational;
+    image.selectedType = selectedCoffee ? static_cast<int>(selectedCoffeeType) : -1;
+    image.holdingIngredients = heldRecipe != nullptr;
+    image.paymentAttempts = paymentAttempts;
+    image.quotedPrice = quotedPrice;
+    image.sessionTimeouts = sessionTimeouts;
+    image.onMenu = static_cast<bool>(orderMenu);
+    image.menuVersion = orderMenu ? orderMenu->version : 0;
+    image.appliedMenuVersion = appliedMenuVersion;
+    return image;
+}
+
+bool CoffeeMachine::restoreSession(const MachineSessionImage& image) {
+    if (selectedCoffee || currentState->getPhase() != OrderPathPhase::IDLE) return false;
+    if (image.phase == MachinePhase::PROCESSING) return false;
+    bool selecting = image.phase == MachinePhase::SELECTING;
+    if (selecting && (image.selectedType < 0 || image.selectedType >= static_cast<int>(CoffeeType::COUNT))) {
+        return false;
+    }
+    MenuHandle version;
+    if (selecting && image.onMenu) {
+        if (!menu) return false;
+        version = menu->acquire();
+        if (version->version != image.menuVersion) return false;
+    }
+
+    isOperational = image.operational;
+    sessionTimeouts = image.sessionTimeouts;
+    appliedMenuVersion = image.appliedMenuVersion;
+    if (!selecting) {
+        publishStatus();
+        return true;
+    }
+
+    OrderArena::Scope scope(orderArena);
+    CoffeeType type = static_cast<CoffeeType>(image.selectedType);
+    orderMenu = std::move(version);
+    selectedCoffeeType = type;
+    selectedCoffee = CoffeeFactory::createCoffee(type);
+    sessionSeq++;
+    paymentAttempts = image.paymentAttempts;
+    quotedPrice = image.quotedPrice;
+    if (image.holdingIngredients) heldRecipe = &orderRecipe(type);
+    setState(std::make_unique<SelectingState>());
+    if (timers) {
+        armSessionTimer(paymentAttempts > 0 ? sessionConfig.paymentRetryMs : sessionConfig.selectionTimeoutMs);
+    }
+    return true;
 }
 
 void CoffeeMachine::registerObserver(InventoryObserver* observer) {
     inventory->addObserver(observer);
 }
 
+bool CoffeeMachine::registerObserver(InventoryObserver* observer, const std::string& ingredient,
+                                     InventoryEventMask events) {
+    return inventory->subscribe(observer, ingredient, events);
+}
+
 void CoffeeMachine::removeObserver(InventoryObserver* observer) {
     inventory->removeObserver(observer);
 }
@@ -191,17 +615,34 @@ void CoffeeMachine::removeObserver(InventoryObserver* observer) {
 void IdleState::selectCoffee(CoffeeMachine* machine, int choice) {
     try {
         CoffeeType type = static_cast<CoffeeType>(choice - 1);
-        if (machine->getInventory()->checkAvailability(type)) {
+        if (choice >= 1 && choice <= static_cast<int>(CoffeeType::COUNT)) {
+            machine->pinMenu();
+        }
+        const MenuSnapshot* version = machine->getOrderMenu();
+        if (version && !version->item(type).available) {
+            std::cout << "Sorry, " << CoffeeFactory::getCoffeeTypeName(type)
+                      << " is not on the menu right now.\n";
+            machine->unpinMenu();
+            return;
+        }
+        if (choice >= 1 && choice <= static_cast<int>(CoffeeType::COUNT) && !machine->admitSelection(type)) {
+            machine->unpinMenu();
+            return;
+        }
+        if (machine->getInventory()->checkAvailability(machine->orderRecipe(type))) {
             auto coffee = CoffeeFactory::createCoffee(type);
+            double price = machine->quotePrice(coffee.get(), type);
             std::cout << "Selected: " << coffee->getName() << "\n";
-            std::cout << std::fixed << std::setprecision(2);
-            std::cout << "Price: $" << coffee->getPrice() << "\n";
+            std::cout << "Price: $" << Dollars{price} << "\n";
             machine->setSelectedCoffeeType(type);
             machine->setSelectedCoffee(std::move(coffee));
             machine->setState(std::make_unique<SelectingState>());
+            machine->recordEvent(MachineEventType::SELECT, static_cast<int>(type));
+            machine->beginSession(type, price);
         } else {
             std::cout << "Sorry, " << CoffeeFactory::getCoffeeTypeName(type)
                       << " is currently unavailable due to low ingredients.\n";
+            machine->unpinMenu();
         }
     } catch (...) {
         std::cout << "Invalid selection. Please try again.\n";
@@ -226,12 +667,21 @@ void SelectingState::selectCoffee(CoffeeMachine* machine, int choice) {
 }
 
 void SelectingState::insertPayment(CoffeeMachine* machine, std::unique_ptr<PaymentStrategy> payment) {
-    Coffee* coffee = machine->getSelectedCoffee();
-    if (payment->pay(coffee->getPrice())) {
+    double price = machine->getQuotedPrice();
+    if (payment->pay(price)) {
+        machine->recordEvent(MachineEventType::PAYMENT, 1, 0, price);
+        machine->issueReceipt(*payment, price);
+        machine->endSession();
         machine->setState(std::make_unique<ProcessingState>());
         machine->getCurrentState()->dispense(machine);
     } else {
-        std::cout << "Payment failed. Please try again or cancel.\n";
+        machine->recordEvent(MachineEventType::PAYMENT, 0, 0, price);
+        if (machine->retryPayment()) {
+            std::cout << "Payment failed. Please try again or cancel.\n";
+        } else {
+            std::cout << "Payment failed too many times.\n";
+            cancel(machine);
+        }
     }
 }
 
@@ -241,7 +691,10 @@ void SelectingState::dispense(CoffeeMachine* machine) {
 
 void SelectingState::cancel(CoffeeMachine* machine) {
     std::cout << "Order cancelled.\n";
+    machine->endSession();
+    machine->recordEvent(MachineEventType::CANCEL);
     machine->setSelectedCoffee(nullptr);
+    machine->completeOrder();
     machine->setState(std::make_unique<IdleState>());
 }
 
@@ -256,13 +709,26 @@ void ProcessingState::insertPayment(CoffeeMachine* machine, std::unique_ptr<Paym
 
 void ProcessingState::dispense(CoffeeMachine* machine) {
     Coffee* coffee = machine->getSelectedCoffee();
+
+    if (BrewQueue* queue = machine->getBrewQueue()) {
+        uint64_t orderId = queue->enqueue(machine->getSelectedCoffeeType(), machine->getOrderMenuHandle());
+        std::cout << "Order #" << orderId << " (" << coffee->getName()
+                  << ") queued for brewing.\n";
+        machine->recordEvent(MachineEventType::QUEUE, static_cast<int>(machine->getSelectedCoffeeType()));
+        machine->setSelectedCoffee(nullptr);
+        machine->completeOrder();
+        machine->setState(std::make_unique<IdleState>());
+        return;
+    }
+
     std::cout << "\nProcessing your order...\n";
     coffee->prepare();
 
-    std::cout << "Please wait " << coffee->getPreparationTime() << " seconds...\n";
+    std::cout << "Please wait " << machine->preparationTime(coffee, machine->getSelectedCoffeeType())
+              << " seconds...\n";
 
-    // Consume ingredients from inventory
-    machine->getInventory()->consumeIngredients(machine->getSelectedCoffeeType());
+    // Consume ingredients from inventory, per the order's menu version
+    machine->getInventory()->consumeIngredients(machine->orderRecipe(machine->getSelectedCoffeeType()));
 
     machine->setState(std::make_unique<DispensingState>());
     machine->getCurrentState()->dispense(machine);
@@ -287,8 +753,10 @@ void DispensingState::dispense(CoffeeMachine* machine) {
     std::cout << "Please collect your coffee from the dispenser.\n";
     std::cout << "Thank you for your purchase!\n\n";
 
-    // Reset machine state
+    // Reset machine state; the next order starts on a fresh arena
+    machine->recordEvent(MachineEventType::DISPENSE);
     machine->setSelectedCoffee(nullptr);
+    machine->completeOrder();
     machine->setState(std::make_unique<IdleState>());
 }
 
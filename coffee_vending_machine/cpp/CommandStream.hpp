@@ -0,0 +1,145 @@
+#ifndef COMMAND_STREAM_HPP
+#define COMMAND_STREAM_HPP
+
+#include "OrderProtocol.hpp"
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdio>
+#include <chrono>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Headless driver - feeds a stream of protocol commands (see OrderProtocol.hpp)
+// from a file or pipe into a CoffeeMachine and writes one compact result line
+// per command. Input is read in large blocks and parsed in place; results are
+// batched and written with a single write() per block.
+class CommandStreamRunner {
+public:
+    struct Summary {
+        uint64_t commands = 0;
+        uint64_t ok = 0;
+        uint64_t errors = 0;
+        double seconds = 0.0;
+    };
+
+private:
+    static constexpr size_t READ_BLOCK = 1 << 20;
+    static constexpr size_t FLUSH_THRESHOLD = 1 << 16;
+
+    MachineLease lease;
+    OrderSession session;
+    int outputFd;
+    std::string out;
+    Summary summary;
+
+    bool writeAll(const char* data, size_t size) {
+        while (size > 0) {
+            ssize_t n = ::write(outputFd, data, size);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                std::perror("write");
+                return false;
+            }
+            data += n;
+            size -= static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+    bool flushOutput() {
+        bool ok = outputFd < 0 || writeAll(out.data(), out.size());
+        out.clear();
+        return ok;
+    }
+
+    void executeLine(std::string_view line) {
+        if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+        if (line.empty() || line.front() == '#') return;
+
+        size_t before = out.size();
+        session.execute(OrderProtocol::parse(line), out);
+        summary.commands++;
+        if (out.compare(before, 2, "OK") == 0) {
+            summary.ok++;
+        } else {
+            summary.errors++;
+        }
+    }
+
+public:
+    // outputFd < 0 discards per-command results and keeps only the summary
+    CommandStreamRunner(CoffeeMachine* machine, int resultFd)
+        : session(1, &lease), outputFd(resultFd) {
+        lease.machine = machine;
+        out.reserve(FLUSH_THRESHOLD * 2);
+    }
+
+    // Run every command from inputFd until EOF. Returns false on I/O error.
+    bool run(int inputFd) {
+        auto start = std::chrono::steady_clock::now();
+        std::vector<char> buffer(READ_BLOCK);
+        size_t filled = 0;
+        bool ok = true;
+
+        while (ok) {
+            if (filled == buffer.size()) {
+                buffer.resize(buffer.size() * 2); // a single huge line
+            }
+            ssize_t n = ::read(inputFd, buffer.data() + filled, buffer.size() - filled);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                std::perror("read");
+                ok = false;
+                break;
+            }
+            if (n == 0) break;
+            filled += static_cast<size_t>(n);
+
+            std::string_view data(buffer.data(), filled);
+            size_t pos = 0;
+            while (true) {
+                size_t nl = data.find('\n', pos);
+                if (nl == std::string_view::npos) break;
+                executeLine(data.substr(pos, nl - pos));
+                pos = nl + 1;
+                if (out.size() >= FLUSH_THRESHOLD) {
+                    ok = flushOutput();
+                    if (!ok) break;
+                }
+            }
+            // Keep the partial trailing line for the next read
+            std::copy(buffer.begin() + static_cast<std::ptrdiff_t>(pos),
+                      buffer.begin() + static_cast<std::ptrdiff_t>(filled), buffer.begin());
+            filled -= pos;
+        }
+
+        if (ok && filled > 0) {
+            executeLine(std::string_view(buffer.data(), filled));
+        }
+        ok = flushOutput() && ok;
+        session.close();
+
+        summary.seconds = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start).count();
+        return ok;
+    }
+
+    // Convenience overload: "-" reads standard input
+    bool run(const std::string& path) {
+        if (path == "-") return run(STDIN_FILENO);
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            std::perror(path.c_str());
+            return false;
+        }
+        bool ok = run(fd);
+        ::close(fd);
+        return ok;
+    }
+
+    const Summary& getSummary() const { return summary; }
+};
+
+#endif // COMMAND_STREAM_HPP
@@ -0,0 +1,36 @@
+#ifndef CONSOLE_GUARD_HPP
+#define CONSOLE_GUARD_HPP
+
+#include <iostream>
+
+// RAII helper that silences std::cout while it is alive.
+// The machine core reports everything through std::cout; headless front ends
+// (network server, command streams, benchmarks) mute it so the per-order cost
+// is the order logic, not terminal output. Detaching the stream buffer puts
+// std::cout in a failed state, so every << short-circuits before formatting.
+class ConsoleGuard {
+private:
+    std::streambuf* saved;
+    bool active;
+
+public:
+    explicit ConsoleGuard(bool mute = true)
+        : saved(nullptr), active(mute) {
+        if (active) {
+            std::cout.flush();
+            saved = std::cout.rdbuf(nullptr);
+        }
+    }
+
+    ~ConsoleGuard() {
+        if (active) {
+            std::cout.rdbuf(saved);
+            std::cout.clear();
+        }
+    }
+
+    ConsoleGuard(const ConsoleGuard&) = delete;
+    ConsoleGuard& operator=(const ConsoleGuard&) = delete;
+};
+
+#endif // CONSOLE_GUARD_HPP
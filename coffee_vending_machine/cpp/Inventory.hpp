@@ -3,10 +3,32 @@
 
 #include "Observer.hpp"
 #include "CoffeeFactory.hpp"
+#include "Seqlock.hpp"
+#include <cstddef>
 #include <map>
 #include <string>
+#include <unordered_map>
 #include <iostream>
 #include <iomanip>
+#include <type_traits>
+#include <vector>
+
+// Optional sinks; only files that attach one need its header
+class InventoryHistory;
+class MachineEventLog;
+class MachineTelemetry;
+
+// Point-in-time copy of ingredient levels for monitoring readers.
+// Entries follow the order of Inventory::getIngredientNames().
+struct InventorySnapshot {
+    static constexpr size_t MAX_INGREDIENTS = 8;
+    uint32_t count = 0;
+    int levels[MAX_INGREDIENTS] = {};
+    int thresholds[MAX_INGREDIENTS] = {};
+};
+
+// Ingredient -> amount for one drink (every drink also takes one cup)
+using Recipe = std::map<std::string, int>;
 
 // Inventory - Implements Observer Pattern (Subject)
 // Demonstrates Encapsulation (OOP)
@@ -14,10 +36,48 @@ class Inventory : public InventorySubject {
 private:
     std::map<std::string, int> ingredients;
     std::map<std::string, int> thresholds;
-    std::vector<InventoryObserver*> observers;
+
+    // Observer Pattern - subscriber index: one list per ingredient (in
+    // getIngredientNames() order) plus a last list for observers of every
+    // ingredient, so a notification only walks interested observers. Each
+    // observer's entries are tracked by position, so removing it touches
+    // only its own lists (swap with the last entry, no scan).
+    struct Subscriber {
+        InventoryObserver* observer;
+        InventoryEventMask events;
+    };
+    struct Subscription {
+        uint32_t list;
+        uint32_t position;
+    };
+    std::vector<std::vector<Subscriber>> subscribers;
+    std::unordered_map<InventoryObserver*, std::vector<Subscription>> subscriptions;
+    int notifying = 0;                 // notify() depth; callbacks may re-enter
+    bool tombstones = false;           // removals deferred until notify() ends
+
+    // Held for paid orders waiting in a BrewQueue; availability checks
+    // subtract these so queued orders can never oversell
+    std::map<std::string, int> reserved;
+    int reservedCups = 0;
+
+    // Published after every change so readers never touch the live maps
+    std::vector<std::string> ingredientNames;
+    Seqlock<InventorySnapshot> snapshot;
+
+    // Optional level history; every change is recorded when attached
+    InventoryHistory* history = nullptr;
+    void (*recordLevel)(InventoryHistory*, const std::string&, int) = nullptr;
+
+    // Optional event stream (see MachineEventLog); set by the owning machine
+    MachineEventLog* eventLog = nullptr;
+    void (*logChange)(MachineEventLog*, bool refill, int index, int amount) = nullptr;
+
+    // Optional shared-memory slot mirroring the snapshot
+    MachineTelemetry* telemetry = nullptr;
+    void (*publishLevels)(MachineTelemetry*, const InventorySnapshot&) = nullptr;
 
     // Recipe definitions
-    static std::map<CoffeeType, std::map<std::string, int>> RECIPES;
+    static std::map<CoffeeType, Recipe> RECIPES;
 
     static void initializeRecipes() {
         static bool initialized = false;
@@ -55,39 +115,176 @@ private:
         ingredients["Cups"] = 50;
 
         // Set low-level thresholds
-        thresholds["Coffee Beans"] = 100;
-        thresholds["Water"] = 500;
-        thresholds["Milk"] = 200;
-        thresholds["Chocolate"] = 50;
-        thresholds["Cups"] = 10;
+        thresholds = getDefaultThresholds();
+
+        for (const auto& entry : ingredients) {
+            ingredientNames.push_back(entry.first);
+        }
+        subscribers.resize(ingredientNames.size() + 1);
+    }
+
+    int reservedAmount(const std::string& ingredient) const {
+        if (reservedCups == 0) return 0;
+        auto it = reserved.find(ingredient);
+        return it != reserved.end() ? it->second : 0;
+    }
+
+    int indexOf(const std::string& ingredient) const {
+        auto it = std::lower_bound(ingredientNames.begin(), ingredientNames.end(), ingredient);
+        return static_cast<int>(it - ingredientNames.begin());
+    }
+
+    uint32_t everyIngredientList() const {
+        return static_cast<uint32_t>(ingredientNames.size());
+    }
+
+    // List of an ingredient, or everyIngredientList() if unknown
+    uint32_t listOf(const std::string& ingredient) const {
+        int index = indexOf(ingredient);
+        bool known = index < static_cast<int>(ingredientNames.size()) && ingredientNames[index] == ingredient;
+        return known ? static_cast<uint32_t>(index) : everyIngredientList();
+    }
+
+    Subscriber* findSubscriber(InventoryObserver* observer, uint32_t list) {
+        auto it = subscriptions.find(observer);
+        if (it == subscriptions.end()) return nullptr;
+        for (const Subscription& entry : it->second) {
+            if (entry.list == list) return &subscribers[list][entry.position];
+        }
+        return nullptr;
+    }
+
+    void addSubscriber(InventoryObserver* observer, uint32_t list, InventoryEventMask events) {
+        subscriptions[observer].push_back({list, static_cast<uint32_t>(subscribers[list].size())});
+        subscribers[list].push_back({observer, events});
+    }
+
+    // Swap the last subscriber into the hole and fix up its position. While
+    // a notification is walking the lists nothing may move (a moved
+    // subscriber could be skipped), so the slot is only blanked and
+    // compactLists() closes it afterwards.
+    void removeSubscriber(uint32_t list, uint32_t position) {
+        std::vector<Subscriber>& members = subscribers[list];
+        if (notifying > 0) {
+            members[position] = {nullptr, 0};
+            tombstones = true;
+            return;
+        }
+        if (position + 1 != members.size()) {
+            members[position] = members.back();
+            for (Subscription& entry : subscriptions[members[position].observer]) {
+                if (entry.list == list) {
+                    entry.position = position;
+                    break;
+                }
+            }
+        }
+        members.pop_back();
+    }
+
+    // Drop blanked slots, keeping delivery order, and renumber the rest
+    void compactLists() {
+        tombstones = false;
+        for (uint32_t list = 0; list < subscribers.size(); ++list) {
+            std::vector<Subscriber>& members = subscribers[list];
+            auto end = std::remove_if(members.begin(), members.end(),
+                                      [](const Subscriber& s) { return s.observer == nullptr; });
+            if (end == members.end()) continue;
+            members.erase(end, members.end());
+            for (uint32_t position = 0; position < members.size(); ++position) {
+                for (Subscription& entry : subscriptions[members[position].observer]) {
+                    if (entry.list == list) {
+                        entry.position = position;
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    void notify(InventoryEvent event, const std::string& ingredient, int currentLevel, int value) {
+        InventoryEventMask bit = eventMask(event);
+        uint32_t own = listOf(ingredient);
+        notifying++;
+        for (uint32_t list : {own, everyIngredientList()}) {
+            // Indexed: an observer may subscribe or unsubscribe (itself or
+            // another) from inside its callback
+            for (size_t i = 0; i < subscribers[list].size(); ++i) {
+                Subscriber subscriber = subscribers[list][i];
+                if (!(subscriber.events & bit)) continue;
+                if (event == InventoryEvent::LOW_LEVEL) subscriber.observer->update(ingredient, currentLevel, value);
+                else subscriber.observer->refilled(ingredient, currentLevel, value);
+            }
+            if (own == everyIngredientList()) break;
+        }
+        if (--notifying == 0 && tombstones) compactLists();
+    }
+
+    void publishSnapshot() {
+        InventorySnapshot snap;
+        for (const auto& [ingredient, quantity] : ingredients) {
+            if (snap.count == InventorySnapshot::MAX_INGREDIENTS) break;
+            snap.levels[snap.count] = quantity;
+            snap.thresholds[snap.count] = thresholds[ingredient];
+            snap.count++;
+        }
+        snapshot.store(snap);
+        if (telemetry) publishLevels(telemetry, snap);
     }
 
 public:
     Inventory() {
         initializeRecipes();
         initializeInventory();
+        publishSnapshot();
     }
 
     bool checkAvailability(CoffeeType coffeeType) {
         auto recipeIt = RECIPES.find(coffeeType);
         if (recipeIt == RECIPES.end()) return false;
+        return checkAvailability(recipeIt->second);
+    }
 
-        for (const auto& [ingredient, required] : recipeIt->second) {
+    // Availability for an explicit recipe (e.g. from a MenuSnapshot)
+    bool checkAvailability(const Recipe& recipe) {
+        if (recipe.empty()) return false;
+        for (const auto& [ingredient, required] : recipe) {
             auto it = ingredients.find(ingredient);
-            if (it == ingredients.end() || it->second < required) {
+            if (it == ingredients.end() || it->second - reservedAmount(ingredient) < required) {
                 return false;
             }
         }
-        return ingredients["Cups"] > 0;
+        return ingredients["Cups"] - reservedCups > 0;
+    }
+
+    // Projected stock: how many more cups of this recipe the inventory can
+    // cover once every queued order's reservation has been honoured
+    int availableCups(const Recipe& recipe) const {
+        if (recipe.empty()) return 0;
+        auto cups = ingredients.find("Cups");
+        int available = cups != ingredients.end() ? cups->second - reservedCups : 0;
+        for (const auto& [ingredient, required] : recipe) {
+            if (required <= 0) continue;
+            auto it = ingredients.find(ingredient);
+            int left = it != ingredients.end() ? it->second - reservedAmount(ingredient) : 0;
+            available = std::min(available, left / required);
+        }
+        return std::max(available, 0);
     }
 
-    void consumeIngredients(CoffeeType coffeeType) {
+    // Consume for `cups` drinks at once (one multi-cup brew cycle)
+    void consumeIngredients(CoffeeType coffeeType, int cups = 1) {
         auto recipeIt = RECIPES.find(coffeeType);
         if (recipeIt == RECIPES.end()) return;
+        consumeIngredients(recipeIt->second, cups);
+    }
 
-        for (const auto& [ingredient, required] : recipeIt->second) {
-            ingredients[ingredient] -= required;
+    void consumeIngredients(const Recipe& recipe, int cups = 1) {
+        for (const auto& [ingredient, required] : recipe) {
+            ingredients[ingredient] -= required * cups;
             int current = ingredients[ingredient];
+            if (history) recordLevel(history, ingredient, current);
+            if (eventLog) logChange(eventLog, false, indexOf(ingredient), required * cups);
 
             // Check if below threshold and notify observers
             if (current <= thresholds[ingredient]) {
@@ -95,61 +292,279 @@ public:
             }
         }
 
-        // Consume a cup
-        ingredients["Cups"]--;
+        // Consume the cups
+        ingredients["Cups"] -= cups;
+        if (history) recordLevel(history, "Cups", ingredients["Cups"]);
+        if (eventLog) logChange(eventLog, false, indexOf("Cups"), cups);
+        publishSnapshot();
         if (ingredients["Cups"] <= thresholds["Cups"]) {
             notifyObservers("Cups", ingredients["Cups"], thresholds["Cups"]);
         }
     }
 
+    // Hold ingredients for a paid order that will be brewed later
+    void reserveIngredients(const Recipe& recipe, int cups = 1) {
+        for (const auto& [ingredient, required] : recipe) {
+            reserved[ingredient] += required * cups;
+        }
+        reservedCups += cups;
+    }
+
+    void releaseReservation(const Recipe& recipe, int cups = 1) {
+        for (const auto& [ingredient, required] : recipe) {
+            reserved[ingredient] -= required * cups;
+        }
+        reservedCups -= cups;
+    }
+
+    void reserveIngredients(CoffeeType coffeeType, int cups = 1) {
+        reserveIngredients(getRecipe(coffeeType), cups);
+    }
+
+    void releaseReservation(CoffeeType coffeeType, int cups = 1) {
+        releaseReservation(getRecipe(coffeeType), cups);
+    }
+
+    // Adopt new low-level thresholds (menu reload); unknown names are ignored
+    void applyThresholds(const std::map<std::string, int>& updated) {
+        bool changed = false;
+        for (const auto& [ingredient, threshold] : updated) {
+            auto it = thresholds.find(ingredient);
+            if (it != thresholds.end() && it->second != threshold) {
+                it->second = threshold;
+                changed = true;
+            }
+        }
+        if (changed) publishSnapshot();
+    }
+
+    int getReservedCups() const {
+        return reservedCups;
+    }
+
+    const std::map<std::string, int>& getReservations() const {
+        return reserved;
+    }
+
+    // Take over levels, thresholds and reservations carried from another
+    // process (see MachineMigration.hpp); unknown names are ignored
+    void restoreLevels(const std::map<std::string, int>& levels, const std::map<std::string, int>& thresholdLevels,
+                       const std::map<std::string, int>& reservations, int cups) {
+        for (const auto& [ingredient, quantity] : levels) {
+            auto it = ingredients.find(ingredient);
+            if (it == ingredients.end()) continue;
+            it->second = quantity;
+            if (history) recordLevel(history, ingredient, quantity);
+        }
+        for (const auto& [ingredient, threshold] : thresholdLevels) {
+            auto it = thresholds.find(ingredient);
+            if (it != thresholds.end()) it->second = threshold;
+        }
+        reserved.clear();
+        for (const auto& [ingredient, amount] : reservations) {
+            if (amount != 0 && ingredients.count(ingredient)) reserved[ingredient] = amount;
+        }
+        reservedCups = cups;
+        publishSnapshot();
+    }
+
     void refillIngredient(const std::string& ingredient, int amount) {
         auto it = ingredients.find(ingredient);
         if (it != ingredients.end()) {
             int current = it->second;
             it->second += amount;
+            if (history) recordLevel(history, ingredient, it->second);
+            if (eventLog) logChange(eventLog, true, indexOf(ingredient), amount);
+            publishSnapshot();
             std::cout << "Refilled " << ingredient << ": " << current
                       << " + " << amount << " = " << it->second << "\n";
+            notify(InventoryEvent::REFILLED, ingredient, it->second, amount);
         } else {
             std::cout << "Unknown ingredient: " << ingredient << "\n";
         }
     }
 
+    // Safe from any thread: prints a consistent snapshot, never the live maps
     void displayInventory() const {
+        InventorySnapshot snap = readSnapshot();
         std::cout << "\n========== INVENTORY STATUS ==========\n";
-        for (const auto& [ingredient, quantity] : ingredients) {
-            auto threshIt = thresholds.find(ingredient);
-            std::string status = (threshIt != thresholds.end() &&
-                                  quantity <= threshIt->second) ? " [LOW]" : "";
-            std::cout << std::left << std::setw(15) << ingredient
-                      << ": " << quantity << status << "\n";
+        for (uint32_t i = 0; i < snap.count; ++i) {
+            std::string status = snap.levels[i] <= snap.thresholds[i] ? " [LOW]" : "";
+            std::cout << std::left << std::setw(15) << ingredientNames[i]
+                      << ": " << snap.levels[i] << status << "\n";
         }
         std::cout << "=======================================\n";
     }
 
-    // Observer Pattern methods
+    // Wait-free for the order path, lock-free for readers (see Seqlock)
+    InventorySnapshot readSnapshot() const {
+        return snapshot.load();
+    }
+
+    uint64_t getSnapshotVersion() const {
+        return snapshot.version();
+    }
+
+    const std::vector<std::string>& getIngredientNames() const {
+        return ingredientNames;
+    }
+
+    // Starts recording into history, seeded with the current levels;
+    // nullptr stops recording. The history must outlive the attachment.
+    // The attach calls are templates so the sink's members are only looked
+    // up where it is attached, which is where its header is included.
+    template <typename History>
+    void attachHistory(History* target) {
+        static_assert(std::is_same<History, InventoryHistory>::value, "attachHistory takes an InventoryHistory");
+        history = target;
+        recordLevel = [](InventoryHistory* sink, const std::string& ingredient, int level) {
+            static_cast<History*>(sink)->record(ingredient, level);
+        };
+        if (!history) return;
+        for (const auto& [ingredient, quantity] : ingredients) {
+            recordLevel(history, ingredient, quantity);
+        }
+    }
+
+    void attachHistory(std::nullptr_t) {
+        history = nullptr;
+    }
+
+    InventoryHistory* getHistory() const {
+        return history;
+    }
+
+    // Levels in the event stream follow getIngredientNames() order
+    template <typename EventLog>
+    void attachEventLog(EventLog* log) {
+        static_assert(std::is_same<EventLog, MachineEventLog>::value, "attachEventLog takes a MachineEventLog");
+        eventLog = log;
+        logChange = [](MachineEventLog* sink, bool refill, int index, int amount) {
+            static_cast<EventLog*>(sink)->appendLevelChange(refill, index, amount);
+        };
+    }
+
+    void attachEventLog(std::nullptr_t) {
+        eventLog = nullptr;
+    }
+
+    template <typename Telemetry>
+    void attachTelemetry(Telemetry* slot) {
+        static_assert(std::is_same<Telemetry, MachineTelemetry>::value, "attachTelemetry takes a MachineTelemetry");
+        telemetry = slot;
+        publishLevels = [](MachineTelemetry* sink, const InventorySnapshot& snap) {
+            static_cast<Telemetry*>(sink)->publishLevels(snap.levels, snap.thresholds, snap.count);
+        };
+        if (telemetry) publishSnapshot();
+    }
+
+    void attachTelemetry(std::nullptr_t) {
+        telemetry = nullptr;
+    }
+
+    // Observer Pattern methods; addObserver() subscribes to low-level
+    // alerts for every ingredient
     void addObserver(InventoryObserver* observer) override {
-        observers.push_back(observer);
+        subscribeAll(observer, eventMask(InventoryEvent::LOW_LEVEL));
+    }
+
+    // Events for every ingredient. Bits already covered here are dropped
+    // from the observer's per-ingredient subscriptions, so nothing is
+    // delivered twice.
+    void subscribeAll(InventoryObserver* observer, InventoryEventMask events) {
+        uint32_t all = everyIngredientList();
+        if (Subscriber* existing = findSubscriber(observer, all)) {
+            existing->events |= events;
+            events = existing->events;
+        } else {
+            addSubscriber(observer, all, events);
+        }
+        std::vector<Subscription>& entries = subscriptions[observer];
+        for (size_t i = entries.size(); i-- > 0;) {
+            Subscription entry = entries[i];
+            if (entry.list == all) continue;
+            InventoryEventMask& own = subscribers[entry.list][entry.position].events;
+            own &= static_cast<InventoryEventMask>(~events);
+            if (own == 0) {
+                removeSubscriber(entry.list, entry.position);
+                entries.erase(entries.begin() + static_cast<std::ptrdiff_t>(i));
+            }
+        }
+    }
+
+    // Events for one ingredient; false for an unknown ingredient
+    bool subscribe(InventoryObserver* observer, const std::string& ingredient,
+                   InventoryEventMask events = eventMask(InventoryEvent::LOW_LEVEL)) {
+        uint32_t list = listOf(ingredient);
+        if (list == everyIngredientList()) return false;
+        if (const Subscriber* all = findSubscriber(observer, everyIngredientList())) {
+            events &= static_cast<InventoryEventMask>(~all->events);
+        }
+        if (events == 0) return true;
+        if (Subscriber* existing = findSubscriber(observer, list)) existing->events |= events;
+        else addSubscriber(observer, list, events);
+        return true;
     }
 
+    // Drop every subscription of the observer
     void removeObserver(InventoryObserver* observer) override {
-        observers.erase(
-            std::remove(observers.begin(), observers.end(), observer),
-            observers.end()
-        );
+        auto it = subscriptions.find(observer);
+        if (it == subscriptions.end()) return;
+        std::vector<Subscription> entries = std::move(it->second);
+        subscriptions.erase(it);
+        for (const Subscription& entry : entries) removeSubscriber(entry.list, entry.position);
     }
 
     void notifyObservers(const std::string& ingredient, int currentLevel, int threshold) override {
-        for (auto* observer : observers) {
-            observer->update(ingredient, currentLevel, threshold);
+        notify(InventoryEvent::LOW_LEVEL, ingredient, currentLevel, threshold);
+    }
+
+    size_t getObserverCount() const {
+        return subscriptions.size();
+    }
+
+    // Every subscription in delivery order, as visit(observer, ingredient,
+    // events); the ingredient is empty for every-ingredient subscriptions
+    template <typename Visit>
+    void forEachSubscription(Visit visit) const {
+        static const std::string everyIngredient;
+        for (uint32_t list = 0; list < subscribers.size(); ++list) {
+            const std::string& ingredient = list < everyIngredientList() ? ingredientNames[list] : everyIngredient;
+            for (const Subscriber& subscriber : subscribers[list]) {
+                if (subscriber.observer) visit(subscriber.observer, ingredient, subscriber.events);
+            }
         }
     }
 
+    // Live levels - only for the thread driving orders; monitors should
+    // use readSnapshot()
     const std::map<std::string, int>& getIngredients() const {
         return ingredients;
     }
+
+    const std::map<std::string, int>& getThresholds() const {
+        return thresholds;
+    }
+
+    // Factory low-level thresholds
+    static const std::map<std::string, int>& getDefaultThresholds() {
+        static const std::map<std::string, int> defaults = {
+            {"Coffee Beans", 100}, {"Water", 500}, {"Milk", 200},
+            {"Chocolate", 50}, {"Cups", 10}
+        };
+        return defaults;
+    }
+
+    // Recipe lookup (ingredients only - every drink also takes one cup)
+    static const Recipe& getRecipe(CoffeeType coffeeType) {
+        initializeRecipes();
+        static const Recipe empty;
+        auto it = RECIPES.find(coffeeType);
+        return it != RECIPES.end() ? it->second : empty;
+    }
 };
 
 // Static member definition
-std::map<CoffeeType, std::map<std::string, int>> Inventory::RECIPES;
+std::map<CoffeeType, Recipe> Inventory::RECIPES;
 
 #endif // INVENTORY_HPP
@@ -0,0 +1,358 @@
+#ifndef INVENTORY_HISTORY_HPP
+#define INVENTORY_HISTORY_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Compressed in-memory time series of ingredient levels (Gorilla-style).
+// Samples are packed into blocks of up to BLOCK_SAMPLES; each block keeps
+// its first timestamp/value and time range uncompressed so range queries
+// can skip whole blocks.
+//
+// Timestamps are quantised to a tick (1 s by default - week-long dashboards
+// do not need milliseconds) and stored as delta-of-delta: a steady cadence
+// costs one bit, ordinary jitter 9-12 bits. Levels are integers, so instead
+// of the float XOR trick each change is matched against the last two deltas
+// (recipes repeat the same few amounts) and only misses are written out as
+// zigzag literals. Typical order traffic lands around 1.5 bytes per sample.
+
+// Bit-level append/read buffer used by the encoders
+class BitBuffer {
+private:
+    std::vector<uint8_t> bytes;
+    size_t bitCount = 0;
+
+public:
+    void write(uint64_t value, unsigned bits) {
+        while (bits > 0) {
+            if (bitCount % 8 == 0) bytes.push_back(0);
+            unsigned freeBits = 8 - static_cast<unsigned>(bitCount % 8);
+            unsigned take = std::min(freeBits, bits);
+            uint8_t chunk = static_cast<uint8_t>((value >> (bits - take)) & ((1u << take) - 1));
+            bytes.back() |= static_cast<uint8_t>(chunk << (freeBits - take));
+            bitCount += take;
+            bits -= take;
+        }
+    }
+
+    uint64_t read(size_t& position, unsigned bits) const {
+        uint64_t value = 0;
+        while (bits > 0) {
+            unsigned offset = static_cast<unsigned>(position % 8);
+            unsigned available = 8 - offset;
+            unsigned take = std::min(available, bits);
+            uint8_t byte = bytes[position / 8];
+            uint8_t chunk = static_cast<uint8_t>((byte >> (available - take)) & ((1u << take) - 1));
+            value = (value << take) | chunk;
+            position += take;
+            bits -= take;
+        }
+        return value;
+    }
+
+    size_t sizeBits() const { return bitCount; }
+    size_t sizeBytes() const { return bytes.capacity(); }
+    void shrink() { bytes.shrink_to_fit(); }
+};
+
+class TimeSeries {
+public:
+    struct Sample {
+        int64_t timestamp;
+        int value;
+    };
+
+    // One downsampling bucket: [start, start + width)
+    struct Bucket {
+        int64_t start;
+        int min;
+        int max;
+        int last;
+        uint32_t count;
+    };
+
+    static constexpr uint32_t BLOCK_SAMPLES = 1024;
+
+private:
+    struct Block {
+        int64_t firstTick = 0;
+        int64_t lastTick = 0;
+        int firstValue = 0;
+        uint32_t count = 0;
+        BitBuffer bits;
+
+        // Encoder state (only meaningful for the open block)
+        int64_t prevDelta = 0;
+        int lastValue = 0;
+        int64_t recentDeltas[2] = {0, 0};
+    };
+
+    std::vector<std::unique_ptr<Block>> blocks;
+    uint64_t totalSamples = 0;
+    int64_t tickMillis;
+
+    static uint64_t zigzag(int64_t v) {
+        return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);
+    }
+
+    static int64_t unzigzag(uint64_t v) {
+        return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1);
+    }
+
+    int64_t toTick(int64_t millis) const {
+        int64_t tick = millis / tickMillis;
+        return (millis % tickMillis < 0) ? tick - 1 : tick;
+    }
+
+    // '0' | '10'+7 | '110'+9 | '1110'+12 | '11110'+24 | '11111'+64
+    static void writeTimestampDod(BitBuffer& bits, int64_t dod) {
+        if (dod == 0) {
+            bits.write(0, 1);
+            return;
+        }
+        uint64_t z = zigzag(dod);
+        if (z < (1u << 7)) {
+            bits.write(0b10, 2);
+            bits.write(z, 7);
+        } else if (z < (1u << 9)) {
+            bits.write(0b110, 3);
+            bits.write(z, 9);
+        } else if (z < (1u << 12)) {
+            bits.write(0b1110, 4);
+            bits.write(z, 12);
+        } else if (z < (1u << 24)) {
+            bits.write(0b11110, 5);
+            bits.write(z, 24);
+        } else {
+            bits.write(0b11111, 5);
+            bits.write(z, 64);
+        }
+    }
+
+    static int64_t readTimestampDod(const BitBuffer& bits, size_t& pos) {
+        if (bits.read(pos, 1) == 0) return 0;
+        if (bits.read(pos, 1) == 0) return unzigzag(bits.read(pos, 7));
+        if (bits.read(pos, 1) == 0) return unzigzag(bits.read(pos, 9));
+        if (bits.read(pos, 1) == 0) return unzigzag(bits.read(pos, 12));
+        if (bits.read(pos, 1) == 0) return unzigzag(bits.read(pos, 24));
+        return unzigzag(bits.read(pos, 64));
+    }
+
+    // '0' last delta | '10' the one before | '110'+8 | '1110'+16 | '1111'+34
+    static void writeValueDelta(BitBuffer& bits, int64_t recent[2], int64_t delta) {
+        if (delta == recent[0]) {
+            bits.write(0, 1);
+            return;
+        }
+        if (delta == recent[1]) {
+            bits.write(0b10, 2);
+        } else {
+            uint64_t z = zigzag(delta);
+            if (z < (1u << 8)) {
+                bits.write(0b110, 3);
+                bits.write(z, 8);
+            } else if (z < (1u << 16)) {
+                bits.write(0b1110, 4);
+                bits.write(z, 16);
+            } else {
+                bits.write(0b1111, 4);
+                bits.write(z, 34);
+            }
+        }
+        recent[1] = recent[0];
+        recent[0] = delta;
+    }
+
+    static int64_t readValueDelta(const BitBuffer& bits, size_t& pos, int64_t recent[2]) {
+        if (bits.read(pos, 1) == 0) return recent[0];
+        int64_t delta;
+        if (bits.read(pos, 1) == 0) {
+            delta = recent[1];
+        } else if (bits.read(pos, 1) == 0) {
+            delta = unzigzag(bits.read(pos, 8));
+        } else if (bits.read(pos, 1) == 0) {
+            delta = unzigzag(bits.read(pos, 16));
+        } else {
+            delta = unzigzag(bits.read(pos, 34));
+        }
+        recent[1] = recent[0];
+        recent[0] = delta;
+        return delta;
+    }
+
+    // Decode a block, calling fn(tick, value) for every sample
+    template <typename Fn>
+    static void decodeBlock(const Block& block, Fn&& fn) {
+        int64_t tick = block.firstTick;
+        int64_t value = block.firstValue;
+        int64_t delta = 0;
+        int64_t recent[2] = {0, 0};
+        size_t pos = 0;
+        fn(tick, static_cast<int>(value));
+        for (uint32_t i = 1; i < block.count; ++i) {
+            delta += readTimestampDod(block.bits, pos);
+            tick += delta;
+            value += readValueDelta(block.bits, pos, recent);
+            fn(tick, static_cast<int>(value));
+        }
+    }
+
+public:
+    explicit TimeSeries(int64_t tickMs = 1000) : tickMillis(tickMs > 0 ? tickMs : 1) {}
+
+    // Timestamps (ms) must not go backwards; older ones are clamped to the last
+    void append(int64_t timestamp, int value) {
+        int64_t tick = toTick(timestamp);
+        if (blocks.empty() || blocks.back()->count == BLOCK_SAMPLES) {
+            if (!blocks.empty()) {
+                blocks.back()->bits.shrink();
+                tick = std::max(tick, blocks.back()->lastTick);
+            }
+            auto block = std::make_unique<Block>();
+            block->firstTick = block->lastTick = tick;
+            block->firstValue = block->lastValue = value;
+            block->count = 1;
+            blocks.push_back(std::move(block));
+            totalSamples++;
+            return;
+        }
+
+        Block& block = *blocks.back();
+        tick = std::max(tick, block.lastTick);
+        int64_t delta = tick - block.lastTick;
+        writeTimestampDod(block.bits, delta - block.prevDelta);
+        writeValueDelta(block.bits, block.recentDeltas,
+                        static_cast<int64_t>(value) - block.lastValue);
+
+        block.prevDelta = delta;
+        block.lastTick = tick;
+        block.lastValue = value;
+        block.count++;
+        totalSamples++;
+    }
+
+    // All samples with from <= timestamp <= to; timestamps come back
+    // rounded down to the tick
+    std::vector<Sample> query(int64_t from, int64_t to) const {
+        std::vector<Sample> samples;
+        forEach(from, to, [&samples](int64_t ts, int value) {
+            samples.push_back({ts, value});
+        });
+        return samples;
+    }
+
+    template <typename Fn>
+    void forEach(int64_t from, int64_t to, Fn&& fn) const {
+        // Blocks are time-ordered: binary search the first candidate
+        int64_t firstTick = toTick(from);
+        int64_t lastTick = toTick(to);
+        auto it = std::lower_bound(blocks.begin(), blocks.end(), firstTick,
+            [](const std::unique_ptr<Block>& block, int64_t t) { return block->lastTick < t; });
+        for (; it != blocks.end() && (*it)->firstTick <= lastTick; ++it) {
+            decodeBlock(**it, [&](int64_t tick, int value) {
+                int64_t ts = tick * tickMillis;
+                if (ts >= from && ts <= to) fn(ts, value);
+            });
+        }
+    }
+
+    // Min/max/last per fixed-width bucket; empty buckets are omitted
+    std::vector<Bucket> downsample(int64_t from, int64_t to, int64_t width) const {
+        std::vector<Bucket> buckets;
+        if (width <= 0) return buckets;
+        forEach(from, to, [&](int64_t ts, int value) {
+            int64_t start = from + (ts - from) / width * width;
+            if (buckets.empty() || buckets.back().start != start) {
+                buckets.push_back({start, value, value, value, 0});
+            }
+            Bucket& bucket = buckets.back();
+            bucket.min = std::min(bucket.min, value);
+            bucket.max = std::max(bucket.max, value);
+            bucket.last = value;
+            bucket.count++;
+        });
+        return buckets;
+    }
+
+    uint64_t getSampleCount() const { return totalSamples; }
+    int64_t getTickMillis() const { return tickMillis; }
+
+    // Compressed payload plus per-block headers
+    size_t getMemoryBytes() const {
+        size_t total = blocks.capacity() * sizeof(std::unique_ptr<Block>);
+        for (const auto& block : blocks) {
+            total += sizeof(Block) + block->bits.sizeBytes();
+        }
+        return total;
+    }
+};
+
+// Per-ingredient histories for one machine's Inventory
+class InventoryHistory {
+public:
+    using TimeSource = int64_t (*)();
+
+private:
+    std::vector<std::pair<std::string, TimeSeries>> series;
+    TimeSource clock;
+    int64_t tickMillis;
+
+    static int64_t wallClockMillis() {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+
+public:
+    explicit InventoryHistory(int64_t tickMs = 1000) : clock(&wallClockMillis), tickMillis(tickMs) {}
+
+    // Replace the clock (simulations, replays)
+    void setTimeSource(TimeSource source) { clock = source ? source : &wallClockMillis; }
+    int64_t now() const { return clock(); }
+
+    void record(const std::string& ingredient, int level) {
+        record(ingredient, clock(), level);
+    }
+
+    void record(const std::string& ingredient, int64_t timestamp, int level) {
+        for (auto& [name, ts] : series) {
+            if (name == ingredient) {
+                ts.append(timestamp, level);
+                return;
+            }
+        }
+        series.emplace_back(ingredient, TimeSeries(tickMillis));
+        series.back().second.append(timestamp, level);
+    }
+
+    const TimeSeries* getSeries(const std::string& ingredient) const {
+        for (const auto& [name, ts] : series) {
+            if (name == ingredient) return &ts;
+        }
+        return nullptr;
+    }
+
+    std::vector<std::string> getIngredientNames() const {
+        std::vector<std::string> names;
+        for (const auto& entry : series) names.push_back(entry.first);
+        return names;
+    }
+
+    uint64_t getSampleCount() const {
+        uint64_t total = 0;
+        for (const auto& entry : series) total += entry.second.getSampleCount();
+        return total;
+    }
+
+    size_t getMemoryBytes() const {
+        size_t total = 0;
+        for (const auto& entry : series) total += entry.second.getMemoryBytes();
+        return total;
+    }
+};
+
+#endif // INVENTORY_HISTORY_HPP
@@ -0,0 +1,240 @@
+#ifndef MACHINE_EVENT_LOG_HPP
+#define MACHINE_EVENT_LOG_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Event Sourcing - every change to a CoffeeMachine and its Inventory is
+// appended to an ordered event stream. The log folds each event into a
+// running MachineImage as it arrives and keeps a copy of that image every
+// snapshot interval (1024 events by default), so the state at any past
+// timestamp is rebuilt by loading the nearest earlier snapshot and
+// replaying at most one interval of events - microseconds, however long
+// the history.
+//
+// Inventory changes are logged as per-ingredient deltas rather than
+// "made a latte", so replay does not depend on the recipe table in force
+// when the event happened.
+
+enum class MachineEventType : uint8_t {
+    SELECT,      // arg = CoffeeType
+    PAYMENT,     // arg = 1 accepted / 0 declined, value = price
+    CONSUME,     // arg = ingredient index, amount = units taken
+    REFILL,      // arg = ingredient index, amount = units added
+    DISPENSE,    // order handed over
+    CANCEL,      // pending selection dropped
+    OPERATIONAL, // arg = 1 in service / 0 maintenance
+    QUEUE,       // paid order handed to a BrewQueue, arg = CoffeeType
+    COMPLETE     // queued order finished brewing, arg = CoffeeType
+};
+
+struct MachineEvent {
+    int64_t timestamp;
+    double value;
+    int32_t amount;
+    int16_t arg;
+    MachineEventType type;
+};
+
+// Phase mirrors the State Pattern classes in CoffeeMachine.hpp
+enum class MachinePhase : uint8_t { IDLE, SELECTING, PROCESSING };
+
+// Everything the event stream determines about a machine
+struct MachineImage {
+    static constexpr size_t MAX_INGREDIENTS = 8;
+
+    int64_t timestamp = 0;      // of the last applied event
+    uint64_t eventCount = 0;    // events applied since the log was reset
+    MachinePhase phase = MachinePhase::IDLE;
+    bool operational = true;
+    int selectedType = -1;
+    uint32_t ingredientCount = 0;
+    int levels[MAX_INGREDIENTS] = {};
+    uint64_t ordersServed = 0;
+    uint64_t ordersCancelled = 0;
+    uint64_t paymentsDeclined = 0;
+    double revenue = 0.0;
+
+    static const char* phaseName(MachinePhase phase) {
+        switch (phase) {
+            case MachinePhase::IDLE: return "Idle";
+            case MachinePhase::SELECTING: return "Selecting";
+            case MachinePhase::PROCESSING: return "Processing";
+        }
+        return "Unknown";
+    }
+
+    void apply(const MachineEvent& event) {
+        switch (event.type) {
+            case MachineEventType::SELECT:
+                phase = MachinePhase::SELECTING;
+                selectedType = event.arg;
+                break;
+            case MachineEventType::PAYMENT:
+                if (event.arg) {
+                    phase = MachinePhase::PROCESSING;
+                    revenue += event.value;
+                } else {
+                    paymentsDeclined++;
+                }
+                break;
+            case MachineEventType::CONSUME:
+                if (static_cast<uint32_t>(event.arg) < ingredientCount) levels[event.arg] -= event.amount;
+                break;
+            case MachineEventType::REFILL:
+                if (static_cast<uint32_t>(event.arg) < ingredientCount) levels[event.arg] += event.amount;
+                break;
+            case MachineEventType::DISPENSE:
+                phase = MachinePhase::IDLE;
+                selectedType = -1;
+                ordersServed++;
+                break;
+            case MachineEventType::CANCEL:
+                phase = MachinePhase::IDLE;
+                selectedType = -1;
+                ordersCancelled++;
+                break;
+            case MachineEventType::OPERATIONAL:
+                operational = event.arg != 0;
+                break;
+            case MachineEventType::QUEUE:
+                phase = MachinePhase::IDLE;
+                selectedType = -1;
+                break;
+            case MachineEventType::COMPLETE:
+                ordersServed++;
+                break;
+        }
+        timestamp = event.timestamp;
+        eventCount++;
+    }
+
+    // Fields reconstructed from events (timestamps/counters excluded)
+    bool sameMachineState(const MachineImage& other) const {
+        return phase == other.phase && operational == other.operational
+            && selectedType == other.selectedType
+            && ingredientCount == other.ingredientCount
+            && std::equal(levels, levels + ingredientCount, other.levels);
+    }
+};
+
+// Append-only event store with periodic snapshots and point-in-time replay.
+// Single writer; replay queries run on the same thread as the writer.
+class MachineEventLog {
+public:
+    using TimeSource = int64_t (*)();
+
+    static constexpr uint64_t DEFAULT_SNAPSHOT_INTERVAL = 1024;
+
+private:
+    std::vector<MachineEvent> events;
+    std::vector<MachineImage> snapshots; // snapshots[i].eventCount == i * interval
+    std::vector<std::string> ingredientNames;
+    MachineImage current;
+    uint64_t snapshotInterval;
+    TimeSource clock;
+
+    static int64_t wallClockMillis() {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+
+    // Latest snapshot taken at or before timestamp (snapshot 0 if none)
+    size_t snapshotBefore(int64_t timestamp) const {
+        auto it = std::upper_bound(snapshots.begin(), snapshots.end(), timestamp,
+            [](int64_t t, const MachineImage& snap) { return t < snap.timestamp; });
+        return it == snapshots.begin() ? 0 : static_cast<size_t>(it - snapshots.begin()) - 1;
+    }
+
+public:
+    explicit MachineEventLog(uint64_t interval = DEFAULT_SNAPSHOT_INTERVAL)
+        : snapshotInterval(interval > 0 ? interval : 1), clock(&wallClockMillis) {}
+
+    MachineEventLog(const MachineEventLog&) = delete;
+    MachineEventLog& operator=(const MachineEventLog&) = delete;
+
+    // Replace the clock (simulations, replays)
+    void setTimeSource(TimeSource source) { clock = source ? source : &wallClockMillis; }
+    int64_t now() const { return clock(); }
+
+    // Start a new stream from a known state (CoffeeMachine::attachEventLog)
+    void reset(MachineImage initial, std::vector<std::string> names) {
+        events.clear();
+        snapshots.clear();
+        ingredientNames = std::move(names);
+        initial.timestamp = clock();
+        initial.eventCount = 0;
+        current = initial;
+        snapshots.push_back(current);
+    }
+
+    void append(MachineEventType type, int arg = 0, int amount = 0, double value = 0.0) {
+        MachineEvent event{std::max(clock(), current.timestamp), value,
+                           static_cast<int32_t>(amount), static_cast<int16_t>(arg), type};
+        events.push_back(event);
+        current.apply(event);
+        if (current.eventCount % snapshotInterval == 0) {
+            snapshots.push_back(current);
+        }
+    }
+
+    // An ingredient level change reported by Inventory
+    void appendLevelChange(bool refill, int index, int amount) {
+        append(refill ? MachineEventType::REFILL : MachineEventType::CONSUME, index, amount);
+    }
+
+    // State after every event with timestamp <= t (times before reset()
+    // give the state the log started from)
+    MachineImage stateAt(int64_t timestamp) const {
+        MachineImage image = snapshots[snapshotBefore(timestamp)];
+        for (size_t i = image.eventCount; i < events.size() && events[i].timestamp <= timestamp; ++i) {
+            image.apply(events[i]);
+        }
+        return image;
+    }
+
+    // State after exactly `count` events
+    MachineImage stateAfter(uint64_t count) const {
+        count = std::min<uint64_t>(count, events.size());
+        MachineImage image = snapshots[count / snapshotInterval];
+        for (size_t i = image.eventCount; i < count; ++i) {
+            image.apply(events[i]);
+        }
+        return image;
+    }
+
+    // Audit trail: events with from <= timestamp <= to
+    std::vector<MachineEvent> eventsBetween(int64_t from, int64_t to) const {
+        auto first = std::lower_bound(events.begin(), events.end(), from,
+            [](const MachineEvent& e, int64_t t) { return e.timestamp < t; });
+        auto last = std::upper_bound(first, events.end(), to,
+            [](int64_t t, const MachineEvent& e) { return t < e.timestamp; });
+        return std::vector<MachineEvent>(first, last);
+    }
+
+    static const char* eventTypeName(MachineEventType type) {
+        switch (type) {
+            case MachineEventType::SELECT: return "SELECT";
+            case MachineEventType::PAYMENT: return "PAYMENT";
+            case MachineEventType::CONSUME: return "CONSUME";
+            case MachineEventType::REFILL: return "REFILL";
+            case MachineEventType::DISPENSE: return "DISPENSE";
+            case MachineEventType::CANCEL: return "CANCEL";
+            case MachineEventType::OPERATIONAL: return "OPERATIONAL";
+            case MachineEventType::QUEUE: return "QUEUE";
+            case MachineEventType::COMPLETE: return "COMPLETE";
+        }
+        return "UNKNOWN";
+    }
+
+    const MachineImage& currentState() const { return current; }
+    const std::vector<std::string>& getIngredientNames() const { return ingredientNames; }
+    size_t getEventCount() const { return events.size(); }
+    size_t getSnapshotCount() const { return snapshots.size(); }
+    uint64_t getSnapshotInterval() const { return snapshotInterval; }
+};
+
+#endif // MACHINE_EVENT_LOG_HPP
@@ -0,0 +1,458 @@
+#ifndef MACHINE_MIGRATION_HPP
+#define MACHINE_MIGRATION_HPP
+
+#include "CoffeeMachine.hpp"
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+// Machine handover between processes (rebalancing kiosks across controller
+// hosts). save() encodes a live CoffeeMachine into a compact binary image -
+// state, selected coffee and its quoted price, session counters, ingredient
+// levels, thresholds and reservations, inventory subscriptions, the
+// attached BrewQueue's orders and the receipt numbering - and restore()
+// rebuilds it on a fresh machine in another process.
+//
+// The handover is stop-and-copy: the old owner stops driving the machine,
+// saves it and drops it; the new owner restores the image before taking
+// orders. Queued orders keep their numbers, the active brew cycle its
+// remaining time and the receipt log its numbering, so no order is lost or
+// issued twice. The numbering lives in the BrewQueue and ReceiptLog, so a
+// target missing one the image has numbers for is refused, not restored
+// with its numbering reset.
+//
+// Observers are pointers, meaningless in another process, so both sides
+// name them in an ObserverDirectory with ids they agree on (a supplier's
+// account number, say). Brew observers, timers, telemetry and the event log
+// stay with their owners: the new owner attaches its own before restoring
+// (an attached event log restarts from the restored state).
+//
+// Layout: header {magic, format, payload bytes, FNV-1a of the payload},
+// then fixed-width fields in host byte order - both ends of a handover run
+// the same build. Ingredients are named, so the target's ingredient order
+// does not matter. restore() validates the whole image before changing
+// anything.
+
+enum class MigrationError {
+    NONE,
+    TRUNCATED,          // shorter than its header says
+    BAD_MAGIC,
+    BAD_FORMAT,         // written by another format version
+    CHECKSUM,
+    UNKNOWN_OBSERVER,   // save: observer not in the directory; restore: id not in it
+    UNKNOWN_INGREDIENT, // the target's inventory lacks an ingredient
+    MENU_VERSION,       // an order is pinned to a menu version the target lacks
+    NO_QUEUE,           // the image has queued or numbered orders, the target no BrewQueue
+    NO_RECEIPTS,        // the image has issued receipts, the target no ReceiptLog
+    NOT_IDLE            // the target machine or queue already has work
+};
+
+// Observers both sides of a handover know, by agreed id
+class ObserverDirectory {
+private:
+    std::unordered_map<InventoryObserver*, uint32_t> ids;
+    std::unordered_map<uint32_t, InventoryObserver*> observers;
+
+public:
+    void add(uint32_t id, InventoryObserver* observer) {
+        ids[observer] = id;
+        observers[id] = observer;
+    }
+
+    bool idOf(InventoryObserver* observer, uint32_t& id) const {
+        auto it = ids.find(observer);
+        if (it == ids.end()) return false;
+        id = it->second;
+        return true;
+    }
+
+    InventoryObserver* find(uint32_t id) const {
+        auto it = observers.find(id);
+        return it == observers.end() ? nullptr : it->second;
+    }
+};
+
+class MachineMigration {
+public:
+    static constexpr uint64_t MAGIC = 0x434f46464d494752ULL; // "COFFMIGR"
+    static constexpr uint32_t FORMAT = 2;
+
+    static const char* errorName(MigrationError error) {
+        switch (error) {
+            case MigrationError::NONE: return "ok";
+            case MigrationError::TRUNCATED: return "truncated";
+            case MigrationError::BAD_MAGIC: return "bad magic";
+            case MigrationError::BAD_FORMAT: return "bad format version";
+            case MigrationError::CHECKSUM: return "checksum mismatch";
+            case MigrationError::UNKNOWN_OBSERVER: return "unknown observer";
+            case MigrationError::UNKNOWN_INGREDIENT: return "unknown ingredient";
+            case MigrationError::MENU_VERSION: return "menu version not available";
+            case MigrationError::NO_QUEUE: return "no brew queue attached";
+            case MigrationError::NO_RECEIPTS: return "no receipt log attached";
+            case MigrationError::NOT_IDLE: return "target not idle";
+        }
+        return "unknown";
+    }
+
+private:
+    struct Subscription {
+        uint32_t observerId;
+        std::string ingredient;         // empty: every ingredient
+        InventoryEventMask events;
+    };
+
+    // Everything in an image, decoded before any of it is applied
+    struct Image {
+        MachineSessionImage session;
+        std::map<std::string, int> levels;
+        std::map<std::string, int> thresholds;
+        std::map<std::string, int> reserved;
+        int reservedCups = 0;
+        std::vector<Subscription> subscriptions;
+        bool hasQueue = false;
+        BrewQueue::Image queue;
+        bool hasReceipts = false;
+        uint64_t receiptsIssued = 0;
+    };
+
+    static constexpr size_t HEADER_BYTES = 8 + 4 + 4 + 8;
+
+    class Writer {
+    private:
+        std::string& out;
+
+    public:
+        explicit Writer(std::string& target) : out(target) {}
+
+        template <typename T>
+        void put(T value) {
+            static_assert(std::is_trivially_copyable<T>::value, "fixed-width fields only");
+            char bytes[sizeof(T)];
+            std::memcpy(bytes, &value, sizeof(T));
+            out.append(bytes, sizeof(T));
+        }
+
+        void putString(std::string_view text) {
+            put(static_cast<uint16_t>(text.size()));
+            out.append(text.data(), text.size());
+        }
+    };
+
+    class Reader {
+    private:
+        std::string_view in;
+        bool failed = false;
+
+    public:
+        explicit Reader(std::string_view source) : in(source) {}
+
+        template <typename T>
+        T get() {
+            T value{};
+            if (in.size() < sizeof(T)) {
+                failed = true;
+                return value;
+            }
+            std::memcpy(&value, in.data(), sizeof(T));
+            in.remove_prefix(sizeof(T));
+            return value;
+        }
+
+        std::string getString() {
+            uint16_t size = get<uint16_t>();
+            if (in.size() < size) {
+                failed = true;
+                return std::string();
+            }
+            std::string text(in.substr(0, size));
+            in.remove_prefix(size);
+            return text;
+        }
+
+        // Counts read from the image are bounded by the bytes left
+        bool fits(uint64_t count, size_t minBytesEach) const { return count <= in.size() / minBytesEach; }
+        void fail() { failed = true; }
+        bool ok() const { return !failed; }
+        bool done() const { return in.empty(); }
+    };
+
+    static uint64_t checksum(std::string_view bytes) {
+        uint64_t h = 1469598103934665603ULL;
+        for (char c : bytes) {
+            h ^= static_cast<uint8_t>(c);
+            h *= 1099511628211ULL;
+        }
+        return h;
+    }
+
+    static void putOrders(Writer& out, const std::vector<BrewQueue::OrderImage>& orders) {
+        out.put(static_cast<uint32_t>(orders.size()));
+        for (const auto& order : orders) {
+            out.put(order.orderId);
+            out.put(static_cast<uint8_t>(order.type));
+            out.put(order.ageMs);
+            out.put(static_cast<uint8_t>(order.onMenu));
+            out.put(order.menuVersion);
+        }
+    }
+
+    static void getOrders(Reader& in, std::vector<BrewQueue::OrderImage>& orders) {
+        uint32_t count = in.get<uint32_t>();
+        if (!in.fits(count, 8 + 1 + 8 + 1 + 8)) return in.fail();
+        orders.resize(count);
+        for (auto& order : orders) {
+            order.orderId = in.get<uint64_t>();
+            uint8_t type = in.get<uint8_t>();
+            if (type >= static_cast<uint8_t>(CoffeeType::COUNT)) return in.fail();
+            order.type = static_cast<CoffeeType>(type);
+            order.ageMs = in.get<int64_t>();
+            order.onMenu = in.get<uint8_t>() != 0;
+            order.menuVersion = in.get<uint64_t>();
+        }
+    }
+
+    static bool decode(std::string_view bytes, Image& image, MigrationError& error) {
+        Reader header(bytes);
+        uint64_t magic = header.get<uint64_t>();
+        uint32_t format = header.get<uint32_t>();
+        uint32_t length = header.get<uint32_t>();
+        uint64_t sum = header.get<uint64_t>();
+        if (!header.ok() || (magic == MAGIC && bytes.size() - HEADER_BYTES < length)) {
+            error = MigrationError::TRUNCATED;
+        } else if (magic != MAGIC) {
+            error = MigrationError::BAD_MAGIC;
+        } else if (format != FORMAT) {
+            error = MigrationError::BAD_FORMAT;
+        } else if (checksum(bytes.substr(HEADER_BYTES, length)) != sum) {
+            error = MigrationError::CHECKSUM;
+        }
+        if (error != MigrationError::NONE) return false;
+
+        Reader in(bytes.substr(HEADER_BYTES, length));
+        MachineSessionImage& session = image.session;
+        uint8_t phase = in.get<uint8_t>();
+        if (phase > static_cast<uint8_t>(MachinePhase::PROCESSING)) in.fail();
+        session.phase = static_cast<MachinePhase>(phase);
+        session.operational = in.get<uint8_t>() != 0;
+        session.selectedType = in.get<int8_t>();
+        if (session.phase == MachinePhase::SELECTING &&
+            (session.selectedType < 0 || session.selectedType >= static_cast<int>(CoffeeType::COUNT))) {
+            in.fail();
+        }
+        session.holdingIngredients = in.get<uint8_t>() != 0;
+        session.paymentAttempts = in.get<int32_t>();
+        session.quotedPrice = in.get<double>();
+        session.sessionTimeouts = in.get<uint64_t>();
+        session.onMenu = in.get<uint8_t>() != 0;
+        session.menuVersion = in.get<uint64_t>();
+        session.appliedMenuVersion = in.get<uint64_t>();
+
+        uint16_t ingredients = in.get<uint16_t>();
+        for (uint16_t i = 0; i < ingredients && in.ok(); ++i) {
+            std::string name = in.getString();
+            image.levels[name] = in.get<int32_t>();
+            image.thresholds[name] = in.get<int32_t>();
+            image.reserved[name] = in.get<int32_t>();
+        }
+        image.reservedCups = in.get<int32_t>();
+
+        uint32_t subscriptions = in.get<uint32_t>();
+        if (!in.fits(subscriptions, 4 + 2 + 1)) in.fail();
+        for (uint32_t i = 0; i < subscriptions && in.ok(); ++i) {
+            Subscription entry;
+            entry.observerId = in.get<uint32_t>();
+            entry.ingredient = in.getString();
+            entry.events = in.get<InventoryEventMask>();
+            image.subscriptions.push_back(std::move(entry));
+        }
+
+        image.hasQueue = in.get<uint8_t>() != 0;
+        if (image.hasQueue) {
+            BrewQueue::Image& queue = image.queue;
+            queue.nextOrderId = in.get<uint64_t>();
+            queue.stats.ordersQueued = in.get<uint64_t>();
+            queue.stats.ordersCompleted = in.get<uint64_t>();
+            queue.stats.cycles = in.get<uint64_t>();
+            queue.stats.brewingMs = in.get<int64_t>();
+            queue.cycleId = in.get<uint64_t>();
+            queue.remainingMs = in.get<int64_t>();
+            getOrders(in, queue.active);
+            getOrders(in, queue.pending);
+        }
+        image.hasReceipts = in.get<uint8_t>() != 0;
+        if (image.hasReceipts) image.receiptsIssued = in.get<uint64_t>();
+
+        if (!in.ok() || !in.done()) {
+            error = MigrationError::TRUNCATED;
+            return false;
+        }
+        return true;
+    }
+
+    // Checks against the target that decoding cannot make
+    static MigrationError check(CoffeeMachine& machine, const Image& image, const ObserverDirectory& observers) {
+        Inventory* inventory = machine.getInventory();
+        for (const auto& [name, level] : image.levels) {
+            if (!inventory->getIngredients().count(name)) return MigrationError::UNKNOWN_INGREDIENT;
+        }
+        for (const Subscription& entry : image.subscriptions) {
+            if (!observers.find(entry.observerId)) return MigrationError::UNKNOWN_OBSERVER;
+            if (!entry.ingredient.empty() && !inventory->getIngredients().count(entry.ingredient)) {
+                return MigrationError::UNKNOWN_INGREDIENT;
+            }
+        }
+        if (machine.getSelectedCoffee() || machine.getCurrentState()->getPhase() != OrderPathPhase::IDLE) {
+            return MigrationError::NOT_IDLE;
+        }
+
+        const MenuRegistry* menu = machine.getMenu();
+        auto onTargetMenu = [menu](bool onMenu, uint64_t version) {
+            return !onMenu || (menu && menu->getVersion() == version);
+        };
+        const MachineSessionImage& session = image.session;
+        if (session.phase == MachinePhase::PROCESSING) return MigrationError::NOT_IDLE;
+        if (session.phase == MachinePhase::SELECTING && !onTargetMenu(session.onMenu, session.menuVersion)) {
+            return MigrationError::MENU_VERSION;
+        }
+
+        if (image.hasReceipts && image.receiptsIssued > 0 && !machine.getReceipts()) {
+            return MigrationError::NO_RECEIPTS;
+        }
+
+        // An empty queue still carries the order numbering; only a queue
+        // that never numbered an order can be left behind
+        const BrewQueue::Image& queue = image.queue;
+        if (!image.hasQueue) return MigrationError::NONE;
+        BrewQueue* target = machine.getBrewQueue();
+        if (!target) {
+            bool numbered = queue.nextOrderId > 1 || !queue.pending.empty() || !queue.active.empty();
+            return numbered ? MigrationError::NO_QUEUE : MigrationError::NONE;
+        }
+        if (!target->isIdle()) return MigrationError::NOT_IDLE;
+        for (const auto* orders : {&queue.pending, &queue.active}) {
+            for (const auto& order : *orders) {
+                if (!onTargetMenu(order.onMenu, order.menuVersion)) return MigrationError::MENU_VERSION;
+            }
+        }
+        return MigrationError::NONE;
+    }
+
+public:
+    // Encode the machine into out (replacing its contents). Fails only if
+    // an inventory observer is missing from the directory.
+    static MigrationError save(CoffeeMachine& machine, const ObserverDirectory& observers, std::string& out) {
+        out.assign(HEADER_BYTES, '\0');
+        Writer payload(out);
+
+        MachineSessionImage session = machine.exportSession();
+        payload.put(static_cast<uint8_t>(session.phase));
+        payload.put(static_cast<uint8_t>(session.operational));
+        payload.put(static_cast<int8_t>(session.selectedType));
+        payload.put(static_cast<uint8_t>(session.holdingIngredients));
+        payload.put(static_cast<int32_t>(session.paymentAttempts));
+        payload.put(session.quotedPrice);
+        payload.put(session.sessionTimeouts);
+        payload.put(static_cast<uint8_t>(session.onMenu));
+        payload.put(session.menuVersion);
+        payload.put(session.appliedMenuVersion);
+
+        Inventory* inventory = machine.getInventory();
+        const std::map<std::string, int>& levels = inventory->getIngredients();
+        const std::map<std::string, int>& thresholds = inventory->getThresholds();
+        const std::map<std::string, int>& reserved = inventory->getReservations();
+        payload.put(static_cast<uint16_t>(levels.size()));
+        for (const auto& [name, level] : levels) {
+            auto threshold = thresholds.find(name);
+            auto held = reserved.find(name);
+            payload.putString(name);
+            payload.put(static_cast<int32_t>(level));
+            payload.put(static_cast<int32_t>(threshold != thresholds.end() ? threshold->second : 0));
+            payload.put(static_cast<int32_t>(held != reserved.end() ? held->second : 0));
+        }
+        payload.put(static_cast<int32_t>(inventory->getReservedCups()));
+
+        std::vector<Subscription> subscriptions;
+        bool named = true;
+        inventory->forEachSubscription([&](InventoryObserver* observer, const std::string& ingredient,
+                                           InventoryEventMask events) {
+            uint32_t id = 0;
+            named = named && observers.idOf(observer, id);
+            subscriptions.push_back({id, ingredient, events});
+        });
+        if (!named) {
+            out.clear();
+            return MigrationError::UNKNOWN_OBSERVER;
+        }
+        payload.put(static_cast<uint32_t>(subscriptions.size()));
+        for (const Subscription& entry : subscriptions) {
+            payload.put(entry.observerId);
+            payload.putString(entry.ingredient);
+            payload.put(entry.events);
+        }
+
+        BrewQueue* queue = machine.getBrewQueue();
+        payload.put(static_cast<uint8_t>(queue != nullptr));
+        if (queue) {
+            BrewQueue::Image image = queue->exportImage();
+            payload.put(image.nextOrderId);
+            payload.put(image.stats.ordersQueued);
+            payload.put(image.stats.ordersCompleted);
+            payload.put(image.stats.cycles);
+            payload.put(image.stats.brewingMs);
+            payload.put(image.cycleId);
+            payload.put(image.remainingMs);
+            putOrders(payload, image.active);
+            putOrders(payload, image.pending);
+        }
+        ReceiptLog* receipts = machine.getReceipts();
+        payload.put(static_cast<uint8_t>(receipts != nullptr));
+        if (receipts) payload.put(receipts->getReceipts());
+
+        uint64_t sum = checksum(std::string_view(out).substr(HEADER_BYTES));
+        uint32_t length = static_cast<uint32_t>(out.size() - HEADER_BYTES);
+        std::memcpy(&out[0], &MAGIC, 8);
+        std::memcpy(&out[8], &FORMAT, 4);
+        std::memcpy(&out[12], &length, 4);
+        std::memcpy(&out[16], &sum, 8);
+        return MigrationError::NONE;
+    }
+
+    // Rebuild a saved machine on a fresh one (Idle, idle queue). Attach the
+    // target's BrewQueue, menu, timers and receipt log first. On an error
+    // nothing is changed.
+    static MigrationError restore(CoffeeMachine& machine, std::string_view bytes, const ObserverDirectory& observers) {
+        Image image;
+        MigrationError error = MigrationError::NONE;
+        if (!decode(bytes, image, error)) return error;
+        error = check(machine, image, observers);
+        if (error != MigrationError::NONE) return error;
+
+        // Session restore needs no reservation; the inventory carries it
+        Inventory* inventory = machine.getInventory();
+        inventory->restoreLevels(image.levels, image.thresholds, image.reserved, image.reservedCups);
+        machine.restoreSession(image.session);
+        if (BrewQueue* queue = machine.getBrewQueue()) {
+            if (image.hasQueue) {
+                const MenuRegistry* menu = machine.getMenu();
+                queue->restoreImage(image.queue, menu ? menu->acquire() : MenuHandle());
+            }
+        }
+        for (const Subscription& entry : image.subscriptions) {
+            InventoryObserver* observer = observers.find(entry.observerId);
+            if (entry.ingredient.empty()) inventory->subscribeAll(observer, entry.events);
+            else inventory->subscribe(observer, entry.ingredient, entry.events);
+        }
+        if (image.hasReceipts) {
+            if (ReceiptLog* receipts = machine.getReceipts()) receipts->continueNumbering(image.receiptsIssued);
+        }
+        if (MachineEventLog* log = machine.getEventLog()) machine.attachEventLog(log);
+        return MigrationError::NONE;
+    }
+};
+
+#endif // MACHINE_MIGRATION_HPP
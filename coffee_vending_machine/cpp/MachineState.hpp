@@ -1,6 +1,8 @@
 #ifndef MACHINE_STATE_HPP
 #define MACHINE_STATE_HPP
 
+#include "OrderArena.hpp"
+#include "OrderPathProfile.hpp"
 #include <string>
 #include <memory>
 #include <iostream>
@@ -10,7 +12,8 @@ class CoffeeMachine;
 
 // State Pattern - Allows machine to alter behavior when internal state changes
 // Demonstrates Abstraction and Polymorphism (OOP)
-class MachineState {
+// States are allocated from the machine's per-order arena
+class MachineState : public ArenaAllocated {
 public:
     virtual ~MachineState() = default;
     virtual void selectCoffee(CoffeeMachine* machine, int choice) = 0;
@@ -18,6 +21,7 @@ public:
     virtual void dispense(CoffeeMachine* machine) = 0;
     virtual void cancel(CoffeeMachine* machine) = 0;
     virtual std::string getStateName() const = 0;
+    virtual OrderPathPhase getPhase() const = 0; // for OrderPathProfile
 };
 
 #endif // MACHINE_STATE_HPP
@@ -0,0 +1,309 @@
+#ifndef MENU_CONFIG_HPP
+#define MENU_CONFIG_HPP
+
+#include "Inventory.hpp"
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Hot-reloadable menu: prices, preparation times, recipes and low-level
+// thresholds held in immutable, versioned snapshots. Changes are written as
+// one directive per line and applied on top of the factory defaults (the
+// Coffee classes and Inventory's built-in recipes):
+//
+//   price      Mocha        4.25         # 0 to MAX_PRICE dollars
+//   prep       Latte        35           # 0 to MAX_PREPARATION_SECONDS
+//   recipe     Latte        Coffee Beans=18, Water=30, Milk=170
+//   disable    Americano
+//   threshold  Milk=300
+//
+// Drinks are names or menu numbers; ingredient names may contain spaces.
+//
+// RCU-style publication: reload() builds a complete snapshot on the calling
+// thread, then swaps it in with one atomic pointer store. The order path
+// pins the snapshot it starts on (acquire() - three atomic operations, no
+// lock) and keeps using it until the order is finished, however many
+// reloads happen meanwhile. Replaced snapshots are freed once no order pins
+// them and no reader can still be between loading the pointer and pinning
+// it (the grace period).
+
+// One drink's entry in a menu version
+struct MenuItem {
+    bool available = true;
+    double price = 0.0;
+    int preparationTime = 0;
+    Recipe recipe;
+};
+
+struct MenuSnapshot {
+    static constexpr int TYPES = static_cast<int>(CoffeeType::COUNT);
+
+    uint64_t version = 0;
+    MenuItem items[TYPES];
+    std::map<std::string, int> thresholds;
+
+    // Orders currently running on this version
+    mutable std::atomic<int> pins{0};
+
+    const MenuItem& item(CoffeeType type) const { return items[static_cast<int>(type)]; }
+};
+
+// A pinned snapshot; copying pins again, destruction unpins
+class MenuHandle {
+private:
+    const MenuSnapshot* snapshot = nullptr;
+
+public:
+    MenuHandle() = default;
+    explicit MenuHandle(const MenuSnapshot* pinned) : snapshot(pinned) {}
+
+    MenuHandle(const MenuHandle& other) : snapshot(other.snapshot) {
+        if (snapshot) snapshot->pins.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    MenuHandle(MenuHandle&& other) noexcept : snapshot(other.snapshot) {
+        other.snapshot = nullptr;
+    }
+
+    MenuHandle& operator=(MenuHandle other) noexcept {
+        std::swap(snapshot, other.snapshot);
+        return *this;
+    }
+
+    ~MenuHandle() { reset(); }
+
+    void reset() {
+        if (snapshot) snapshot->pins.fetch_sub(1, std::memory_order_release);
+        snapshot = nullptr;
+    }
+
+    const MenuSnapshot* get() const { return snapshot; }
+    const MenuSnapshot* operator->() const { return snapshot; }
+    const MenuSnapshot& operator*() const { return *snapshot; }
+    explicit operator bool() const { return snapshot != nullptr; }
+};
+
+// Handles must not outlive the registry that issued them
+class MenuRegistry {
+public:
+    static constexpr double MAX_PRICE = 1000.0;
+    static constexpr int MAX_PREPARATION_SECONDS = 3600;
+
+private:
+    std::atomic<const MenuSnapshot*> current{nullptr};
+    mutable std::atomic<uint64_t> readers{0}; // inside acquire() right now
+    std::vector<std::unique_ptr<MenuSnapshot>> retired;
+    std::unique_ptr<MenuSnapshot> live;      // owns *current
+    std::mutex reloadMutex;                  // writers only
+    std::string lastError;
+    uint64_t reclaimed = 0;
+
+    static std::string trim(const std::string& text) {
+        size_t start = text.find_first_not_of(" \t\r");
+        if (start == std::string::npos) return "";
+        size_t end = text.find_last_not_of(" \t\r");
+        return text.substr(start, end - start + 1);
+    }
+
+    static bool parseDrink(const std::string& text, int& type) {
+        for (int t = 0; t < MenuSnapshot::TYPES; ++t) {
+            if (text == CoffeeFactory::getCoffeeTypeName(static_cast<CoffeeType>(t)) ||
+                text == std::to_string(t + 1)) {
+                type = t;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // "name=amount" with a non-negative amount
+    static bool parseAmount(const std::string& text, std::string& name, int& amount) {
+        size_t eq = text.find('=');
+        if (eq == std::string::npos) return false;
+        name = trim(text.substr(0, eq));
+        std::string value = trim(text.substr(eq + 1));
+        char* end = nullptr;
+        long parsed = std::strtol(value.c_str(), &end, 10);
+        if (name.empty() || value.empty() || *end != '\0' || parsed < 0) return false;
+        amount = static_cast<int>(parsed);
+        return true;
+    }
+
+    static std::unique_ptr<MenuSnapshot> defaults() {
+        auto snapshot = std::make_unique<MenuSnapshot>();
+        for (int t = 0; t < MenuSnapshot::TYPES; ++t) {
+            CoffeeType type = static_cast<CoffeeType>(t);
+            auto coffee = CoffeeFactory::createCoffee(type);
+            MenuItem& item = snapshot->items[t];
+            item.price = coffee->getPrice();
+            item.preparationTime = coffee->getPreparationTime();
+            item.recipe = Inventory::getRecipe(type);
+        }
+        snapshot->thresholds = Inventory::getDefaultThresholds();
+        return snapshot;
+    }
+
+    bool fail(int lineNumber, const std::string& message) {
+        lastError = "line " + std::to_string(lineNumber) + ": " + message;
+        return false;
+    }
+
+    // Free retired snapshots nobody can reach any more. Skipped (not waited
+    // for) while a reader is mid-acquire; the next reload retries.
+    void reclaim() {
+        if (readers.load(std::memory_order_seq_cst) != 0) return;
+        for (auto it = retired.begin(); it != retired.end();) {
+            if ((*it)->pins.load(std::memory_order_acquire) == 0) {
+                it = retired.erase(it);
+                reclaimed++;
+            } else {
+                ++it;
+            }
+        }
+    }
+
+public:
+    MenuRegistry() {
+        reload("");
+    }
+
+    MenuRegistry(const MenuRegistry&) = delete;
+    MenuRegistry& operator=(const MenuRegistry&) = delete;
+
+    // Build a snapshot from directives and publish it. On an error nothing
+    // changes and getLastError() names the rejected line.
+    bool reload(const std::string& directives) {
+        std::lock_guard<std::mutex> guard(reloadMutex);
+        std::unique_ptr<MenuSnapshot> next = defaults();
+
+        std::stringstream input(directives);
+        std::string line;
+        int lineNumber = 0;
+        while (std::getline(input, line)) {
+            lineNumber++;
+            line = trim(line.substr(0, line.find('#')));
+            if (line.empty()) continue;
+            std::stringstream fields(line);
+            std::string action;
+            fields >> action;
+
+            if (action == "threshold") {
+                std::string rest;
+                std::getline(fields, rest);
+                std::string ingredient;
+                int amount = 0;
+                if (!parseAmount(rest, ingredient, amount)) return fail(lineNumber, "expected: threshold NAME=AMOUNT");
+                next->thresholds[ingredient] = amount;
+                continue;
+            }
+
+            if (action != "price" && action != "prep" && action != "recipe" &&
+                action != "enable" && action != "disable") {
+                return fail(lineNumber, "unknown directive '" + action + "'");
+            }
+            std::string drink;
+            int type = 0;
+            if (!(fields >> drink) || !parseDrink(drink, type)) {
+                return fail(lineNumber, "unknown drink '" + drink + "'");
+            }
+            MenuItem& item = next->items[type];
+            std::string rest;
+            std::getline(fields, rest);
+            rest = trim(rest);
+
+            if (action == "price" || action == "prep") {
+                char* end = nullptr;
+                double value = std::strtod(rest.c_str(), &end);
+                double limit = action == "price" ? MAX_PRICE : MAX_PREPARATION_SECONDS;
+                if (rest.empty() || *end != '\0' || !std::isfinite(value) || value < 0 || value > limit) {
+                    return fail(lineNumber, "bad " + action + " '" + rest + "'");
+                }
+                if (action == "price") item.price = value;
+                else item.preparationTime = static_cast<int>(value);
+            } else if (action == "recipe") {
+                Recipe recipe;
+                std::stringstream parts(rest);
+                std::string part;
+                while (std::getline(parts, part, ',')) {
+                    std::string ingredient;
+                    int amount = 0;
+                    if (!parseAmount(part, ingredient, amount)) {
+                        return fail(lineNumber, "bad ingredient '" + trim(part) + "'");
+                    }
+                    recipe[ingredient] = amount;
+                }
+                if (recipe.empty()) return fail(lineNumber, "empty recipe");
+                item.recipe = std::move(recipe);
+            } else {
+                if (!rest.empty()) return fail(lineNumber, "unexpected '" + rest + "'");
+                item.available = action == "enable";
+            }
+        }
+
+        next->version = live ? live->version + 1 : 0;
+        const MenuSnapshot* published = next.get();
+        current.store(published, std::memory_order_seq_cst);
+        if (live) retired.push_back(std::move(live));
+        live = std::move(next);
+        lastError.clear();
+        reclaim();
+        return true;
+    }
+
+    bool reloadFile(const std::string& path) {
+        std::ifstream file(path);
+        if (!file) {
+            std::lock_guard<std::mutex> guard(reloadMutex);
+            lastError = "cannot open " + path;
+            return false;
+        }
+        std::stringstream content;
+        content << file.rdbuf();
+        return reload(content.str());
+    }
+
+    // Pin the current snapshot - lock-free, safe from any thread
+    MenuHandle acquire() const {
+        readers.fetch_add(1, std::memory_order_seq_cst);
+        const MenuSnapshot* snapshot = current.load(std::memory_order_seq_cst);
+        snapshot->pins.fetch_add(1, std::memory_order_relaxed);
+        readers.fetch_sub(1, std::memory_order_seq_cst);
+        return MenuHandle(snapshot);
+    }
+
+    // Bracketed like acquire(): a reload may retire and free the snapshot
+    // between loading the pointer and reading through it
+    uint64_t getVersion() const {
+        readers.fetch_add(1, std::memory_order_seq_cst);
+        uint64_t version = current.load(std::memory_order_seq_cst)->version;
+        readers.fetch_sub(1, std::memory_order_seq_cst);
+        return version;
+    }
+
+    // Writer-side bookkeeping
+    std::string getLastError() {
+        std::lock_guard<std::mutex> guard(reloadMutex);
+        return lastError;
+    }
+
+    size_t getRetiredCount() {
+        std::lock_guard<std::mutex> guard(reloadMutex);
+        reclaim();
+        return retired.size();
+    }
+
+    uint64_t getReclaimedCount() {
+        std::lock_guard<std::mutex> guard(reloadMutex);
+        return reclaimed;
+    }
+};
+
+#endif // MENU_CONFIG_HPP
@@ -0,0 +1,21 @@
+#ifndef MONEY_HPP
+#define MONEY_HPP
+
+#include <charconv>
+#include <ostream>
+
+// Prints an amount as dollars with two decimals. Formats into a local
+// buffer instead of setting std::fixed / std::setprecision on the stream:
+// std::cout is shared by every machine thread, and changing its format
+// flags from several threads at once is a data race.
+struct Dollars {
+    double amount;
+};
+
+inline std::ostream& operator<<(std::ostream& os, Dollars money) {
+    char text[32];
+    auto result = std::to_chars(text, text + sizeof(text), money.amount, std::chars_format::fixed, 2);
+    return os.write(text, result.ptr - text);
+}
+
+#endif // MONEY_HPP
@@ -1,6 +1,7 @@
 #ifndef OBSERVER_HPP
 #define OBSERVER_HPP
 
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <algorithm>
@@ -8,11 +9,27 @@
 // Observer Pattern - For notifying operators about inventory levels
 // Demonstrates Abstraction (OOP)
 
+// Kinds of inventory notification; observers subscribe to a mask of them
+enum class InventoryEvent : uint8_t {
+    LOW_LEVEL = 1 << 0,  // at or below threshold after consumption -> update()
+    REFILLED = 1 << 1,   // topped up by an operator -> refilled()
+};
+
+using InventoryEventMask = uint8_t;
+
+constexpr InventoryEventMask eventMask(InventoryEvent event) {
+    return static_cast<InventoryEventMask>(event);
+}
+
+constexpr InventoryEventMask ALL_INVENTORY_EVENTS =
+    eventMask(InventoryEvent::LOW_LEVEL) | eventMask(InventoryEvent::REFILLED);
+
 // Observer Interface
 class InventoryObserver {
 public:
     virtual ~InventoryObserver() = default;
     virtual void update(const std::string& ingredient, int currentLevel, int threshold) = 0;
+    virtual void refilled(const std::string& /*ingredient*/, int /*currentLevel*/, int /*amount*/) {}
 };
 
 // Subject Interface
@@ -3,20 +3,27 @@
 
 #include "CoffeeMachine.hpp"
 #include "Observer.hpp"
+#include <charconv>
 #include <string>
+#include <utility>
 #include <vector>
 #include <iostream>
-#include <sstream>
 
 // Operator Actor - Manages and maintains the Coffee Machine
 // Implements Observer Pattern to receive inventory alerts
 // Demonstrates Encapsulation and Inheritance concepts (OOP)
 class Operator : public InventoryObserver {
+public:
+    // Alerts kept for viewAlerts()/getAlerts(). Once full the oldest is
+    // dropped, so an operator watching a machine that stays low does not
+    // keep every alert it was ever sent.
+    static constexpr size_t MAX_ALERTS = 100;
+
 private:
     std::string operatorId;
     std::string name;
     CoffeeMachine* machine;
-    std::vector<std::string> alerts;
+    std::vector<std::string> alerts;            // oldest first
 
 public:
     Operator(const std::string& id, const std::string& operatorName)
@@ -25,21 +32,47 @@ public:
         machine->registerObserver(this);
     }
 
+    // Supplier-style operator (milk, beans, cups...): alerts only for the
+    // given ingredients
+    Operator(const std::string& id, const std::string& operatorName, const std::vector<std::string>& ingredients)
+        : operatorId(id), name(operatorName), machine(CoffeeMachine::getInstance()) {
+        for (const auto& ingredient : ingredients) {
+            if (!machine->registerObserver(this, ingredient)) {
+                std::cout << "Operator " << name << ": unknown ingredient " << ingredient << "\n";
+            }
+        }
+    }
+
     ~Operator() {
         // Unregister from notifications
         machine->removeObserver(this);
     }
 
-    // Observer Pattern - Receive notifications about low inventory
+    static void appendNumber(std::string& out, int value) {
+        char digits[16];
+        auto result = std::to_chars(digits, digits + sizeof(digits), value);
+        out.append(digits, result.ptr);
+    }
+
+    // Observer Pattern - Receive notifications about low inventory.
+    // Once the history is full the alert is written into the string of the
+    // one it drops, so a machine that stays low does not allocate per brew.
     void update(const std::string& ingredient, int currentLevel, int threshold) override {
-        std::ostringstream oss;
-        oss << "[ALERT] Low inventory: " << ingredient
-            << " at " << currentLevel << " (threshold: " << threshold << ")";
-        alerts.push_back(oss.str());
+        std::string alert;
+        if (alerts.size() == MAX_ALERTS) {
+            alert = std::move(alerts.front());
+            alerts.erase(alerts.begin());
+        }
+        alert.assign("[ALERT] Low inventory: ").append(ingredient).append(" at ");
+        appendNumber(alert, currentLevel);
+        alert.append(" (threshold: ");
+        appendNumber(alert, threshold);
+        alert.append(")");
+        alerts.push_back(std::move(alert));
 
         std::cout << "\n*** OPERATOR NOTIFICATION ***\n";
         std::cout << "Operator " << name << " received alert:\n";
-        std::cout << oss.str() << "\n";
+        std::cout << alerts.back() << "\n";
         std::cout << "*****************************\n\n";
     }
 
@@ -88,14 +121,21 @@ public:
         std::cout << "Alerts cleared.\n";
     }
 
+    // Standard top-up amounts used by refillAll (in grams/ml)
+    static const std::vector<std::pair<std::string, int>>& getRefillAmounts() {
+        static const std::vector<std::pair<std::string, int>> amounts = {
+            {"Coffee Beans", 400}, {"Water", 1500}, {"Milk", 800},
+            {"Chocolate", 150}, {"Cups", 40}
+        };
+        return amounts;
+    }
+
     // Refill all ingredients to maximum
     void refillAll() {
         std::cout << "\nOperator " << name << " refilling all ingredients...\n";
-        refillIngredient("Coffee Beans", 400);
-        refillIngredient("Water", 1500);
-        refillIngredient("Milk", 800);
-        refillIngredient("Chocolate", 150);
-        refillIngredient("Cups", 40);
+        for (const auto& [ingredient, amount] : getRefillAmounts()) {
+            refillIngredient(ingredient, amount);
+        }
         std::cout << "All ingredients refilled.\n";
     }
 
@@ -0,0 +1,109 @@
+#ifndef ORDER_ARENA_HPP
+#define ORDER_ARENA_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <memory_resource>
+
+// Per-order memory arena built on std::pmr::monotonic_buffer_resource.
+// Everything an order creates (Coffee, MachineState objects, the
+// PaymentStrategy and its strings) is carved from a fixed inline buffer, so a
+// steady-state order never touches the global heap.
+//
+// The arena is double-buffered: completeOrder() switches to the other half
+// and releases it. Objects from the order that just finished (the
+// DispensingState still on the call stack, the payment owned by the caller)
+// stay valid until the *next* order completes, by which point they are gone.
+class OrderArena {
+public:
+    static constexpr size_t BUFFER_SIZE = 4096;
+
+    // Makes an arena the allocation target for ArenaAllocated objects (and
+    // pmr strings built via currentResource()) on this thread
+    class Scope {
+    private:
+        std::pmr::memory_resource* previous;
+
+    public:
+        explicit Scope(OrderArena& arena) : previous(current) {
+            current = arena.resource();
+        }
+        ~Scope() { current = previous; }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    };
+
+private:
+    struct Half {
+        alignas(std::max_align_t) std::byte buffer[BUFFER_SIZE];
+        std::pmr::monotonic_buffer_resource pool{buffer, BUFFER_SIZE,
+                                                 std::pmr::new_delete_resource()};
+    };
+
+    // Allocation header: which resource served the block, so delete can route
+    // it back (blocks made outside any Scope come from the global heap)
+    struct alignas(std::max_align_t) Header {
+        std::pmr::memory_resource* resource;
+        size_t size;
+    };
+
+    static inline thread_local std::pmr::memory_resource* current = nullptr;
+
+    Half halves[2];
+    int active = 0;
+    uint64_t ordersCompleted = 0;
+
+public:
+    OrderArena() = default;
+    OrderArena(const OrderArena&) = delete;
+    OrderArena& operator=(const OrderArena&) = delete;
+
+    std::pmr::memory_resource* resource() { return &halves[active].pool; }
+
+    // Called when an order finishes (dispensed or cancelled)
+    void completeOrder() {
+        active ^= 1;
+        halves[active].pool.release();
+        ordersCompleted++;
+    }
+
+    uint64_t getOrdersCompleted() const { return ordersCompleted; }
+
+    // Resource for per-order containers/strings: the active arena if any,
+    // otherwise the default (heap) resource
+    static std::pmr::memory_resource* currentResource() {
+        return current ? current : std::pmr::get_default_resource();
+    }
+
+    static void* allocate(size_t size) {
+        size_t total = size + sizeof(Header);
+        void* block = current ? current->allocate(total, alignof(Header))
+                              : ::operator new(total);
+        Header* header = static_cast<Header*>(block);
+        header->resource = current;
+        header->size = total;
+        return header + 1;
+    }
+
+    static void deallocate(void* ptr) noexcept {
+        if (ptr == nullptr) return;
+        Header* header = static_cast<Header*>(ptr) - 1;
+        if (header->resource) {
+            header->resource->deallocate(header, header->size, alignof(Header));
+        } else {
+            ::operator delete(header);
+        }
+    }
+};
+
+// Mixin for per-order class hierarchies: plain make_unique/new/delete of any
+// derived class goes through the current OrderArena
+class ArenaAllocated {
+public:
+    static void* operator new(size_t size) { return OrderArena::allocate(size); }
+    static void operator delete(void* ptr) noexcept { OrderArena::deallocate(ptr); }
+};
+
+#endif // ORDER_ARENA_HPP
@@ -0,0 +1,216 @@
+#ifndef ORDER_PATH_PROFILE_HPP
+#define ORDER_PATH_PROFILE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <streambuf>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Order-path instrumentation: heap allocations and console output per
+// order, broken down by the machine state whose handler caused them.
+//
+// The machine tags its thread with the state it is running (a Scope in the
+// CoffeeMachine entry points, enter() on every state change); everything
+// else - the protocol front end, brew queue polling, other threads - counts
+// as OUTSIDE. The counters are fed by a profiling binary: it replaces the
+// global operator new/delete with versions that call recordAllocation()
+// and recordFree() (see order_path_profile.cpp), routes std::cout through
+// a SinkTap, and gives the receipt writer counting file calls. In every
+// other binary the tagging is one thread-local store per state change and
+// the counters stay at zero.
+
+enum class OrderPathPhase : uint8_t { OUTSIDE, IDLE, SELECTING, PROCESSING, DISPENSING, COUNT };
+
+struct OrderPathCounters {
+    uint64_t allocations = 0;
+    uint64_t bytes = 0;
+    uint64_t frees = 0;
+    uint64_t sinkCalls = 0;            // insertions reaching the console sink
+    uint64_t sinkBytes = 0;
+    uint64_t writes = 0;               // write() calls the sink made
+    uint64_t fileWrites = 0;           // writev() calls of file sinks (receipts)
+    uint64_t fileSyncs = 0;            // fdatasync() calls of file sinks
+
+    // Allocations still live: what a long run accumulates
+    int64_t growth() const { return static_cast<int64_t>(allocations - frees); }
+
+    OrderPathCounters& operator-=(const OrderPathCounters& other) {
+        allocations -= other.allocations;
+        bytes -= other.bytes;
+        frees -= other.frees;
+        sinkCalls -= other.sinkCalls;
+        sinkBytes -= other.sinkBytes;
+        writes -= other.writes;
+        fileWrites -= other.fileWrites;
+        fileSyncs -= other.fileSyncs;
+        return *this;
+    }
+};
+
+class OrderPathProfile {
+public:
+    static constexpr int PHASES = static_cast<int>(OrderPathPhase::COUNT);
+
+    struct Snapshot {
+        OrderPathCounters phases[PHASES];
+
+        OrderPathCounters total() const {
+            OrderPathCounters sum;
+            for (const OrderPathCounters& phase : phases) {
+                sum.allocations += phase.allocations;
+                sum.bytes += phase.bytes;
+                sum.frees += phase.frees;
+                sum.sinkCalls += phase.sinkCalls;
+                sum.sinkBytes += phase.sinkBytes;
+                sum.writes += phase.writes;
+                sum.fileWrites += phase.fileWrites;
+                sum.fileSyncs += phase.fileSyncs;
+            }
+            return sum;
+        }
+
+        Snapshot& operator-=(const Snapshot& other) {
+            for (int p = 0; p < PHASES; ++p) phases[p] -= other.phases[p];
+            return *this;
+        }
+    };
+
+private:
+    // Static storage is zeroed before any constructor runs, so these are
+    // usable from operator new before main()
+    struct Slot {
+        std::atomic<uint64_t> allocations;
+        std::atomic<uint64_t> bytes;
+        std::atomic<uint64_t> frees;
+        std::atomic<uint64_t> sinkCalls;
+        std::atomic<uint64_t> sinkBytes;
+        std::atomic<uint64_t> writes;
+        std::atomic<uint64_t> fileWrites;
+        std::atomic<uint64_t> fileSyncs;
+    };
+
+    static inline thread_local OrderPathPhase phase = OrderPathPhase::OUTSIDE;
+    static inline Slot slots[PHASES];
+
+    static Slot& slot() { return slots[static_cast<int>(phase)]; }
+
+public:
+    // Tags the thread with a state for the life of the scope
+    class Scope {
+    private:
+        OrderPathPhase saved;
+
+    public:
+        explicit Scope(OrderPathPhase entered) : saved(phase) { phase = entered; }
+        ~Scope() { phase = saved; }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    };
+
+    static void enter(OrderPathPhase entered) { phase = entered; }
+    static OrderPathPhase current() { return phase; }
+
+    static void recordAllocation(size_t size) {
+        Slot& s = slot();
+        s.allocations.fetch_add(1, std::memory_order_relaxed);
+        s.bytes.fetch_add(size, std::memory_order_relaxed);
+    }
+    static void recordFree() { slot().frees.fetch_add(1, std::memory_order_relaxed); }
+    static void recordSinkCall(size_t size) {
+        Slot& s = slot();
+        s.sinkCalls.fetch_add(1, std::memory_order_relaxed);
+        s.sinkBytes.fetch_add(size, std::memory_order_relaxed);
+    }
+    static void recordWrite() { slot().writes.fetch_add(1, std::memory_order_relaxed); }
+    static void recordFileWrite() { slot().fileWrites.fetch_add(1, std::memory_order_relaxed); }
+    static void recordFileSync() { slot().fileSyncs.fetch_add(1, std::memory_order_relaxed); }
+
+    static Snapshot read() {
+        Snapshot snap;
+        for (int p = 0; p < PHASES; ++p) {
+            snap.phases[p].allocations = slots[p].allocations.load(std::memory_order_relaxed);
+            snap.phases[p].bytes = slots[p].bytes.load(std::memory_order_relaxed);
+            snap.phases[p].frees = slots[p].frees.load(std::memory_order_relaxed);
+            snap.phases[p].sinkCalls = slots[p].sinkCalls.load(std::memory_order_relaxed);
+            snap.phases[p].sinkBytes = slots[p].sinkBytes.load(std::memory_order_relaxed);
+            snap.phases[p].writes = slots[p].writes.load(std::memory_order_relaxed);
+            snap.phases[p].fileWrites = slots[p].fileWrites.load(std::memory_order_relaxed);
+            snap.phases[p].fileSyncs = slots[p].fileSyncs.load(std::memory_order_relaxed);
+        }
+        return snap;
+    }
+
+    static const char* phaseName(OrderPathPhase p) {
+        switch (p) {
+            case OrderPathPhase::OUTSIDE: return "Outside";
+            case OrderPathPhase::IDLE: return "Idle";
+            case OrderPathPhase::SELECTING: return "Selecting";
+            case OrderPathPhase::PROCESSING: return "Processing";
+            case OrderPathPhase::DISPENSING: return "Dispensing";
+            default: return "";
+        }
+    }
+};
+
+// Console sink that counts what reaches it: every insertion, and every
+// write() the output turns into. Insertions go on to a stdio stream, so
+// the buffering is the one std::cout has in production (synced with stdio):
+// line-buffered as on a terminal, or block-buffered in the descriptor's
+// st_blksize blocks as when stdout is a file or pipe. Its write calls are
+// counted where stdio hands them to the kernel. It keeps no put area, so
+// each insertion - single characters too - comes through here. Install
+// with std::cout.rdbuf(&tap); put the old buffer back before the tap goes.
+class SinkTap : public std::streambuf {
+private:
+    int fd;
+    FILE* stream;
+
+    static ssize_t writeOut(void* cookie, const char* data, size_t size) {
+        int descriptor = *static_cast<int*>(cookie);
+        size_t done = 0;
+        while (done < size) {
+            OrderPathProfile::recordWrite();
+            ssize_t written = ::write(descriptor, data + done, size - done);
+            if (written <= 0) return done > 0 ? static_cast<ssize_t>(done) : -1;
+            done += static_cast<size_t>(written);
+        }
+        return static_cast<ssize_t>(done);
+    }
+
+protected:
+    int_type overflow(int_type c) override {
+        if (traits_type::eq_int_type(c, traits_type::eof())) return traits_type::not_eof(c);
+        OrderPathProfile::recordSinkCall(1);
+        return std::putc(traits_type::to_char_type(c), stream) == EOF ? traits_type::eof() : c;
+    }
+
+    std::streamsize xsputn(const char* s, std::streamsize n) override {
+        OrderPathProfile::recordSinkCall(static_cast<size_t>(n));
+        return static_cast<std::streamsize>(std::fwrite(s, 1, static_cast<size_t>(n), stream));
+    }
+
+    int sync() override { return std::fflush(stream) == 0 ? 0 : -1; }
+
+public:
+    explicit SinkTap(int descriptor, bool lineBuffering = true) : fd(descriptor) {
+        stream = fopencookie(&fd, "w", cookie_io_functions_t{nullptr, &SinkTap::writeOut, nullptr, nullptr});
+        struct stat info;
+        size_t block = ::fstat(fd, &info) == 0 && info.st_blksize > 0 ? static_cast<size_t>(info.st_blksize) : BUFSIZ;
+        if (stream) std::setvbuf(stream, nullptr, lineBuffering ? _IOLBF : _IOFBF, block);
+    }
+
+    ~SinkTap() override {
+        if (stream) std::fclose(stream);
+    }
+
+    SinkTap(const SinkTap&) = delete;
+    SinkTap& operator=(const SinkTap&) = delete;
+
+    bool ok() const { return stream != nullptr; }
+};
+
+#endif // ORDER_PATH_PROFILE_HPP
@@ -0,0 +1,374 @@
+#ifndef ORDER_PROTOCOL_HPP
+#define ORDER_PROTOCOL_HPP
+
+#include "CoffeeMachine.hpp"
+#include "Operator.hpp"
+#include <string>
+#include <string_view>
+#include <charconv>
+#include <cstdint>
+
+// Compact line protocol for driving a CoffeeMachine without the console UI.
+// One command per line, fields separated by spaces; one response line each.
+//
+//   M                    -> OK 1:Espresso:2.50,2:Cappuccino:3.50,...
+//   S <1-5>              -> OK <coffee> <price> | ERR BUSY|INVALID|UNAVAILABLE|MAINTENANCE
+//   P C <amount>         -> OK <coffee>         | ERR DECLINED|CANCELLED|TIMEOUT|NOSELECTION|BUSY|MAINTENANCE
+//   P K <card> <pin>
+//   P U <upi-id>
+//   X                    -> OK                  | ERR TIMEOUT|NOSELECTION|BUSY
+//   T                    -> OK <state> <operational 0/1> <selected or ->
+//   R                    -> OK  (operator: refill all ingredients)
+//   F <amount> <name>    -> OK <new level> | ERR UNKNOWN  (operator: refill one)
+//   I                    -> OK <name>:<level>,...         (operator: inventory)
+//   O <0|1>              -> OK  (operator: maintenance on (0) / off (1))
+//
+// With session timeouts (CoffeeMachine::attachTimers) the machine may drop
+// a selection on its own: TIMEOUT when it expired unpaid, CANCELLED when
+// the payment that was just declined used up the session's attempts.
+//
+// Parsing works on string_views into the caller's buffer; payment strings are
+// copied only into the machine's order arena.
+
+enum class OrderOp {
+    MENU,
+    SELECT,
+    PAY,
+    CANCEL,
+    STATUS,
+    REFILL,
+    REFILL_ONE,
+    INVENTORY,
+    SET_OPERATIONAL,
+    INVALID
+};
+
+enum class PaymentKind {
+    CASH,
+    CARD,
+    UPI
+};
+
+struct OrderCommand {
+    OrderOp op = OrderOp::INVALID;
+    int choice = 0;
+    PaymentKind payment = PaymentKind::CASH;
+    double amount = 0.0;
+    std::string_view arg1;
+    std::string_view arg2;
+};
+
+class OrderProtocol {
+private:
+    static std::string_view nextToken(std::string_view& line) {
+        size_t start = line.find_first_not_of(" \t\r");
+        if (start == std::string_view::npos) {
+            line = std::string_view();
+            return std::string_view();
+        }
+        line.remove_prefix(start);
+        size_t end = line.find_first_of(" \t\r");
+        std::string_view token = line.substr(0, end);
+        line.remove_prefix(end == std::string_view::npos ? line.size() : end);
+        return token;
+    }
+
+    static bool parseInt(std::string_view token, int& value) {
+        auto result = std::from_chars(token.data(), token.data() + token.size(), value);
+        return result.ec == std::errc() && result.ptr == token.data() + token.size();
+    }
+
+    static bool parseDouble(std::string_view token, double& value) {
+        auto result = std::from_chars(token.data(), token.data() + token.size(), value);
+        return result.ec == std::errc() && result.ptr == token.data() + token.size();
+    }
+
+public:
+    // Parse a single line (without the trailing '\n')
+    static OrderCommand parse(std::string_view line) {
+        OrderCommand cmd;
+        std::string_view verb = nextToken(line);
+        if (verb.size() != 1) return cmd;
+
+        switch (verb[0]) {
+            case 'M': cmd.op = OrderOp::MENU; break;
+            case 'X': cmd.op = OrderOp::CANCEL; break;
+            case 'T': cmd.op = OrderOp::STATUS; break;
+            case 'R': cmd.op = OrderOp::REFILL; break;
+            case 'I': cmd.op = OrderOp::INVENTORY; break;
+            case 'O':
+                if (parseInt(nextToken(line), cmd.choice) &&
+                    (cmd.choice == 0 || cmd.choice == 1)) {
+                    cmd.op = OrderOp::SET_OPERATIONAL;
+                }
+                break;
+            case 'F': {
+                // Ingredient names contain spaces, so the name is the rest of the line
+                if (!parseInt(nextToken(line), cmd.choice) || cmd.choice <= 0) break;
+                size_t start = line.find_first_not_of(" \t");
+                size_t end = line.find_last_not_of(" \t\r");
+                if (start == std::string_view::npos) break;
+                cmd.arg1 = line.substr(start, end - start + 1);
+                cmd.op = OrderOp::REFILL_ONE;
+                break;
+            }
+            case 'S':
+                if (parseInt(nextToken(line), cmd.choice)) {
+                    cmd.op = OrderOp::SELECT;
+                }
+                break;
+            case 'P': {
+                std::string_view kind = nextToken(line);
+                if (kind == "C") {
+                    cmd.payment = PaymentKind::CASH;
+                    if (parseDouble(nextToken(line), cmd.amount)) cmd.op = OrderOp::PAY;
+                } else if (kind == "K") {
+                    cmd.payment = PaymentKind::CARD;
+                    cmd.arg1 = nextToken(line);
+                    cmd.arg2 = nextToken(line);
+                    if (!cmd.arg1.empty()) cmd.op = OrderOp::PAY;
+                } else if (kind == "U") {
+                    cmd.payment = PaymentKind::UPI;
+                    cmd.arg1 = nextToken(line);
+                    if (!cmd.arg1.empty()) cmd.op = OrderOp::PAY;
+                }
+                break;
+            }
+            default:
+                break;
+        }
+        return cmd;
+    }
+
+    static std::unique_ptr<PaymentStrategy> createPayment(const OrderCommand& cmd) {
+        switch (cmd.payment) {
+            case PaymentKind::CASH:
+                return std::make_unique<CashPayment>(cmd.amount);
+            case PaymentKind::CARD:
+                return std::make_unique<CardPayment>(cmd.arg1, cmd.arg2);
+            case PaymentKind::UPI:
+                return std::make_unique<UPIPayment>(cmd.arg1);
+        }
+        return nullptr;
+    }
+
+    static void appendPrice(std::string& out, double price) {
+        char buf[32];
+        auto result = std::to_chars(buf, buf + sizeof(buf), price, std::chars_format::fixed, 2);
+        out.append(buf, result.ptr);
+    }
+
+    static void appendMenu(std::string& out) {
+        static const std::string menu = [] {
+            std::string line = "OK ";
+            for (int i = 0; i < static_cast<int>(CoffeeType::COUNT); ++i) {
+                auto coffee = CoffeeFactory::createCoffee(static_cast<CoffeeType>(i));
+                if (i > 0) line += ',';
+                line += std::to_string(i + 1);
+                line += ':';
+                line += coffee->getName();
+                line += ':';
+                appendPrice(line, coffee->getPrice());
+            }
+            line += '\n';
+            return line;
+        }();
+        out += menu;
+    }
+};
+
+// A machine shared between sessions. The holder owns the pending selection
+// until it pays or cancels, so two clients can never interleave one order.
+struct MachineLease {
+    CoffeeMachine* machine = nullptr;
+    uint64_t holder = 0;
+};
+
+// One client's view of a machine: applies protocol commands through the
+// normal State Pattern entry points and reports the outcome compactly.
+class OrderSession {
+private:
+    uint64_t sessionId;
+    MachineLease* lease;
+
+    bool holdsSelection() const { return lease->holder == sessionId; }
+
+    void releaseIfIdle() {
+        if (lease->machine->getSelectedCoffee() == nullptr) {
+            lease->holder = 0;
+        }
+    }
+
+    void select(const OrderCommand& cmd, std::string& out) {
+        CoffeeMachine* machine = lease->machine;
+        releaseIfIdle(); // the holder's selection may have timed out
+        if (!machine->getIsOperational()) {
+            out += "ERR MAINTENANCE\n";
+            return;
+        }
+        if ((lease->holder != 0 && !holdsSelection()) ||
+            machine->getSelectedCoffee() != nullptr) {
+            out += "ERR BUSY\n";
+            return;
+        }
+        if (cmd.choice < 1 || cmd.choice > static_cast<int>(CoffeeType::COUNT)) {
+            out += "ERR INVALID\n";
+            return;
+        }
+
+        machine->selectCoffee(cmd.choice);
+
+        Coffee* coffee = machine->getSelectedCoffee();
+        if (coffee == nullptr) {
+            out += "ERR UNAVAILABLE\n";
+            return;
+        }
+        lease->holder = sessionId;
+        out += "OK ";
+        out += coffee->getName();
+        out += ' ';
+        OrderProtocol::appendPrice(out, machine->quotePrice(coffee, machine->getSelectedCoffeeType()));
+        out += '\n';
+    }
+
+    void pay(const OrderCommand& cmd, std::string& out) {
+        CoffeeMachine* machine = lease->machine;
+        if (!holdsSelection()) {
+            out += lease->holder != 0 ? "ERR BUSY\n" : "ERR NOSELECTION\n";
+            return;
+        }
+        if (machine->getSelectedCoffee() == nullptr) {
+            releaseIfIdle();
+            out += "ERR TIMEOUT\n";
+            return;
+        }
+        if (!machine->getIsOperational()) {
+            out += "ERR MAINTENANCE\n";
+            return;
+        }
+
+        std::string coffeeName = machine->getSelectedCoffee()->getName();
+        int attemptsBefore = machine->getPaymentAttempts();
+        {
+            // Build the payment inside the order's arena
+            OrderArena::Scope scope(machine->getOrderArena());
+            machine->makePayment(OrderProtocol::createPayment(cmd));
+        }
+
+        if (machine->getSelectedCoffee() == nullptr && machine->getPaymentAttempts() != attemptsBefore) {
+            releaseIfIdle();
+            out += "ERR CANCELLED\n"; // declined too many times
+        } else if (machine->getSelectedCoffee() == nullptr) {
+            releaseIfIdle();
+            out += "OK ";
+            out += coffeeName;
+            out += '\n';
+        } else {
+            out += "ERR DECLINED\n";
+        }
+    }
+
+public:
+    OrderSession(uint64_t id, MachineLease* machineLease)
+        : sessionId(id), lease(machineLease) {}
+
+    // Apply one command and append exactly one response line to out
+    void execute(const OrderCommand& cmd, std::string& out) {
+        switch (cmd.op) {
+            case OrderOp::MENU:
+                OrderProtocol::appendMenu(out);
+                break;
+
+            case OrderOp::SELECT:
+                select(cmd, out);
+                break;
+
+            case OrderOp::PAY:
+                pay(cmd, out);
+                break;
+
+            case OrderOp::CANCEL:
+                if (!holdsSelection()) {
+                    out += lease->holder != 0 ? "ERR BUSY\n" : "ERR NOSELECTION\n";
+                    break;
+                }
+                if (lease->machine->getSelectedCoffee() == nullptr) {
+                    releaseIfIdle();
+                    out += "ERR TIMEOUT\n";
+                    break;
+                }
+                lease->machine->cancelOrder();
+                releaseIfIdle();
+                out += "OK\n";
+                break;
+
+            case OrderOp::STATUS: {
+                CoffeeMachine* machine = lease->machine;
+                out += "OK ";
+                out += machine->getCurrentState()->getStateName();
+                out += machine->getIsOperational() ? " 1 " : " 0 ";
+                Coffee* coffee = machine->getSelectedCoffee();
+                out += coffee ? coffee->getName() : "-";
+                out += '\n';
+                break;
+            }
+
+            case OrderOp::REFILL:
+                for (const auto& [ingredient, amount] : Operator::getRefillAmounts()) {
+                    lease->machine->getInventory()->refillIngredient(ingredient, amount);
+                }
+                out += "OK\n";
+                break;
+
+            case OrderOp::REFILL_ONE: {
+                Inventory* inventory = lease->machine->getInventory();
+                const auto& levels = inventory->getIngredients();
+                auto it = levels.find(std::string(cmd.arg1));
+                if (it == levels.end()) {
+                    out += "ERR UNKNOWN\n";
+                    break;
+                }
+                inventory->refillIngredient(it->first, cmd.choice);
+                out += "OK ";
+                out += std::to_string(it->second);
+                out += '\n';
+                break;
+            }
+
+            case OrderOp::INVENTORY: {
+                out += "OK ";
+                bool first = true;
+                for (const auto& [ingredient, level] : lease->machine->getInventory()->getIngredients()) {
+                    if (!first) out += ',';
+                    out += ingredient;
+                    out += ':';
+                    out += std::to_string(level);
+                    first = false;
+                }
+                out += '\n';
+                break;
+            }
+
+            case OrderOp::SET_OPERATIONAL:
+                lease->machine->setOperational(cmd.choice == 1);
+                out += "OK\n";
+                break;
+
+            case OrderOp::INVALID:
+                out += "ERR BADCMD\n";
+                break;
+        }
+    }
+
+    // Abandoned sessions must not leave the machine stuck in Selecting
+    void close() {
+        if (holdsSelection()) {
+            lease->machine->cancelOrder();
+            lease->holder = 0;
+        }
+    }
+
+    uint64_t getSessionId() const { return sessionId; }
+};
+
+#endif // ORDER_PROTOCOL_HPP
@@ -0,0 +1,294 @@
+#ifndef ORDER_SERVER_HPP
+#define ORDER_SERVER_HPP
+
+#include "OrderProtocol.hpp"
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdio>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Network front end - single-threaded, non-blocking epoll server.
+// Each TCP connection is an OrderSession bound to one of the hosted machines
+// (round-robin by connection). Requests may be pipelined; every complete line
+// in a read is executed and the responses go out in a single send.
+// Session deadlines for all machines run on one TimerWheel advanced by the
+// event loop, which also sizes the epoll_wait timeout to the next deadline.
+class OrderServer {
+public:
+    struct Stats {
+        uint64_t connectionsAccepted = 0;
+        uint64_t requests = 0;
+        uint64_t bytesIn = 0;
+        uint64_t bytesOut = 0;
+    };
+
+private:
+    static constexpr size_t MAX_LINE = 4096;
+    static constexpr size_t READ_CHUNK = 64 * 1024;
+    static constexpr int MAX_EVENTS = 256;
+
+    struct Connection {
+        int fd;
+        std::string in;
+        std::string out;
+        size_t outOffset = 0;
+        bool wantWrite = false;
+        OrderSession session;
+
+        Connection(int socketFd, uint64_t id, MachineLease* lease)
+            : fd(socketFd), session(id, lease) {}
+    };
+
+    uint16_t port;
+    int listenFd;
+    int epollFd;
+    std::atomic<bool> running;
+    uint64_t nextSessionId;
+    TimerWheel timers; // outlives the machines armed on it
+    std::vector<std::unique_ptr<CoffeeMachine>> machines;
+    std::vector<MachineLease> leases;
+    std::unordered_map<int, std::unique_ptr<Connection>> connections;
+    std::vector<char> readBuffer;
+    Stats stats;
+
+    static int64_t steadyClockMillis() {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    int pollTimeoutMs() const {
+        int64_t due = timers.nextDueMs();
+        if (due == INT64_MAX) return 200;
+        return static_cast<int>(std::clamp<int64_t>(due - steadyClockMillis(), 0, 200));
+    }
+
+    // While a response backlog is pending we stop reading from the client,
+    // so a peer that never reads cannot grow our buffers without bound
+    void updateInterest(Connection& conn, bool wantWrite) {
+        if (conn.wantWrite == wantWrite) return;
+        epoll_event ev{};
+        ev.events = wantWrite ? EPOLLOUT : EPOLLIN;
+        ev.data.fd = conn.fd;
+        epoll_ctl(epollFd, EPOLL_CTL_MOD, conn.fd, &ev);
+        conn.wantWrite = wantWrite;
+    }
+
+    void closeConnection(int fd) {
+        auto it = connections.find(fd);
+        if (it == connections.end()) return;
+        it->second->session.close();
+        epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+        ::close(fd);
+        connections.erase(it);
+    }
+
+    void acceptConnections() {
+        while (true) {
+            int fd = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK);
+            if (fd < 0) {
+                if (errno == EINTR) continue;
+                return; // EAGAIN: backlog drained
+            }
+            int one = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+            uint64_t id = nextSessionId++;
+            MachineLease* lease = &leases[id % leases.size()];
+            connections[fd] = std::make_unique<Connection>(fd, id, lease);
+
+            epoll_event ev{};
+            ev.events = EPOLLIN;
+            ev.data.fd = fd;
+            epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev);
+            stats.connectionsAccepted++;
+        }
+    }
+
+    // Returns false when the connection must be closed
+    bool flush(Connection& conn) {
+        while (conn.outOffset < conn.out.size()) {
+            ssize_t n = ::send(conn.fd, conn.out.data() + conn.outOffset,
+                               conn.out.size() - conn.outOffset, MSG_NOSIGNAL);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                    updateInterest(conn, true);
+                    return true;
+                }
+                return false;
+            }
+            conn.outOffset += static_cast<size_t>(n);
+            stats.bytesOut += static_cast<uint64_t>(n);
+        }
+        conn.out.clear();
+        conn.outOffset = 0;
+        updateInterest(conn, false);
+        return true;
+    }
+
+    // Execute every complete line buffered for this connection
+    bool processInput(Connection& conn) {
+        std::string_view pending(conn.in);
+        size_t consumed = 0;
+        while (true) {
+            size_t nl = pending.find('\n', consumed);
+            if (nl == std::string_view::npos) break;
+            std::string_view line = pending.substr(consumed, nl - consumed);
+            conn.session.execute(OrderProtocol::parse(line), conn.out);
+            stats.requests++;
+            consumed = nl + 1;
+        }
+        conn.in.erase(0, consumed);
+        return conn.in.size() <= MAX_LINE;
+    }
+
+    bool handleReadable(Connection& conn) {
+        while (true) {
+            ssize_t n = ::recv(conn.fd, readBuffer.data(), readBuffer.size(), 0);
+            if (n > 0) {
+                conn.in.append(readBuffer.data(), static_cast<size_t>(n));
+                stats.bytesIn += static_cast<uint64_t>(n);
+                if (static_cast<size_t>(n) < readBuffer.size()) break;
+                continue;
+            }
+            if (n == 0) return false; // peer closed
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+            return false;
+        }
+        if (!processInput(conn)) return false;
+        return flush(conn);
+    }
+
+public:
+    OrderServer(uint16_t listenPort, size_t machineCount)
+        : port(listenPort), listenFd(-1), epollFd(-1), running(false),
+          nextSessionId(1), timers(10, steadyClockMillis()), readBuffer(READ_CHUNK) {
+        if (machineCount == 0) machineCount = 1;
+        machines.reserve(machineCount);
+        leases.resize(machineCount);
+        for (size_t i = 0; i < machineCount; ++i) {
+            machines.push_back(CoffeeMachine::create());
+            leases[i].machine = machines.back().get();
+        }
+    }
+
+    ~OrderServer() {
+        for (auto& [fd, conn] : connections) {
+            conn->session.close();
+            ::close(fd);
+        }
+        if (epollFd >= 0) ::close(epollFd);
+        if (listenFd >= 0) ::close(listenFd);
+    }
+
+    CoffeeMachine* getMachine(size_t index) { return machines[index].get(); }
+
+    // Cancel unpaid selections (and release their ingredient holds) on every
+    // hosted machine once the session's deadline passes
+    void enableSessionTimeouts(SessionTimeoutConfig config) {
+        for (auto& machine : machines) machine->attachTimers(&timers, config);
+    }
+
+    OrderServer(const OrderServer&) = delete;
+    OrderServer& operator=(const OrderServer&) = delete;
+
+    // Bind, listen and set up epoll. Reports failures via perror.
+    bool start() {
+        listenFd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+        if (listenFd < 0) {
+            std::perror("socket");
+            return false;
+        }
+        int one = 1;
+        setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_ANY);
+        addr.sin_port = htons(port);
+        if (bind(listenFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+            std::perror("bind");
+            return false;
+        }
+        if (listen(listenFd, SOMAXCONN) < 0) {
+            std::perror("listen");
+            return false;
+        }
+
+        epollFd = epoll_create1(0);
+        if (epollFd < 0) {
+            std::perror("epoll_create1");
+            return false;
+        }
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.fd = listenFd;
+        if (epoll_ctl(epollFd, EPOLL_CTL_ADD, listenFd, &ev) < 0) {
+            std::perror("epoll_ctl");
+            return false;
+        }
+        running = true;
+        return true;
+    }
+
+    // Event loop; returns after stop() is called
+    void run() {
+        epoll_event events[MAX_EVENTS];
+        while (running) {
+            int n = epoll_wait(epollFd, events, MAX_EVENTS, pollTimeoutMs());
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                std::perror("epoll_wait");
+                break;
+            }
+            timers.advance(steadyClockMillis());
+            for (int i = 0; i < n; ++i) {
+                int fd = events[i].data.fd;
+                if (fd == listenFd) {
+                    acceptConnections();
+                    continue;
+                }
+                auto it = connections.find(fd);
+                if (it == connections.end()) continue;
+                Connection& conn = *it->second;
+
+                bool keep = true;
+                if (events[i].events & (EPOLLERR | EPOLLHUP)) {
+                    keep = false;
+                } else {
+                    if (events[i].events & EPOLLOUT) {
+                        keep = flush(conn);
+                        // Backlog drained: run any lines buffered while paused
+                        if (keep && !conn.wantWrite && !conn.in.empty()) {
+                            keep = processInput(conn) && flush(conn);
+                        }
+                    }
+                    if (keep && (events[i].events & EPOLLIN)) keep = handleReadable(conn);
+                }
+                if (!keep) closeConnection(fd);
+            }
+        }
+    }
+
+    // Safe to call from a signal handler
+    void stop() { running = false; }
+
+    const Stats& getStats() const { return stats; }
+    const TimerWheel::Stats& getTimerStats() const { return timers.getStats(); }
+    size_t getMachineCount() const { return machines.size(); }
+    size_t getConnectionCount() const { return connections.size(); }
+};
+
+#endif // ORDER_SERVER_HPP
@@ -0,0 +1,335 @@
+#ifndef ORDER_WORKFLOW_HPP
+#define ORDER_WORKFLOW_HPP
+
+#if !defined(__cpp_impl_coroutine)
+#error "OrderWorkflow.hpp needs C++20 coroutines (build with -std=c++20)"
+#endif
+
+#include <chrono>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <new>
+#include <optional>
+#include <queue>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Coroutine building blocks for order workflows. An order is written as one
+// straight-line coroutine - select, wait for payment, authorise, brew,
+// dispense - and every wait suspends it instead of blocking a thread:
+//
+//   OrderTask order(OrderExecutor& ex, Kiosk& kiosk) {
+//       auto held = co_await kiosk.lock.lock();          // queue for the kiosk
+//       auto paid = co_await payment.wait(30000);         // user, with timeout
+//       co_await ex.sleep(brewSeconds * 1000);            // brew timer
+//   }
+//
+// OrderExecutor runs everything on the calling thread: a ready queue plus a
+// timer heap. A suspended order is just its coroutine frame (a few hundred
+// bytes), so one controller thread can keep thousands in flight. With a
+// simulated clock the executor jumps straight to the next timer, which
+// turns hours of kiosk time into milliseconds for fleet simulations.
+
+class OrderExecutor;
+
+// Fire-and-forget coroutine; started by OrderExecutor::spawn(), frees its
+// own frame when it finishes. Frame allocations are counted so callers can
+// see how many orders are in flight and what each one costs.
+class OrderTask {
+public:
+    struct FrameStats {
+        uint64_t live = 0;
+        uint64_t peak = 0;
+        uint64_t created = 0;
+        uint64_t bytes = 0;     // currently allocated
+        uint64_t peakBytes = 0;
+    };
+
+    struct promise_type {
+        OrderTask get_return_object() {
+            return OrderTask(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+
+        static void* operator new(std::size_t size) {
+            FrameStats& stats = frameStats();
+            stats.live++;
+            stats.created++;
+            stats.bytes += size;
+            if (stats.live > stats.peak) stats.peak = stats.live;
+            if (stats.bytes > stats.peakBytes) stats.peakBytes = stats.bytes;
+            return ::operator new(size);
+        }
+
+        static void operator delete(void* frame, std::size_t size) {
+            FrameStats& stats = frameStats();
+            stats.live--;
+            stats.bytes -= size;
+            ::operator delete(frame);
+        }
+    };
+
+    explicit OrderTask(std::coroutine_handle<promise_type> frame) : handle(frame) {}
+
+    // Per controller thread
+    static FrameStats& frameStats() {
+        static thread_local FrameStats stats;
+        return stats;
+    }
+
+private:
+    friend class OrderExecutor;
+    std::coroutine_handle<promise_type> handle;
+};
+
+// Something a timer can notify instead of resuming a coroutine directly
+class TimeoutTarget {
+public:
+    virtual ~TimeoutTarget() = default;
+    virtual void onTimeout() = 0;
+};
+
+class OrderExecutor {
+public:
+    struct Stats {
+        uint64_t resumptions = 0;
+        uint64_t timersFired = 0;
+        uint64_t timersCancelled = 0;
+        size_t peakTimers = 0;
+    };
+
+private:
+    struct Timer {
+        int64_t due;
+        uint64_t id;
+        std::coroutine_handle<> handle; // resumed when due, or
+        TimeoutTarget* target;          // notified when due
+
+        bool operator>(const Timer& other) const {
+            return due != other.due ? due > other.due : id > other.id;
+        }
+    };
+
+    bool simulated;
+    int64_t simulatedNow = 0;
+    std::deque<std::coroutine_handle<>> ready;
+    std::priority_queue<Timer, std::vector<Timer>, std::greater<Timer>> timers;
+    std::unordered_map<uint64_t, TimeoutTarget*> armedTimeouts; // cancellable ones
+    uint64_t nextTimerId = 1;
+    Stats stats;
+
+    static int64_t steadyClockMillis() {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    void fire(const Timer& timer) {
+        if (timer.target) {
+            auto it = armedTimeouts.find(timer.id);
+            if (it == armedTimeouts.end()) return; // cancelled
+            armedTimeouts.erase(it);
+            stats.timersFired++;
+            timer.target->onTimeout();
+        } else {
+            stats.timersFired++;
+            ready.push_back(timer.handle);
+        }
+    }
+
+public:
+    // Simulated time starts at 0 and only moves when nothing is ready
+    explicit OrderExecutor(bool simulatedClock = true) : simulated(simulatedClock) {}
+
+    OrderExecutor(const OrderExecutor&) = delete;
+    OrderExecutor& operator=(const OrderExecutor&) = delete;
+
+    int64_t now() const { return simulated ? simulatedNow : steadyClockMillis(); }
+
+    void spawn(OrderTask task) { ready.push_back(task.handle); }
+    void schedule(std::coroutine_handle<> handle) { ready.push_back(handle); }
+
+    void resumeAt(int64_t due, std::coroutine_handle<> handle) {
+        timers.push({due, nextTimerId++, handle, nullptr});
+        if (timers.size() > stats.peakTimers) stats.peakTimers = timers.size();
+    }
+
+    // Cancellable notification; returns the id for cancelTimeout()
+    uint64_t armTimeout(int64_t due, TimeoutTarget* target) {
+        uint64_t id = nextTimerId++;
+        armedTimeouts.emplace(id, target);
+        timers.push({due, id, nullptr, target});
+        if (timers.size() > stats.peakTimers) stats.peakTimers = timers.size();
+        return id;
+    }
+
+    void cancelTimeout(uint64_t id) {
+        if (armedTimeouts.erase(id)) stats.timersCancelled++;
+    }
+
+    // co_await ex.sleep(ms) / ex.sleepUntil(t)
+    struct SleepAwaiter {
+        OrderExecutor& executor;
+        int64_t due;
+
+        bool await_ready() const noexcept { return due <= executor.now(); }
+        void await_suspend(std::coroutine_handle<> handle) { executor.resumeAt(due, handle); }
+        void await_resume() const noexcept {}
+    };
+
+    SleepAwaiter sleepUntil(int64_t due) { return {*this, due}; }
+    SleepAwaiter sleep(int64_t ms) { return {*this, now() + ms}; }
+
+    // Run until no coroutine is ready and no timer is pending
+    void run() {
+        while (true) {
+            while (!ready.empty()) {
+                std::coroutine_handle<> next = ready.front();
+                ready.pop_front();
+                stats.resumptions++;
+                next.resume();
+            }
+            if (timers.empty()) break;
+
+            int64_t due = timers.top().due;
+            if (simulated) {
+                if (due > simulatedNow) simulatedNow = due;
+            } else if (due > steadyClockMillis()) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(due - steadyClockMillis()));
+            }
+            int64_t current = now();
+            while (!timers.empty() && timers.top().due <= current) {
+                Timer timer = timers.top();
+                timers.pop();
+                fire(timer);
+            }
+        }
+    }
+
+    const Stats& getStats() const { return stats; }
+};
+
+// One-shot event with an optional timeout, e.g. "payment arrived". set()
+// from any coroutine or callback on the executor thread; the waiter gets
+// the value, or nullopt if the timeout fired first.
+template <typename T>
+class OrderSignal : public TimeoutTarget {
+private:
+    OrderExecutor& executor;
+    std::optional<T> value;
+    std::coroutine_handle<> waiter;
+    uint64_t timeoutId = 0;
+    bool settled = false;
+
+public:
+    explicit OrderSignal(OrderExecutor& ex) : executor(ex) {}
+
+    ~OrderSignal() override {
+        if (timeoutId) executor.cancelTimeout(timeoutId);
+    }
+
+    OrderSignal(const OrderSignal&) = delete;
+    OrderSignal& operator=(const OrderSignal&) = delete;
+
+    // Ignored once the waiter has been released (value or timeout)
+    void set(T result) {
+        if (settled) return;
+        settled = true;
+        value = std::move(result);
+        if (timeoutId) {
+            executor.cancelTimeout(timeoutId);
+            timeoutId = 0;
+        }
+        if (waiter) executor.schedule(waiter);
+    }
+
+    void onTimeout() override {
+        timeoutId = 0;
+        if (settled) return;
+        settled = true;
+        if (waiter) executor.schedule(waiter);
+    }
+
+    bool isSettled() const { return settled; }
+
+    struct Awaiter {
+        OrderSignal& signal;
+        int64_t timeoutMs;
+
+        bool await_ready() const noexcept { return signal.settled; }
+        void await_suspend(std::coroutine_handle<> handle) {
+            signal.waiter = handle;
+            if (timeoutMs >= 0) {
+                signal.timeoutId = signal.executor.armTimeout(signal.executor.now() + timeoutMs, &signal);
+            }
+        }
+        std::optional<T> await_resume() { return signal.value; }
+    };
+
+    // timeoutMs < 0 waits indefinitely
+    Awaiter wait(int64_t timeoutMs = -1) { return {*this, timeoutMs}; }
+};
+
+// FIFO async mutex: waiters queue as suspended coroutines, not threads.
+// co_await lock.lock() yields a Guard that unlocks when it goes out of scope.
+class AsyncLock {
+private:
+    OrderExecutor& executor;
+    bool locked = false;
+    std::deque<std::coroutine_handle<>> waiters;
+
+public:
+    explicit AsyncLock(OrderExecutor& ex) : executor(ex) {}
+
+    AsyncLock(const AsyncLock&) = delete;
+    AsyncLock& operator=(const AsyncLock&) = delete;
+
+    class Guard {
+    private:
+        AsyncLock* lock;
+
+    public:
+        explicit Guard(AsyncLock* held) : lock(held) {}
+        Guard(Guard&& other) noexcept : lock(other.lock) { other.lock = nullptr; }
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+        ~Guard() {
+            if (lock) lock->unlock();
+        }
+    };
+
+    struct Awaiter {
+        AsyncLock& mutex;
+
+        bool await_ready() noexcept {
+            if (mutex.locked) return false;
+            mutex.locked = true;
+            return true;
+        }
+        void await_suspend(std::coroutine_handle<> handle) { mutex.waiters.push_back(handle); }
+        Guard await_resume() noexcept { return Guard(&mutex); }
+    };
+
+    Awaiter lock() { return {*this}; }
+
+    // Ownership passes straight to the next waiter, in arrival order
+    void unlock() {
+        if (waiters.empty()) {
+            locked = false;
+            return;
+        }
+        std::coroutine_handle<> next = waiters.front();
+        waiters.pop_front();
+        executor.schedule(next);
+    }
+
+    size_t getWaiterCount() const { return waiters.size(); }
+};
+
+#endif // ORDER_WORKFLOW_HPP
@@ -1,17 +1,26 @@
 #ifndef PAYMENT_STRATEGY_HPP
 #define PAYMENT_STRATEGY_HPP
 
+#include "Money.hpp"
+#include "OrderArena.hpp"
 #include <string>
+#include <string_view>
+#include <memory_resource>
 #include <iostream>
 #include <iomanip>
 
 // Strategy Pattern - Defines a family of algorithms (payment methods)
 // Demonstrates Abstraction and Polymorphism (OOP)
-class PaymentStrategy {
+// Payments and their strings live in the current order's arena
+class PaymentStrategy : public ArenaAllocated {
 public:
     virtual ~PaymentStrategy() = default;
     virtual bool pay(double amount) = 0;
-    virtual std::string getPaymentMethod() const = 0;
+    // Both views stay valid while the payment lives, so a receipt can copy
+    // them straight into its batch buffer
+    virtual std::string_view getPaymentMethod() const = 0;
+    // Account shown on receipts, never the full card number; empty for cash
+    virtual std::string_view getMaskedReference() const { return std::string_view(); }
 };
 
 // Concrete Strategy - Cash Payment
@@ -25,20 +34,18 @@ public:
     bool pay(double amount) override {
         if (cashInserted >= amount) {
             double change = cashInserted - amount;
-            std::cout << std::fixed << std::setprecision(2);
-            std::cout << "Payment of $" << amount << " accepted via Cash.\n";
+            std::cout << "Payment of $" << Dollars{amount} << " accepted via Cash.\n";
             if (change > 0) {
-                std::cout << "Change returned: $" << change << "\n";
+                std::cout << "Change returned: $" << Dollars{change} << "\n";
             }
             return true;
         }
-        std::cout << std::fixed << std::setprecision(2);
-        std::cout << "Insufficient cash. Required: $" << amount
-                  << ", Inserted: $" << cashInserted << "\n";
+        std::cout << "Insufficient cash. Required: $" << Dollars{amount}
+                  << ", Inserted: $" << Dollars{cashInserted} << "\n";
         return false;
     }
 
-    std::string getPaymentMethod() const override {
+    std::string_view getPaymentMethod() const override {
         return "Cash";
     }
 };
@@ -46,49 +53,65 @@ public:
 // Concrete Strategy - Card Payment
 class CardPayment : public PaymentStrategy {
 private:
-    std::string cardNumber;
-    std::string pin;
+    std::pmr::string cardNumber;
+    std::pmr::string pin;
+    std::pmr::string maskedNumber;           // ****1111
 
     bool validateCard() const {
         return cardNumber.length() >= 16 && pin.length() == 4;
     }
 
 public:
-    CardPayment(const std::string& cardNum, const std::string& pinCode)
-        : cardNumber(cardNum), pin(pinCode) {}
+    CardPayment(std::string_view cardNum, std::string_view pinCode)
+        : cardNumber(cardNum, OrderArena::currentResource()),
+          pin(pinCode, OrderArena::currentResource()),
+          maskedNumber("****", OrderArena::currentResource()) {
+        if (cardNumber.length() >= 4) maskedNumber += std::string_view(cardNumber).substr(cardNumber.length() - 4);
+    }
 
     bool pay(double amount) override {
         if (validateCard()) {
-            std::cout << std::fixed << std::setprecision(2);
-            std::cout << "Payment of $" << amount << " accepted via Card (**** "
-                      << cardNumber.substr(cardNumber.length() - 4) << ").\n";
+            std::cout << "Payment of $" << Dollars{amount} << " accepted via Card (**** "
+                      << std::string_view(cardNumber).substr(cardNumber.length() - 4) << ").\n";
             return true;
         }
         std::cout << "Card payment failed. Invalid card or PIN.\n";
         return false;
     }
 
-    std::string getPaymentMethod() const override {
+    std::string_view getPaymentMethod() const override {
         return "Card";
     }
+
+    std::string_view getMaskedReference() const override {
+        return maskedNumber;
+    }
 };
 
 // Concrete Strategy - UPI Payment
 class UPIPayment : public PaymentStrategy {
 private:
-    std::string upiId;
+    std::pmr::string upiId;
+    std::pmr::string maskedId;               // first character and provider: a***@bank
 
     bool validateUPI() const {
         return upiId.find('@') != std::string::npos;
     }
 
 public:
-    explicit UPIPayment(const std::string& upi) : upiId(upi) {}
+    explicit UPIPayment(std::string_view upi)
+        : upiId(upi, OrderArena::currentResource()),
+          maskedId("***", OrderArena::currentResource()) {
+        size_t at = upiId.find('@');
+        if (at != std::string::npos && at != 0) {
+            maskedId.insert(maskedId.begin(), upiId[0]);
+            maskedId += std::string_view(upiId).substr(at);
+        }
+    }
 
     bool pay(double amount) override {
         if (validateUPI()) {
-            std::cout << std::fixed << std::setprecision(2);
-            std::cout << "Payment of $" << amount << " accepted via UPI ("
+            std::cout << "Payment of $" << Dollars{amount} << " accepted via UPI ("
                       << upiId << ").\n";
             return true;
         }
@@ -96,9 +119,13 @@ public:
         return false;
     }
 
-    std::string getPaymentMethod() const override {
+    std::string_view getPaymentMethod() const override {
         return "UPI";
     }
+
+    std::string_view getMaskedReference() const override {
+        return maskedId;
+    }
 };
 
 #endif // PAYMENT_STRATEGY_HPP
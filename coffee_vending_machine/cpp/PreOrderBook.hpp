@@ -0,0 +1,298 @@
+#ifndef PRE_ORDER_BOOK_HPP
+#define PRE_ORDER_BOOK_HPP
+
+#include "BrewQueue.hpp"
+#include "CoffeeFactory.hpp"
+#include "Inventory.hpp"
+#include "MenuConfig.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+// Pre-orders for pickup at a chosen time ("a latte at 8:15"). The day is
+// cut into fixed slots; each slot offers bookablePercent of its brewer
+// time to pre-orders and leaves the rest for walk-up customers. A booking
+// costs its drink's preparation time, or only the extra-cup share when it
+// joins a cycle with earlier bookings of the same drink in that slot (the
+// BrewQueue's coalescing rule). When the requested slot is full the
+// booking moves to the nearest slot with room, at most maxShiftSlots away
+// and earlier first, so a rush is spread over the quiet minutes around it
+// instead of queueing at the machine.
+//
+// Ingredients are reserved when a booking is accepted, so walk-up
+// selections and admission control never sell stock promised to a
+// pre-order. poll() hands a slot's bookings to the BrewQueue just in time:
+// when the current backlog, the slot's own brewing and the coalescing
+// window would finish right at the start of the pickup slot.
+//
+// Times are milliseconds on the book's clock (wall clock by default;
+// simulations replace it, as with BrewQueue).
+
+struct PreOrderConfig {
+    int64_t slotMs = 300000;           // pickup slot length
+    int bookablePercent = 60;          // brewer time per slot open to pre-orders
+    int maxShiftSlots = 2;             // how far a full slot may push a booking
+    int64_t minLeadMs = 600000;        // book at least this far ahead
+    int64_t horizonMs = 86400000;      // and at most this far
+};
+
+enum class PreOrderRefusal { NONE, TOO_SOON, TOO_FAR, STOCK, FULL };
+
+struct PreOrderResult {
+    PreOrderRefusal refusal = PreOrderRefusal::NONE;
+    uint64_t bookingId = 0;
+    int64_t pickupMs = 0;              // start of the booked slot
+    int64_t shiftMs = 0;               // booked slot minus requested slot
+
+    bool accepted() const { return refusal == PreOrderRefusal::NONE; }
+};
+
+class PreOrderBook {
+public:
+    using Config = PreOrderConfig;
+    using TimeSource = int64_t (*)();
+    // Called as a booking goes to the brew queue, with its order number
+    using ReleaseHook = void (*)(void* context, uint64_t bookingId, uint64_t orderId);
+
+    struct Stats {
+        uint64_t requested = 0;
+        uint64_t booked = 0;
+        uint64_t shifted = 0;
+        int64_t shiftMsTotal = 0;      // absolute
+        uint64_t refusedTime = 0;      // too soon or too far ahead
+        uint64_t refusedStock = 0;
+        uint64_t refusedFull = 0;
+        uint64_t cancelled = 0;
+        uint64_t released = 0;
+        int64_t peakSlotWorkMs = 0;
+    };
+
+    struct Booking {
+        CoffeeType type;
+        MenuHandle menu;
+        int64_t slot;
+        int64_t requestedMs;
+        uint64_t orderId;              // 0 until released
+    };
+
+private:
+    static constexpr int TYPES = static_cast<int>(CoffeeType::COUNT);
+
+    struct Slot {
+        int cups[TYPES] = {};
+        std::vector<uint64_t> booked;
+        std::vector<uint64_t> waiting; // booked, not yet released
+    };
+
+    Inventory* inventory;
+    BrewQueue* queue;
+    Config config;
+    TimeSource clock;
+    ReleaseHook releaseHook = nullptr;
+    void* releaseContext = nullptr;
+    int64_t prepMs[TYPES];
+    std::map<int64_t, Slot> slots;     // by slot number
+    std::unordered_map<uint64_t, Booking> bookings;
+    uint64_t nextBookingId = 1;
+    Stats stats;
+
+    static int64_t wallClockMillis() {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+
+    static const Recipe& recipeFor(const Booking& booking) {
+        return booking.menu ? booking.menu->item(booking.type).recipe : Inventory::getRecipe(booking.type);
+    }
+
+    int64_t slotStart(int64_t slot) const { return slot * config.slotMs; }
+    int64_t capacityMs() const { return config.slotMs * config.bookablePercent / 100; }
+
+    // Brewer time for a slot's bookings, grouped into cycles of one drink
+    // (built-in preparation times)
+    int64_t workMs(const int cups[TYPES]) const {
+        const BrewQueueConfig& brew = queue->getConfig();
+        int64_t total = 0;
+        for (int t = 0; t < TYPES; ++t) {
+            if (cups[t] == 0) continue;
+            int cycles = (cups[t] + brew.maxCupsPerCycle - 1) / brew.maxCupsPerCycle;
+            total += cycles * prepMs[t] + (cups[t] - cycles) * (prepMs[t] * brew.extraCupPercent / 100);
+        }
+        return total;
+    }
+
+    int64_t workWith(int64_t slot, CoffeeType type) const {
+        int cups[TYPES] = {};
+        auto it = slots.find(slot);
+        if (it != slots.end()) std::copy(std::begin(it->second.cups), std::end(it->second.cups), cups);
+        cups[static_cast<int>(type)]++;
+        return workMs(cups);
+    }
+
+    // When a slot's bookings must go to the brewer to be ready at its start
+    int64_t releaseAt(int64_t slot, const Slot& entry) const {
+        return slotStart(slot) - queue->estimateBacklogMs() - workMs(entry.cups) - queue->getConfig().windowMs;
+    }
+
+    void release(uint64_t bookingId) {
+        Booking& booking = bookings[bookingId];
+        inventory->releaseReservation(recipeFor(booking)); // the queue reserves it again
+        booking.orderId = queue->enqueue(booking.type, booking.menu);
+        stats.released++;
+        if (releaseHook) releaseHook(releaseContext, bookingId, booking.orderId);
+    }
+
+public:
+    PreOrderBook(Inventory* machineInventory, BrewQueue* brewQueue, Config bookConfig = Config())
+        : inventory(machineInventory), queue(brewQueue), config(bookConfig), clock(&wallClockMillis) {
+        if (config.slotMs < 1000) config.slotMs = 1000;
+        config.bookablePercent = std::clamp(config.bookablePercent, 1, 100);
+        if (config.maxShiftSlots < 0) config.maxShiftSlots = 0;
+        for (int t = 0; t < TYPES; ++t) {
+            prepMs[t] = static_cast<int64_t>(CoffeeFactory::createCoffee(static_cast<CoffeeType>(t))
+                                                 ->getPreparationTime()) * 1000;
+        }
+    }
+
+    PreOrderBook(const PreOrderBook&) = delete;
+    PreOrderBook& operator=(const PreOrderBook&) = delete;
+
+    void setTimeSource(TimeSource source) { clock = source ? source : &wallClockMillis; }
+    void setReleaseHook(ReleaseHook hook, void* context) {
+        releaseHook = hook;
+        releaseContext = context;
+    }
+
+    // Book a drink for pickup around pickupMs. With a menu handle the
+    // order keeps that menu version (see BrewQueue::enqueue).
+    PreOrderResult book(CoffeeType type, int64_t pickupMs, MenuHandle menu = MenuHandle()) {
+        PreOrderResult result;
+        stats.requested++;
+        int64_t now = clock();
+        if (pickupMs < now + config.minLeadMs || pickupMs > now + config.horizonMs) {
+            result.refusal = pickupMs < now + config.minLeadMs ? PreOrderRefusal::TOO_SOON : PreOrderRefusal::TOO_FAR;
+            stats.refusedTime++;
+            return result;
+        }
+        Booking booking{type, std::move(menu), 0, pickupMs, 0};
+        const Recipe& recipe = recipeFor(booking);
+        if (inventory->availableCups(recipe) < 1) {
+            result.refusal = PreOrderRefusal::STOCK;
+            stats.refusedStock++;
+            return result;
+        }
+
+        int64_t requested = pickupMs / config.slotMs;
+        int64_t chosen = requested;
+        bool found = false;
+        for (int distance = 0; distance <= config.maxShiftSlots && !found; ++distance) {
+            for (int64_t slot : {requested - distance, requested + distance}) {
+                if (slotStart(slot) < now + config.minLeadMs) continue;
+                if (workWith(slot, type) <= capacityMs()) {
+                    chosen = slot;
+                    found = true;
+                    break;
+                }
+            }
+        }
+        if (!found) {
+            result.refusal = PreOrderRefusal::FULL;
+            stats.refusedFull++;
+            return result;
+        }
+
+        inventory->reserveIngredients(recipe);
+        booking.slot = chosen;
+        uint64_t id = nextBookingId++;
+        bookings.emplace(id, std::move(booking));
+        Slot& entry = slots[chosen];
+        entry.cups[static_cast<int>(type)]++;
+        entry.booked.push_back(id);
+        entry.waiting.push_back(id);
+        stats.peakSlotWorkMs = std::max(stats.peakSlotWorkMs, workMs(entry.cups));
+
+        result.bookingId = id;
+        result.pickupMs = slotStart(chosen);
+        result.shiftMs = (chosen - requested) * config.slotMs;
+        stats.booked++;
+        if (chosen != requested) {
+            stats.shifted++;
+            stats.shiftMsTotal += std::abs(result.shiftMs);
+        }
+        return result;
+    }
+
+    // Give up a booking that has not gone to the brewer yet
+    bool cancel(uint64_t bookingId) {
+        auto it = bookings.find(bookingId);
+        if (it == bookings.end() || it->second.orderId != 0) return false;
+        Slot& entry = slots[it->second.slot];
+        entry.cups[static_cast<int>(it->second.type)]--;
+        entry.booked.erase(std::find(entry.booked.begin(), entry.booked.end(), bookingId));
+        entry.waiting.erase(std::find(entry.waiting.begin(), entry.waiting.end(), bookingId));
+        inventory->releaseReservation(recipeFor(it->second));
+        bookings.erase(it);
+        stats.cancelled++;
+        return true;
+    }
+
+    // Release the bookings that are due to the brew queue; returns how
+    // many. Call whenever time advances, before BrewQueue::poll().
+    int poll() {
+        int64_t now = clock();
+        int released = 0;
+        for (auto it = slots.begin(); it != slots.end();) {
+            Slot& entry = it->second;
+            if (!entry.waiting.empty()) {
+                // Slots further out are due later: work never exceeds a slot
+                if (releaseAt(it->first, entry) > now) break;
+                for (uint64_t id : entry.waiting) release(id);
+                released += static_cast<int>(entry.waiting.size());
+                entry.waiting.clear();
+            }
+            // Forget a slot once its pickup window is over
+            if (slotStart(it->first + 1) <= now) {
+                for (uint64_t id : entry.booked) bookings.erase(id);
+                it = slots.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        return released;
+    }
+
+    // Earliest time poll() has a booking to release, or INT64_MAX
+    int64_t nextDueTime() const {
+        for (const auto& [slot, entry] : slots) {
+            if (!entry.waiting.empty()) return releaseAt(slot, entry);
+        }
+        return INT64_MAX;
+    }
+
+    // Brewer time booked in the slot containing timeMs, and the most it takes
+    int64_t bookedMs(int64_t timeMs) const {
+        auto it = slots.find(timeMs / config.slotMs);
+        return it == slots.end() ? 0 : workMs(it->second.cups);
+    }
+    int64_t getSlotCapacityMs() const { return capacityMs(); }
+
+    const Booking* getBooking(uint64_t bookingId) const {
+        auto it = bookings.find(bookingId);
+        return it == bookings.end() ? nullptr : &it->second;
+    }
+
+    size_t getWaitingCount() const {
+        size_t waiting = 0;
+        for (const auto& [slot, entry] : slots) waiting += entry.waiting.size();
+        return waiting;
+    }
+
+    const Config& getConfig() const { return config; }
+    const Stats& getStats() const { return stats; }
+};
+
+#endif // PRE_ORDER_BOOK_HPP
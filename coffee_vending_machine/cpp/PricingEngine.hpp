@@ -0,0 +1,347 @@
+#ifndef PRICING_ENGINE_HPP
+#define PRICING_ENGINE_HPP
+
+#include "CoffeeFactory.hpp"
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstdint>
+#include <ctime>
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Time-of-day / per-site pricing. Rules are written declaratively, one per
+// line, and applied in order on top of a base price - the Coffee classes'
+// price, or the caller's (a machine passes its pinned menu version's):
+//
+//   # action  drinks            sites  window        value
+//   price     Mocha             *      *             4.25   # new base price
+//   percent   *                 *      15:00-17:00   -20    # happy hour
+//   add       Latte,Cappuccino  1,2    08:00-10:00   0.50   # peak surcharge
+//
+// drinks: '*' or a comma list of names or menu numbers; sites: '*' or a
+// comma list of site ids (0-based); window: '*' or HH:MM-HH:MM (may wrap past
+// midnight, snapped to 15-minute buckets). A 'price' rule replaces the base
+// outright; 'percent' and 'add' adjust whatever came before. The result is
+// rounded to cents (and floored at zero) once, after every rule.
+//
+// compile() folds each cell's rules into one adjustment, price = base *
+// scale + offset, keeps them in a dense [CoffeeType][bucket][site] table
+// and publishes it with one atomic pointer store. Tables are immutable once
+// published and a lookup never keeps one past its return, so a replaced
+// table needs no pins, only a grace period. Each thread counts its lookups
+// in its own cache-line sized reader slot (shared only once more than
+// READER_SLOTS threads have priced), under one of two phases: a lookup is
+// one array index plus an increment and decrement no other core sees - no
+// lock, no allocation. compile() frees the tables replaced before the last
+// phase flip once no slot counts a lookup under the previous phase, then
+// flips again. New lookups always count under the current phase, so a busy
+// fleet cannot hold replaced tables back for more than two compiles.
+class PricingEngine {
+public:
+    static constexpr int BUCKET_MINUTES = 15;
+    static constexpr int BUCKETS_PER_DAY = 24 * 60 / BUCKET_MINUTES;
+    static constexpr int TYPES = static_cast<int>(CoffeeType::COUNT);
+
+    // Minutes since local midnight
+    using TimeSource = int (*)();
+
+    // The rules for one drink, bucket and site, applied to a base price
+    struct Adjustment {
+        double scale = 1.0;
+        double offset = 0.0;
+
+        double apply(double base) const { return std::max(0.0, roundCents(base * scale + offset)); }
+    };
+
+    struct PriceTable {
+        uint64_t generation = 0;
+        uint32_t sites = 0;
+        double basePrices[TYPES] = {};         // the Coffee classes' prices
+        std::vector<Adjustment> adjustments;   // ((type * BUCKETS_PER_DAY) + bucket) * sites + site
+
+        const Adjustment& at(int type, int bucket, uint32_t site) const {
+            return adjustments[(static_cast<size_t>(type) * BUCKETS_PER_DAY + bucket) * sites + site];
+        }
+    };
+
+    // Threads are spread over the slots round robin; threads sharing a
+    // slot stay correct, they only share its cache line again
+    static constexpr size_t READER_SLOTS = 16;
+
+private:
+    struct alignas(64) ReaderSlot {
+        std::atomic<uint64_t> inside[2] = {};  // lookups in flight, per phase
+    };
+
+    uint32_t siteCount;
+    std::atomic<const PriceTable*> current{nullptr};
+    std::atomic<unsigned> phase{0};
+    mutable ReaderSlot readers[READER_SLOTS];
+    std::vector<std::unique_ptr<PriceTable>> draining;  // replaced before the last flip
+    std::vector<std::unique_ptr<PriceTable>> retired;   // replaced since
+    std::unique_ptr<PriceTable> live;          // owns *current
+    std::mutex compileMutex;                   // writers only
+    std::string lastError;
+    uint64_t reclaimed = 0;
+    TimeSource clock;
+
+    static int localMinuteOfDay() {
+        // UTC offset resolved once; per-lookup localtime_r would dominate
+        static const long offsetSeconds = [] {
+            std::time_t now = std::time(nullptr);
+            std::tm local{};
+            localtime_r(&now, &local);
+            return local.tm_gmtoff;
+        }();
+        long seconds = static_cast<long>(std::chrono::duration_cast<std::chrono::seconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count()) + offsetSeconds;
+        return static_cast<int>(((seconds % 86400) + 86400) % 86400 / 60);
+    }
+
+
+    static double roundCents(double price) {
+        return std::round(price * 100.0) / 100.0;
+    }
+
+    static std::vector<std::string> splitList(const std::string& text) {
+        std::vector<std::string> items;
+        std::stringstream ss(text);
+        std::string item;
+        while (std::getline(ss, item, ',')) items.push_back(item);
+        return items;
+    }
+
+    static bool parseDrinks(const std::string& text, bool mask[TYPES]) {
+        for (int t = 0; t < TYPES; ++t) mask[t] = text == "*";
+        if (text == "*") return true;
+        for (const auto& item : splitList(text)) {
+            bool found = false;
+            for (int t = 0; t < TYPES; ++t) {
+                std::string name = CoffeeFactory::getCoffeeTypeName(static_cast<CoffeeType>(t));
+                if (item == name || item == std::to_string(t + 1)) {
+                    mask[t] = true;
+                    found = true;
+                }
+            }
+            if (!found) return false;
+        }
+        return true;
+    }
+
+    bool parseSites(const std::string& text, std::vector<bool>& mask) const {
+        mask.assign(siteCount, text == "*");
+        if (text == "*") return true;
+        for (const auto& item : splitList(text)) {
+            char* end = nullptr;
+            long site = std::strtol(item.c_str(), &end, 10);
+            if (item.empty() || *end != '\0' || site < 0 || site >= static_cast<long>(siteCount)) {
+                return false;
+            }
+            mask[static_cast<size_t>(site)] = true;
+        }
+        return true;
+    }
+
+    static bool parseClock(const std::string& text, int& minutes) {
+        int hours = 0;
+        int mins = 0;
+        char colon = 0;
+        std::stringstream ss(text);
+        if (!(ss >> hours >> colon >> mins) || colon != ':' || !ss.eof() ||
+            hours < 0 || hours > 24 || mins < 0 || mins > 59 || hours * 60 + mins > 24 * 60) {
+            return false;
+        }
+        minutes = hours * 60 + mins;
+        return true;
+    }
+
+    static bool parseWindow(const std::string& text, bool mask[BUCKETS_PER_DAY]) {
+        for (int b = 0; b < BUCKETS_PER_DAY; ++b) mask[b] = text == "*";
+        if (text == "*") return true;
+        size_t dash = text.find('-');
+        int from = 0;
+        int to = 0;
+        if (dash == std::string::npos || !parseClock(text.substr(0, dash), from) ||
+            !parseClock(text.substr(dash + 1), to)) {
+            return false;
+        }
+        int first = from / BUCKET_MINUTES % BUCKETS_PER_DAY;
+        int last = to / BUCKET_MINUTES % BUCKETS_PER_DAY; // exclusive
+        int count = (last - first + BUCKETS_PER_DAY) % BUCKETS_PER_DAY;
+        if (count == 0) count = BUCKETS_PER_DAY; // e.g. 00:00-24:00
+        for (int i = 0; i < count; ++i) {
+            mask[(first + i) % BUCKETS_PER_DAY] = true;
+        }
+        return true;
+    }
+
+    bool fail(int lineNumber, const std::string& message) {
+        lastError = "line " + std::to_string(lineNumber) + ": " + message;
+        return false;
+    }
+
+    static size_t readerSlot() {
+        static std::atomic<size_t> nextSlot{0};
+        thread_local size_t slot = nextSlot.fetch_add(1, std::memory_order_relaxed) % READER_SLOTS;
+        return slot;
+    }
+
+    // Brackets a lookup: the table it loads stays allocated until release()
+    unsigned enter(ReaderSlot& slot) const {
+        unsigned p = phase.load(std::memory_order_relaxed);
+        slot.inside[p].fetch_add(1, std::memory_order_seq_cst);
+        return p;
+    }
+
+    static void release(ReaderSlot& slot, unsigned p) {
+        slot.inside[p].fetch_sub(1, std::memory_order_release);
+    }
+
+    // Once the lookups counted under the previous phase have finished,
+    // nothing can still hold a draining table: free those, move the
+    // tables retired since into draining and flip the phase. Skipped (not
+    // waited for) while such a lookup is in flight; the next compile
+    // retries, and lookups started meanwhile count under the new phase.
+    void reclaim() {
+        unsigned previous = phase.load(std::memory_order_relaxed) ^ 1u;
+        for (const ReaderSlot& slot : readers) {
+            if (slot.inside[previous].load(std::memory_order_seq_cst) != 0) return;
+        }
+        reclaimed += draining.size();
+        draining.clear();
+        if (retired.empty()) return;
+        draining.swap(retired);
+        phase.store(previous, std::memory_order_seq_cst);
+    }
+
+public:
+    explicit PricingEngine(uint32_t sites = 1)
+        : siteCount(sites > 0 ? sites : 1), clock(&localMinuteOfDay) {
+        compile("");
+    }
+
+    PricingEngine(const PricingEngine&) = delete;
+    PricingEngine& operator=(const PricingEngine&) = delete;
+
+    // Replace the clock (simulations, tests of a given hour)
+    void setTimeSource(TimeSource source) { clock = source ? source : &localMinuteOfDay; }
+
+    // Compile rules and swap them in atomically. On a syntax error nothing
+    // changes and getLastError() says which line was rejected.
+    bool compile(const std::string& rules) {
+        std::lock_guard<std::mutex> guard(compileMutex);
+        auto table = std::make_unique<PriceTable>();
+        table->sites = siteCount;
+        table->adjustments.resize(static_cast<size_t>(TYPES) * BUCKETS_PER_DAY * siteCount);
+        for (int t = 0; t < TYPES; ++t) {
+            table->basePrices[t] = CoffeeFactory::createCoffee(static_cast<CoffeeType>(t))->getPrice();
+        }
+
+        std::stringstream input(rules);
+        std::string line;
+        int lineNumber = 0;
+        while (std::getline(input, line)) {
+            lineNumber++;
+            line = line.substr(0, line.find('#'));
+            std::stringstream fields(line);
+            std::string action, drinks, sites, window;
+            double value = 0.0;
+            if (!(fields >> action)) continue; // blank / comment
+            if (!(fields >> drinks >> sites >> window >> value)) {
+                return fail(lineNumber, "expected: action drinks sites window value");
+            }
+            std::string extra;
+            if (fields >> extra) return fail(lineNumber, "unexpected '" + extra + "'");
+            if (action != "price" && action != "percent" && action != "add") {
+                return fail(lineNumber, "unknown action '" + action + "'");
+            }
+
+            bool drinkMask[TYPES];
+            bool bucketMask[BUCKETS_PER_DAY];
+            std::vector<bool> siteMask;
+            if (!parseDrinks(drinks, drinkMask)) return fail(lineNumber, "unknown drink in '" + drinks + "'");
+            if (!parseSites(sites, siteMask)) return fail(lineNumber, "bad site list '" + sites + "'");
+            if (!parseWindow(window, bucketMask)) return fail(lineNumber, "bad window '" + window + "'");
+
+            for (int t = 0; t < TYPES; ++t) {
+                if (!drinkMask[t]) continue;
+                for (int b = 0; b < BUCKETS_PER_DAY; ++b) {
+                    if (!bucketMask[b]) continue;
+                    for (uint32_t s = 0; s < siteCount; ++s) {
+                        if (!siteMask[s]) continue;
+                        Adjustment& cell = table->adjustments[(static_cast<size_t>(t) * BUCKETS_PER_DAY + b) * siteCount + s];
+                        if (action == "price") {
+                            cell.scale = 0.0;
+                            cell.offset = value;
+                        } else if (action == "percent") {
+                            cell.scale *= 1.0 + value / 100.0;
+                            cell.offset *= 1.0 + value / 100.0;
+                        } else {
+                            cell.offset += value;
+                        }
+                    }
+                }
+            }
+        }
+
+        table->generation = live ? live->generation + 1 : 0;
+        current.store(table.get(), std::memory_order_seq_cst);
+        if (live) retired.push_back(std::move(live));
+        live = std::move(table);
+        lastError.clear();
+        reclaim();
+        return true;
+    }
+
+    static int bucketOf(int minuteOfDay) {
+        return (minuteOfDay / BUCKET_MINUTES) % BUCKETS_PER_DAY;
+    }
+
+    // Lock-free lookups. A negative base means the Coffee classes' price.
+    double priceAt(CoffeeType type, int bucket, uint32_t site, double base = -1.0) const {
+        ReaderSlot& slot = readers[readerSlot()];
+        unsigned p = enter(slot);
+        const PriceTable* table = current.load(std::memory_order_seq_cst);
+        int t = static_cast<int>(type);
+        double price = table->at(t, bucket, site < table->sites ? site : 0)
+                           .apply(base < 0.0 ? table->basePrices[t] : base);
+        release(slot, p);
+        return price;
+    }
+
+    double price(CoffeeType type, uint32_t site = 0, double base = -1.0) const {
+        return priceAt(type, bucketOf(clock()), site, base);
+    }
+
+    uint64_t getGeneration() const {
+        ReaderSlot& slot = readers[readerSlot()];
+        unsigned p = enter(slot);
+        uint64_t generation = current.load(std::memory_order_seq_cst)->generation;
+        release(slot, p);
+        return generation;
+    }
+
+    uint32_t getSiteCount() const { return siteCount; }
+    const std::string& getLastError() const { return lastError; }
+
+    // Writer-side bookkeeping
+    size_t getRetiredCount() {
+        std::lock_guard<std::mutex> guard(compileMutex);
+        reclaim(); // the tables draining
+        reclaim(); // then those retired since
+        return draining.size() + retired.size();
+    }
+
+    uint64_t getReclaimedCount() {
+        std::lock_guard<std::mutex> guard(compileMutex);
+        return reclaimed;
+    }
+};
+
+#endif // PRICING_ENGINE_HPP
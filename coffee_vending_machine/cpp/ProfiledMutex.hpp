@@ -0,0 +1,89 @@
+#ifndef PROFILED_MUTEX_HPP
+#define PROFILED_MUTEX_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+// Instrumented mutex - drop-in for std::mutex (Lockable) that records how
+// often it is taken, how often callers had to wait and for how long.
+// The uncontended path is a try_lock plus two counter updates made while the
+// lock is held; the clock is only read when a caller actually blocks.
+class ProfiledMutex {
+public:
+    struct Stats {
+        uint64_t acquisitions = 0;
+        uint64_t contended = 0;
+        uint64_t waitNanos = 0;
+        uint64_t maxWaitNanos = 0;
+    };
+
+private:
+    std::mutex mutex;
+    std::string name;
+
+    // Written only while holding the mutex; atomics so readers may sample
+    // them at any time without a data race
+    std::atomic<uint64_t> acquisitions{0};
+    std::atomic<uint64_t> contended{0};
+    std::atomic<uint64_t> waitNanos{0};
+    std::atomic<uint64_t> maxWaitNanos{0};
+
+    static void bump(std::atomic<uint64_t>& counter, uint64_t by) {
+        counter.store(counter.load(std::memory_order_relaxed) + by, std::memory_order_relaxed);
+    }
+
+public:
+    explicit ProfiledMutex(std::string mutexName = "mutex") : name(std::move(mutexName)) {}
+
+    ProfiledMutex(const ProfiledMutex&) = delete;
+    ProfiledMutex& operator=(const ProfiledMutex&) = delete;
+
+    void lock() {
+        if (mutex.try_lock()) {
+            bump(acquisitions, 1);
+            return;
+        }
+        auto start = std::chrono::steady_clock::now();
+        mutex.lock();
+        uint64_t waited = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count());
+        bump(acquisitions, 1);
+        bump(contended, 1);
+        bump(waitNanos, waited);
+        if (waited > maxWaitNanos.load(std::memory_order_relaxed)) {
+            maxWaitNanos.store(waited, std::memory_order_relaxed);
+        }
+    }
+
+    bool try_lock() {
+        if (!mutex.try_lock()) return false;
+        bump(acquisitions, 1);
+        return true;
+    }
+
+    void unlock() { mutex.unlock(); }
+
+    Stats getStats() const {
+        Stats stats;
+        stats.acquisitions = acquisitions.load(std::memory_order_relaxed);
+        stats.contended = contended.load(std::memory_order_relaxed);
+        stats.waitNanos = waitNanos.load(std::memory_order_relaxed);
+        stats.maxWaitNanos = maxWaitNanos.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+    void resetStats() {
+        std::lock_guard<std::mutex> guard(mutex);
+        acquisitions.store(0, std::memory_order_relaxed);
+        contended.store(0, std::memory_order_relaxed);
+        waitNanos.store(0, std::memory_order_relaxed);
+        maxWaitNanos.store(0, std::memory_order_relaxed);
+    }
+
+    const std::string& getName() const { return name; }
+};
+
+#endif // PROFILED_MUTEX_HPP
@@ -0,0 +1,479 @@
+#ifndef RECEIPT_LOG_HPP
+#define RECEIPT_LOG_HPP
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <limits.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+// Receipt and audit log: one text line per paid order in a durable file
+// per machine,
+//
+//   2026-10-18T09:31:07.123Z machine=3 order=1842 drink=Latte amount=4.00 method=Card ref=****1111
+//
+// without a write() or fsync per order. A ReceiptWriter (one per process)
+// owns a pool of preallocated buffers and a flusher thread; each machine's
+// ReceiptLog formats lines straight into its current buffer under its own
+// lock. A buffer is sealed when it is full or has been open for
+// flushIntervalMs, and the flusher writes all of a log's sealed buffers
+// with a single writev(), then fdatasync()s the file once for the batch.
+//
+// Only the flusher touches file descriptors, so rotation (path -> path.1
+// -> ... -> path.keepFiles once the file passes rotateBytes) happens
+// between batches while writers keep filling buffers. Writers wait only
+// when every buffer in the pool is sealed and not yet on disk; those waits
+// are counted as stalls.
+
+struct Receipt {
+    std::string_view drink;
+    int64_t amountCents = 0;
+    std::string_view method;
+    std::string_view reference;   // masked card or account, may be empty
+};
+
+// The flusher's file calls; replaceable to count or fail them in a test
+// harness (see order_path_profile.cpp)
+struct ReceiptFileOps {
+    ssize_t (*writev)(int fd, const struct iovec* iov, int count) = ::writev;
+    int (*fdatasync)(int fd) = ::fdatasync;
+};
+
+struct ReceiptConfig {
+    size_t bufferBytes = 64 * 1024;      // batch unit; sealed when full
+    size_t buffers = 64;                 // pool shared by all logs of the writer
+    int64_t flushIntervalMs = 100;       // partly filled buffers are sealed after this
+    uint64_t rotateBytes = 64ull << 20;  // 0 never rotates
+    int keepFiles = 4;                   // rotated files kept as path.1 .. path.N
+    bool sync = true;                    // fdatasync after each batch
+    ReceiptFileOps files;
+};
+
+struct ReceiptBuffer {
+    char* data = nullptr;
+    size_t used = 0;
+    int64_t openedMs = 0;                // steady clock, when the first line went in
+};
+
+class ReceiptWriter;
+
+class ReceiptLog {
+    friend class ReceiptWriter;
+
+public:
+    static constexpr size_t MAX_LINE = 256;
+
+private:
+    ReceiptWriter& writer;
+    std::string path;
+    uint32_t machineId;
+    int fd;                              // flusher side only
+    uint64_t fileBytes;                  // flusher side only
+
+    std::mutex mutex;
+    ReceiptBuffer* current = nullptr;
+    std::vector<ReceiptBuffer*> sealed;
+    uint64_t nextOrder = 1;
+    int64_t stampSecond = -1;            // wall-clock second cached in stamp
+    char stamp[24] = {};
+
+    ReceiptLog(ReceiptWriter& owner, std::string file, uint32_t machine, int descriptor, uint64_t size)
+        : writer(owner), path(std::move(file)), machineId(machine), fd(descriptor), fileBytes(size) {}
+
+    void sealLocked();
+
+    // Hand over what is ready to write; partly filled buffers too once
+    // they are older than the flush interval (or always, with force)
+    void collect(int64_t nowMs, bool force, std::vector<ReceiptBuffer*>& out);
+
+    static char* put(char* out, std::string_view text) {
+        for (char c : text) *out++ = c;
+        return out;
+    }
+
+    // A field value: bounded, and kept to one token of one line
+    static char* putValue(char* out, std::string_view text, size_t limit) {
+        size_t n = std::min(text.size(), limit);
+        for (size_t i = 0; i < n; ++i) out[i] = text[i] == ' ' || text[i] == '\n' ? '_' : text[i];
+        return out + n;
+    }
+
+    static char* putUnsigned(char* out, uint64_t value) {
+        char digits[20];
+        int n = 0;
+        do {
+            digits[n++] = static_cast<char>('0' + value % 10);
+            value /= 10;
+        } while (value != 0);
+        while (n > 0) *out++ = digits[--n];
+        return out;
+    }
+
+    static char* putPadded(char* out, unsigned value, int width) {
+        for (int i = width - 1; i >= 0; --i, value /= 10) out[i] = static_cast<char>('0' + value % 10);
+        return out + width;
+    }
+
+    size_t format(char* out, uint64_t order, const Receipt& receipt);
+
+public:
+    ReceiptLog(const ReceiptLog&) = delete;
+    ReceiptLog& operator=(const ReceiptLog&) = delete;
+    ~ReceiptLog();
+
+    // Format one receipt into the current buffer; returns its order number
+    uint64_t append(const Receipt& receipt);
+
+    const std::string& getPath() const { return path; }
+    uint32_t getMachineId() const { return machineId; }
+    uint64_t getReceipts() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return nextOrder - 1;
+    }
+
+    // Continue numbering after `issued` receipts, e.g. for a machine taken
+    // over from another process (see MachineMigration.hpp)
+    void continueNumbering(uint64_t issued) {
+        std::lock_guard<std::mutex> lock(mutex);
+        nextOrder = std::max(nextOrder, issued + 1);
+    }
+};
+
+class ReceiptWriter {
+    friend class ReceiptLog;
+
+public:
+    using Config = ReceiptConfig;
+
+    struct Stats {
+        uint64_t receipts = 0;
+        uint64_t batches = 0;            // writev calls
+        uint64_t buffersWritten = 0;
+        uint64_t bytesWritten = 0;
+        uint64_t syncs = 0;
+        uint64_t rotations = 0;
+        uint64_t stalls = 0;             // appends that waited for a free buffer
+        uint64_t writeErrors = 0;
+        uint64_t syncErrors = 0;         // batches written but not known to be on disk
+        size_t logs = 0;
+    };
+
+private:
+    Config config;
+    std::unique_ptr<char[]> memory;
+    std::vector<ReceiptBuffer> storage;
+
+    // Pool, registered logs and the flusher's wake-up flags
+    std::mutex poolMutex;
+    std::condition_variable wake;
+    std::condition_variable bufferFreed;
+    std::vector<ReceiptBuffer*> freeBuffers;
+    std::vector<ReceiptLog*> logs;
+    bool pending = false;                // a buffer was sealed
+    bool starved = false;                // a writer is waiting for a buffer
+    bool stopping = false;
+    uint64_t stalls = 0;
+
+    // One flush pass at a time; guards the log files and stats below
+    std::mutex flushMutex;
+    std::vector<ReceiptLog*> passLogs;
+    std::vector<ReceiptBuffer*> batch;
+    std::vector<iovec> iov;
+    Stats stats;
+
+    std::thread flusher;
+
+    static int64_t steadyMillis() {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    ReceiptBuffer* acquire() {
+        std::unique_lock<std::mutex> lock(poolMutex);
+        if (freeBuffers.empty()) {
+            stalls++;
+            starved = true;
+            wake.notify_one();
+            bufferFreed.wait(lock, [this] { return !freeBuffers.empty(); });
+        }
+        ReceiptBuffer* buffer = freeBuffers.back();
+        freeBuffers.pop_back();
+        buffer->used = 0;
+        return buffer;
+    }
+
+    void recycle(ReceiptBuffer* buffer) {
+        std::lock_guard<std::mutex> lock(poolMutex);
+        freeBuffers.push_back(buffer);
+        bufferFreed.notify_all();
+    }
+
+    void notifySealed() {
+        std::lock_guard<std::mutex> lock(poolMutex);
+        pending = true;
+        wake.notify_one();
+    }
+
+    void rotate(ReceiptLog& log) {
+        ::close(log.fd);
+        for (int generation = config.keepFiles; generation >= 1; --generation) {
+            std::string from = generation == 1 ? log.path : log.path + "." + std::to_string(generation - 1);
+            std::string to = log.path + "." + std::to_string(generation);
+            ::rename(from.c_str(), to.c_str());
+        }
+        if (config.keepFiles <= 0) ::unlink(log.path.c_str());
+        log.fd = ::open(log.path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+        if (log.fd < 0) std::perror(log.path.c_str());
+        log.fileBytes = 0;
+        stats.rotations++;
+    }
+
+    // One writev (more only past IOV_MAX or on a short write) for all of a
+    // log's ready buffers, then one fdatasync
+    void writeBatch(ReceiptLog& log, const std::vector<ReceiptBuffer*>& buffers) {
+        iov.clear();
+        size_t total = 0;
+        for (ReceiptBuffer* buffer : buffers) {
+            iov.push_back({buffer->data, buffer->used});
+            total += buffer->used;
+        }
+        if (log.fd < 0) {
+            stats.writeErrors++;
+            return;
+        }
+        size_t first = 0;
+        while (first < iov.size()) {
+            int count = static_cast<int>(std::min<size_t>(iov.size() - first, IOV_MAX));
+            ssize_t written = config.files.writev(log.fd, &iov[first], count);
+            stats.batches++;
+            if (written < 0) {
+                if (errno == EINTR) continue;
+                std::perror(log.path.c_str());
+                stats.writeErrors++;
+                return;
+            }
+            size_t left = static_cast<size_t>(written);
+            while (first < iov.size() && left >= iov[first].iov_len) left -= iov[first++].iov_len;
+            if (left > 0) {
+                iov[first].iov_base = static_cast<char*>(iov[first].iov_base) + left;
+                iov[first].iov_len -= left;
+            }
+        }
+        stats.buffersWritten += buffers.size();
+        stats.bytesWritten += total;
+        if (config.sync) {
+            stats.syncs++;
+            if (config.files.fdatasync(log.fd) != 0) {
+                std::perror(log.path.c_str());
+                stats.syncErrors++;
+            }
+        }
+        log.fileBytes += total;
+        if (config.rotateBytes > 0 && log.fileBytes >= config.rotateBytes) rotate(log);
+    }
+
+    void flushLog(ReceiptLog& log, int64_t nowMs, bool force) {
+        batch.clear();
+        log.collect(nowMs, force, batch);
+        if (batch.empty()) return;
+        writeBatch(log, batch);
+        std::lock_guard<std::mutex> lock(poolMutex);
+        freeBuffers.insert(freeBuffers.end(), batch.begin(), batch.end());
+        bufferFreed.notify_all();
+    }
+
+    void flushPass(bool force) {
+        std::lock_guard<std::mutex> guard(flushMutex);
+        {
+            std::lock_guard<std::mutex> lock(poolMutex);
+            passLogs = logs;
+        }
+        int64_t nowMs = steadyMillis();
+        for (ReceiptLog* log : passLogs) flushLog(*log, nowMs, force);
+    }
+
+    void run() {
+        for (;;) {
+            bool force;
+            bool stop;
+            {
+                std::unique_lock<std::mutex> lock(poolMutex);
+                wake.wait_for(lock, std::chrono::milliseconds(config.flushIntervalMs),
+                              [this] { return pending || starved || stopping; });
+                force = starved || stopping;
+                stop = stopping;
+                pending = false;
+                starved = false;
+            }
+            flushPass(force);
+            if (stop) return;
+        }
+    }
+
+public:
+    explicit ReceiptWriter(Config writerConfig = Config()) : config(writerConfig) {
+        config.bufferBytes = std::max(config.bufferBytes, ReceiptLog::MAX_LINE);
+        config.buffers = std::max<size_t>(config.buffers, 2);
+        config.flushIntervalMs = std::max<int64_t>(config.flushIntervalMs, 1);
+        memory.reset(new char[config.bufferBytes * config.buffers]);
+        storage.resize(config.buffers);
+        for (size_t i = 0; i < config.buffers; ++i) {
+            storage[i].data = memory.get() + i * config.bufferBytes;
+            freeBuffers.push_back(&storage[i]);
+        }
+        iov.reserve(config.buffers);
+        batch.reserve(config.buffers);
+        flusher = std::thread(&ReceiptWriter::run, this);
+    }
+
+    ReceiptWriter(const ReceiptWriter&) = delete;
+    ReceiptWriter& operator=(const ReceiptWriter&) = delete;
+
+    // Logs must be closed (destroyed) first; anything still buffered in a
+    // remaining log is written by the final pass
+    ~ReceiptWriter() {
+        {
+            std::lock_guard<std::mutex> lock(poolMutex);
+            stopping = true;
+            wake.notify_one();
+        }
+        flusher.join();
+    }
+
+    // Open (append to) a machine's log file; nullptr after reporting the
+    // error via perror
+    std::unique_ptr<ReceiptLog> openLog(const std::string& path, uint32_t machineId) {
+        int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+        if (fd < 0) {
+            std::perror(path.c_str());
+            return nullptr;
+        }
+        struct stat info;
+        uint64_t size = ::fstat(fd, &info) == 0 ? static_cast<uint64_t>(info.st_size) : 0;
+        std::unique_ptr<ReceiptLog> log(new ReceiptLog(*this, path, machineId, fd, size));
+        // collect() swaps sealed with the flusher's batch; both sized for
+        // the whole pool, sealing a buffer never allocates
+        log->sealed.reserve(config.buffers);
+        std::lock_guard<std::mutex> lock(poolMutex);
+        logs.push_back(log.get());
+        return log;
+    }
+
+    // Write and sync everything appended so far, from the calling thread
+    void flush() { flushPass(true); }
+
+    const Config& getConfig() const { return config; }
+
+    Stats getStats() {
+        std::lock_guard<std::mutex> guard(flushMutex);
+        Stats result = stats;
+        std::vector<ReceiptLog*> current;
+        {
+            std::lock_guard<std::mutex> lock(poolMutex);
+            result.stalls = stalls;
+            current = logs;
+        }
+        result.logs = current.size();
+        for (ReceiptLog* log : current) result.receipts += log->getReceipts();
+        return result;
+    }
+};
+
+// Lock order: ReceiptWriter::flushMutex, then a ReceiptLog's mutex, then
+// ReceiptWriter::poolMutex. Writers never wait for a buffer while holding
+// their log's lock, so the flusher can always collect from them.
+
+inline ReceiptLog::~ReceiptLog() {
+    std::lock_guard<std::mutex> guard(writer.flushMutex);
+    {
+        std::lock_guard<std::mutex> lock(writer.poolMutex);
+        writer.logs.erase(std::find(writer.logs.begin(), writer.logs.end(), this));
+    }
+    writer.flushLog(*this, 0, true);
+    if (fd >= 0) ::close(fd);
+}
+
+inline void ReceiptLog::sealLocked() {
+    sealed.push_back(current);
+    current = nullptr;
+    writer.notifySealed();
+}
+
+inline void ReceiptLog::collect(int64_t nowMs, bool force, std::vector<ReceiptBuffer*>& out) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (current && current->used > 0 && (force || nowMs - current->openedMs >= writer.config.flushIntervalMs)) {
+        sealed.push_back(current);
+        current = nullptr;
+    }
+    out.swap(sealed);
+}
+
+inline size_t ReceiptLog::format(char* out, uint64_t order, const Receipt& receipt) {
+    int64_t nowMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+                        std::chrono::system_clock::now().time_since_epoch()).count();
+    int64_t second = nowMs / 1000;
+    if (second != stampSecond) {
+        time_t t = static_cast<time_t>(second);
+        struct tm utc;
+        gmtime_r(&t, &utc);
+        std::strftime(stamp, sizeof(stamp), "%Y-%m-%dT%H:%M:%S", &utc);
+        stampSecond = second;
+    }
+    char* p = out;
+    p = put(p, stamp);
+    *p++ = '.';
+    p = putPadded(p, static_cast<unsigned>(nowMs % 1000), 3);
+    p = put(p, "Z machine=");
+    p = putUnsigned(p, machineId);
+    p = put(p, " order=");
+    p = putUnsigned(p, order);
+    p = put(p, " drink=");
+    p = putValue(p, receipt.drink, 40);
+    p = put(p, " amount=");
+    uint64_t cents = receipt.amountCents < 0 ? 0 - static_cast<uint64_t>(receipt.amountCents)
+                                             : static_cast<uint64_t>(receipt.amountCents);
+    if (receipt.amountCents < 0) *p++ = '-';
+    p = putUnsigned(p, cents / 100);
+    *p++ = '.';
+    p = putPadded(p, static_cast<unsigned>(cents % 100), 2);
+    p = put(p, " method=");
+    p = putValue(p, receipt.method, 16);
+    p = put(p, " ref=");
+    p = receipt.reference.empty() ? put(p, "-") : putValue(p, receipt.reference, 40);
+    *p++ = '\n';
+    return static_cast<size_t>(p - out);
+}
+
+inline uint64_t ReceiptLog::append(const Receipt& receipt) {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!current || writer.config.bufferBytes - current->used < MAX_LINE) {
+        if (current) sealLocked();
+        lock.unlock();
+        ReceiptBuffer* fresh = writer.acquire();
+        lock.lock();
+        if (current) {
+            writer.recycle(fresh);       // another writer of this log got there first
+        } else {
+            current = fresh;
+            current->openedMs = ReceiptWriter::steadyMillis();
+        }
+    }
+    uint64_t order = nextOrder++;
+    current->used += format(current->data + current->used, order, receipt);
+    return order;
+}
+
+#endif // RECEIPT_LOG_HPP
@@ -0,0 +1,476 @@
+#ifndef REFILL_ROUTE_PLANNER_HPP
+#define REFILL_ROUTE_PLANNER_HPP
+
+#include "Inventory.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Refill routes for a fleet of machines. Operator::refillAll tops up one
+// machine by fixed amounts; an operator walking a fixed round visits
+// machines that are still full and reaches empty ones too late. The
+// planner reads every machine's Inventory snapshot (the Seqlock copy, so
+// it never touches the live maps) and learns each ingredient's
+// consumption rate from successive readings - an exponentially weighted
+// average of the drops, ignoring readings across a refill. From level and
+// rate it forecasts when each machine can no longer serve some drink.
+//
+// A plan covers one shift of config.vans vans leaving the depot:
+//
+//   1. machines running out before the next shift could reach them are
+//      due (horizon plus a shift); sorted by angle around the depot (cut
+//      at the widest gap) they are swept into routes by cheapest
+//      insertion, a new van when the shift is full
+//   2. each route is reordered by 2-opt, with minutes past a machine's
+//      forecast stock-out weighted above travel, and trimmed back to the
+//      shift by dropping the stops that can wait longest
+//   3. dropped due machines, then machines due within the next horizon,
+//      are inserted wherever they fit the shift without delaying a stop
+//      past its stock-out; the latter only for a short detour, so the
+//      next day's trips are saved today
+//
+// Quantities fill every ingredient to the full level forecast at the
+// van's arrival. Sweep plus insertion is O(n log n + n * stops); 2-opt
+// adds up to eight passes per route, each quadratic in the route's stop
+// count (and re-timing the route for every candidate move), so it is the
+// term that grows if vans get longer routes. refill_route_bench measures
+// about 45-120 ms for 5,000 machines and 120-190 ms for 10,000 on one
+// core - cheap enough to re-plan the fleet whenever a low-stock alert
+// arrives (see FleetAlertRelay), not something to run per order.
+
+struct FleetSite {
+    uint32_t machineId;
+    double xKm;
+    double yKm;
+    const Inventory* inventory;        // must outlive the planner
+};
+
+struct RefillPlannerConfig {
+    int vans = 4;
+    double depotXKm = 0.0;
+    double depotYKm = 0.0;
+    double speedKmh = 25.0;
+    double roadFactor = 1.3;           // road distance over straight line
+    int serviceMinutes = 10;           // per stop
+    int shiftMinutes = 480;
+    int horizonMinutes = 24 * 60;      // until the next plan's shift starts
+    int detourMinutes = 6;             // extra driving to top up a machine due next horizon
+    double rateHalfLifeMinutes = 360.0;
+    double rateSafety = 1.2;           // forecasts assume consumption this much faster
+    std::map<std::string, int> fullLevels;   // missing ingredients: a new Inventory's level
+};
+
+struct RefillStop {
+    uint32_t site;                     // index from addSite()
+    uint32_t machineId;
+    double arrivalMinutes;             // after the plan time
+    double stockoutMinutes;            // forecast; infinity if not consuming
+    int quantity[InventorySnapshot::MAX_INGREDIENTS];   // in getIngredientNames() order
+    bool early;                        // due next horizon, topped up on the way
+};
+
+struct RefillRoute {
+    int van;
+    std::vector<RefillStop> stops;
+    double travelKm = 0.0;
+    double durationMinutes = 0.0;      // depot to depot
+    int load[InventorySnapshot::MAX_INGREDIENTS] = {};
+};
+
+struct RefillPlan {
+    std::vector<RefillRoute> routes;
+    std::vector<uint32_t> unserved;    // due but no van has room
+    uint32_t due = 0;
+    uint32_t late = 0;                 // visited after the forecast stock-out
+    uint32_t early = 0;
+    double travelKm = 0.0;
+    int64_t plannedAtMs = 0;
+};
+
+class RefillRoutePlanner {
+public:
+    using Config = RefillPlannerConfig;
+    static constexpr size_t MAX_INGREDIENTS = InventorySnapshot::MAX_INGREDIENTS;
+
+private:
+    static constexpr uint32_t DEPOT = UINT32_MAX;
+    static constexpr double NEVER = std::numeric_limits<double>::infinity();
+    static constexpr double TWO_PI = 6.283185307179586;
+    static constexpr double LATE_WEIGHT = 3.0;    // a minute past stock-out costs three of driving
+
+    struct Site {
+        FleetSite where;
+        int level[MAX_INGREDIENTS];
+        double rate[MAX_INGREDIENTS];  // units per minute
+        int64_t observedMs = 0;
+        bool observed = false;
+        bool rated = false;
+    };
+
+    // A route being built: stop order, arrival at each stop, and how far
+    // each stop's arrival may slip before some later stop runs out
+    struct WorkRoute {
+        std::vector<uint32_t> stops;
+        std::vector<double> arrival;
+        std::vector<double> slack;     // stops.size() + 1 entries
+        double duration = 0.0;
+        double late = 0.0;
+    };
+
+    Config config;
+    std::vector<std::string> names;
+    uint32_t ingredientCount = 0;
+    int full[MAX_INGREDIENTS] = {};
+    int usable[MAX_INGREDIENTS] = {};  // below this some drink can no longer be made
+    std::vector<Site> sites;
+    std::vector<double> deadline;      // per site, minutes after the plan time
+    uint64_t pendingAlerts = 0;
+    double minutesPerKm = 0.0;         // driving, road factor included
+
+    double minutes(uint32_t from, uint32_t to) const {
+        double fx = from == DEPOT ? config.depotXKm : sites[from].where.xKm;
+        double fy = from == DEPOT ? config.depotYKm : sites[from].where.yKm;
+        double tx = to == DEPOT ? config.depotXKm : sites[to].where.xKm;
+        double ty = to == DEPOT ? config.depotYKm : sites[to].where.yKm;
+        return std::sqrt((tx - fx) * (tx - fx) + (ty - fy) * (ty - fy)) * minutesPerKm;
+    }
+
+    void time(WorkRoute& route) const {
+        size_t n = route.stops.size();
+        route.arrival.resize(n);
+        route.slack.assign(n + 1, NEVER);
+        route.late = 0.0;
+        double clock = 0.0;
+        uint32_t at = DEPOT;
+        for (size_t k = 0; k < n; ++k) {
+            clock += minutes(at, route.stops[k]);
+            route.arrival[k] = clock;
+            route.late += std::max(0.0, clock - deadline[route.stops[k]]);
+            clock += config.serviceMinutes;
+            at = route.stops[k];
+        }
+        route.duration = clock + (n ? minutes(at, DEPOT) : 0.0);
+        for (size_t k = n; k-- > 0;) {
+            double own = std::max(0.0, deadline[route.stops[k]] - route.arrival[k]);
+            route.slack[k] = std::min(own, route.slack[k + 1]);
+        }
+    }
+
+    double cost(const WorkRoute& route) const { return route.duration + LATE_WEIGHT * route.late; }
+
+    // Cheapest place for the site that keeps the shift and every stop's
+    // slack; returns the added minutes, or NEVER
+    double bestInsertion(const WorkRoute& route, uint32_t site, size_t& position) const {
+        double best = NEVER;
+        size_t n = route.stops.size();
+        double room = config.shiftMinutes - route.duration;
+        if (room < config.serviceMinutes) return best;
+        for (size_t p = 0; p <= n; ++p) {
+            uint32_t prev = p == 0 ? DEPOT : route.stops[p - 1];
+            uint32_t next = p == n ? DEPOT : route.stops[p];
+            double added = minutes(prev, site) + config.serviceMinutes + minutes(site, next)
+                - (n ? minutes(prev, next) : 0.0);
+            if (added < best && added <= room && added <= route.slack[p]) {
+                best = added;
+                position = p;
+            }
+        }
+        return best;
+    }
+
+    void insert(WorkRoute& route, uint32_t site, size_t position) const {
+        route.stops.insert(route.stops.begin() + static_cast<std::ptrdiff_t>(position), site);
+        time(route);
+    }
+
+    // Segment reversal; only distances around the cut change, the rest is
+    // re-timed when the move could pay for itself
+    void twoOpt(WorkRoute& route) const {
+        size_t n = route.stops.size();
+        for (int pass = 0; pass < 8; ++pass) {
+            bool improved = false;
+            for (size_t i = 0; i + 1 < n; ++i) {
+                for (size_t j = i + 1; j < n; ++j) {
+                    uint32_t before = i == 0 ? DEPOT : route.stops[i - 1];
+                    uint32_t after = j + 1 == n ? DEPOT : route.stops[j + 1];
+                    double delta = minutes(before, route.stops[j]) + minutes(route.stops[i], after)
+                        - minutes(before, route.stops[i]) - minutes(route.stops[j], after);
+                    if (delta >= -1e-9 && (route.late == 0.0 || delta >= LATE_WEIGHT * route.late)) continue;
+                    double current = cost(route);
+                    double limit = std::max<double>(route.duration, config.shiftMinutes);
+                    std::reverse(route.stops.begin() + static_cast<std::ptrdiff_t>(i),
+                                 route.stops.begin() + static_cast<std::ptrdiff_t>(j) + 1);
+                    time(route);
+                    if (cost(route) < current - 1e-9 && route.duration <= limit) {
+                        improved = true;
+                    } else {
+                        std::reverse(route.stops.begin() + static_cast<std::ptrdiff_t>(i),
+                                     route.stops.begin() + static_cast<std::ptrdiff_t>(j) + 1);
+                        time(route);
+                    }
+                }
+            }
+            if (!improved) break;
+        }
+    }
+
+    // Minutes until some ingredient drops below what its drinks need
+    double forecast(const Site& site) const {
+        if (!site.observed) return NEVER;
+        double earliest = NEVER;
+        for (uint32_t i = 0; i < ingredientCount; ++i) {
+            double rate = site.rate[i] * config.rateSafety;
+            double spare = static_cast<double>(site.level[i] - usable[i]);
+            if (spare <= 0.0) return 0.0;
+            if (rate > 0.0) earliest = std::min(earliest, spare / rate);
+        }
+        return earliest;
+    }
+
+    RefillStop stopFor(uint32_t site, double arrival, bool early) const {
+        const Site& s = sites[site];
+        RefillStop stop{site, s.where.machineId, arrival, deadline[site], {}, early};
+        for (uint32_t i = 0; i < ingredientCount; ++i) {
+            double left = std::max(0.0, s.level[i] - s.rate[i] * arrival);
+            stop.quantity[i] = std::max(0, full[i] - static_cast<int>(std::floor(left)));
+        }
+        return stop;
+    }
+
+public:
+    explicit RefillRoutePlanner(Config plannerConfig = Config()) : config(std::move(plannerConfig)) {
+        config.vans = std::max(1, config.vans);
+        config.speedKmh = std::max(1.0, config.speedKmh);
+        minutesPerKm = config.roadFactor / config.speedKmh * 60.0;
+        Inventory fresh;
+        InventorySnapshot levels = fresh.readSnapshot();
+        names = fresh.getIngredientNames();
+        ingredientCount = levels.count;
+        for (uint32_t i = 0; i < ingredientCount; ++i) {
+            auto it = config.fullLevels.find(names[i]);
+            full[i] = it != config.fullLevels.end() ? it->second : levels.levels[i];
+            usable[i] = names[i] == "Cups" ? 1 : 0;
+        }
+        for (int t = 0; t < static_cast<int>(CoffeeType::COUNT); ++t) {
+            for (const auto& [ingredient, amount] : Inventory::getRecipe(static_cast<CoffeeType>(t))) {
+                auto it = std::lower_bound(names.begin(), names.end(), ingredient);
+                if (it == names.end() || *it != ingredient) continue;
+                int& need = usable[it - names.begin()];
+                need = std::max(need, amount);
+            }
+        }
+    }
+
+    uint32_t addSite(const FleetSite& where) {
+        Site site;
+        site.where = where;
+        std::fill(std::begin(site.level), std::end(site.level), 0);
+        std::fill(std::begin(site.rate), std::end(site.rate), 0.0);
+        sites.push_back(site);
+        return static_cast<uint32_t>(sites.size() - 1);
+    }
+
+    // Read every machine's levels and fold the drops since the last
+    // reading into its consumption rates. Cheap enough to poll; plan()
+    // calls it too.
+    void observe(int64_t nowMs) {
+        for (Site& site : sites) {
+            InventorySnapshot snap = site.where.inventory->readSnapshot();
+            uint32_t count = std::min<uint32_t>(snap.count, ingredientCount);
+            double elapsed = static_cast<double>(nowMs - site.observedMs) / 60000.0;
+            if (site.observed && elapsed > 0.0) {
+                double weight = 1.0 - std::exp2(-elapsed / config.rateHalfLifeMinutes);
+                for (uint32_t i = 0; i < count; ++i) {
+                    int drop = site.level[i] - snap.levels[i];
+                    if (drop < 0) continue;    // refilled in between
+                    double sample = drop / elapsed;
+                    site.rate[i] = site.rated ? site.rate[i] + weight * (sample - site.rate[i]) : sample;
+                }
+                site.rated = true;
+            }
+            if (!site.observed || elapsed > 0.0) {
+                std::copy(snap.levels, snap.levels + count, site.level);
+                site.observedMs = nowMs;
+                site.observed = true;
+            }
+        }
+    }
+
+    void noteAlert(uint32_t /*site*/) { pendingAlerts++; }
+    bool hasPendingAlerts() const { return pendingAlerts > 0; }
+
+    RefillPlan plan(int64_t nowMs) {
+        observe(nowMs);
+        pendingAlerts = 0;
+        RefillPlan result;
+        result.plannedAtMs = nowMs;
+
+        struct Candidate {
+            uint32_t site;
+            double angle;
+        };
+        std::vector<Candidate> due;
+        std::vector<uint32_t> soon;
+        // Running out before the next shift could get there
+        double dueBy = static_cast<double>(config.horizonMinutes) + config.shiftMinutes;
+        deadline.resize(sites.size());
+        for (uint32_t s = 0; s < sites.size(); ++s) {
+            deadline[s] = forecast(sites[s]);
+            if (deadline[s] <= dueBy) {
+                due.push_back({s, std::atan2(sites[s].where.yKm - config.depotYKm, sites[s].where.xKm - config.depotXKm)});
+            } else if (deadline[s] <= dueBy + config.horizonMinutes) {
+                soon.push_back(s);
+            }
+        }
+        result.due = static_cast<uint32_t>(due.size());
+
+        // 1. Sweep from the widest angular gap, one van per full shift
+        std::sort(due.begin(), due.end(), [](const Candidate& a, const Candidate& b) { return a.angle < b.angle; });
+        size_t cut = 0;
+        double widest = -1.0;
+        for (size_t k = 0; k < due.size(); ++k) {
+            double gap = k == 0 ? due[0].angle + TWO_PI - due.back().angle : due[k].angle - due[k - 1].angle;
+            if (gap > widest) {
+                widest = gap;
+                cut = k;
+            }
+        }
+        std::rotate(due.begin(), due.begin() + static_cast<std::ptrdiff_t>(cut), due.end());
+
+        std::vector<WorkRoute> routes;
+        std::vector<uint32_t> dropped;
+        auto sweep = [&](const std::vector<Candidate>& order) {
+            routes.clear();
+            dropped.clear();
+            for (const Candidate& candidate : order) {
+                size_t position = 0;
+                if (routes.empty() || bestInsertion(routes.back(), candidate.site, position) == NEVER) {
+                    if (static_cast<int>(routes.size()) == config.vans) {
+                        dropped.push_back(candidate.site);
+                        continue;
+                    }
+                    routes.emplace_back();
+                    time(routes.back());
+                    position = 0;
+                }
+                insert(routes.back(), candidate.site, position);
+            }
+        };
+        sweep(due);
+        if (!dropped.empty()) {
+            // More due than the vans can take: sweep again over the ones
+            // running out first, as many as fitted
+            size_t fitted = due.size() - dropped.size();
+            std::vector<Candidate> urgent = due;
+            std::nth_element(urgent.begin(), urgent.begin() + static_cast<std::ptrdiff_t>(fitted), urgent.end(),
+                [this](const Candidate& a, const Candidate& b) { return deadline[a.site] < deadline[b.site]; });
+            std::vector<bool> keep(sites.size(), false);
+            for (size_t k = 0; k < fitted; ++k) keep[urgent[k].site] = true;
+            urgent.clear();
+            for (const Candidate& candidate : due) {
+                if (keep[candidate.site]) urgent.push_back(candidate);
+            }
+            sweep(urgent);
+            for (const Candidate& candidate : due) {
+                if (!keep[candidate.site]) dropped.push_back(candidate.site);
+            }
+        }
+
+        // 2. Order against stock-outs, then fit the shift again
+        for (WorkRoute& route : routes) {
+            twoOpt(route);
+            while (route.duration > config.shiftMinutes && !route.stops.empty()) {
+                auto latest = std::max_element(route.stops.begin(), route.stops.end(),
+                    [this](uint32_t a, uint32_t b) { return deadline[a] < deadline[b]; });
+                dropped.push_back(*latest);
+                route.stops.erase(latest);
+                time(route);
+            }
+        }
+
+        // 3. Dropped machines first (earliest stock-out first), then early
+        //    top-ups for a short detour
+        std::sort(dropped.begin(), dropped.end(), [this](uint32_t a, uint32_t b) { return deadline[a] < deadline[b]; });
+        std::sort(soon.begin(), soon.end(), [this](uint32_t a, uint32_t b) { return deadline[a] < deadline[b]; });
+        std::vector<bool> early(sites.size(), false);
+        auto place = [&](uint32_t site, double limit) {
+            size_t bestRoute = routes.size(), bestPosition = 0;
+            double best = NEVER;
+            for (size_t r = 0; r < routes.size(); ++r) {
+                size_t position = 0;
+                double added = bestInsertion(routes[r], site, position);
+                if (added < best) {
+                    best = added;
+                    bestRoute = r;
+                    bestPosition = position;
+                }
+            }
+            if (static_cast<int>(routes.size()) < config.vans && limit == NEVER) {
+                double alone = 2.0 * minutes(DEPOT, site) + config.serviceMinutes;
+                if (alone < best && alone <= config.shiftMinutes) {
+                    routes.emplace_back();
+                    time(routes.back());
+                    bestRoute = routes.size() - 1;
+                    bestPosition = 0;
+                    best = alone;
+                }
+            }
+            if (bestRoute == routes.size() || best - config.serviceMinutes > limit) return false;
+            insert(routes[bestRoute], site, bestPosition);
+            return true;
+        };
+        for (uint32_t site : dropped) {
+            if (!place(site, NEVER)) result.unserved.push_back(site);
+        }
+        for (uint32_t site : soon) {
+            if (place(site, config.detourMinutes)) early[site] = true;
+        }
+
+        for (const WorkRoute& work : routes) {
+            if (work.stops.empty()) continue;
+            RefillRoute route;
+            route.van = static_cast<int>(result.routes.size());
+            route.durationMinutes = work.duration;
+            route.travelKm = (work.duration - config.serviceMinutes * static_cast<double>(work.stops.size()))
+                * config.speedKmh / 60.0;
+            for (size_t k = 0; k < work.stops.size(); ++k) {
+                uint32_t site = work.stops[k];
+                route.stops.push_back(stopFor(site, work.arrival[k], early[site]));
+                for (uint32_t i = 0; i < ingredientCount; ++i) route.load[i] += route.stops.back().quantity[i];
+                result.late += work.arrival[k] > deadline[site];
+                result.early += early[site];
+            }
+            result.travelKm += route.travelKm;
+            result.routes.push_back(std::move(route));
+        }
+        return result;
+    }
+
+    size_t getSiteCount() const { return sites.size(); }
+    const FleetSite& getSite(uint32_t site) const { return sites[site].where; }
+    const std::vector<std::string>& getIngredientNames() const { return names; }
+    int getFullLevel(uint32_t ingredient) const { return full[ingredient]; }
+    const Config& getConfig() const { return config; }
+};
+
+// Observer Pattern - forwards one machine's low-level alerts to the
+// planner, so the dispatcher knows to re-plan
+class FleetAlertRelay : public InventoryObserver {
+private:
+    RefillRoutePlanner* planner;
+    uint32_t site;
+
+public:
+    FleetAlertRelay(RefillRoutePlanner* target, uint32_t siteIndex) : planner(target), site(siteIndex) {}
+
+    void update(const std::string& /*ingredient*/, int /*currentLevel*/, int /*threshold*/) override {
+        planner->noteAlert(site);
+    }
+};
+
+#endif // REFILL_ROUTE_PLANNER_HPP
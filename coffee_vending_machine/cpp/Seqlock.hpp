@@ -0,0 +1,73 @@
+#ifndef SEQLOCK_HPP
+#define SEQLOCK_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// Seqlock - single writer, any number of lock-free readers.
+// The writer bumps the sequence to odd, stores the payload and bumps it back
+// to even; it never waits for readers. A reader copies the payload and keeps
+// it only if the sequence was even and unchanged across the copy, retrying
+// otherwise. The payload is held as atomic words so the racing copy is
+// well-defined; release stores / acquire loads on the words (plain moves on
+// x86) order them against the sequence without standalone fences, which keeps
+// the class checkable under ThreadSanitizer. T must be trivially copyable.
+template <typename T>
+class Seqlock {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "Seqlock payload must be trivially copyable");
+
+private:
+    static constexpr size_t WORDS = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    alignas(64) std::atomic<uint64_t> sequence{0};
+    std::atomic<uint64_t> words[WORDS];
+
+public:
+    Seqlock() {
+        for (auto& word : words) word.store(0, std::memory_order_relaxed);
+    }
+
+    explicit Seqlock(const T& initial) : Seqlock() { store(initial); }
+
+    Seqlock(const Seqlock&) = delete;
+    Seqlock& operator=(const Seqlock&) = delete;
+
+    // Writer side - must not be called concurrently with itself
+    void store(const T& value) {
+        uint64_t buffer[WORDS] = {};
+        std::memcpy(buffer, &value, sizeof(T));
+
+        uint64_t seq = sequence.load(std::memory_order_relaxed);
+        sequence.store(seq + 1, std::memory_order_relaxed);
+        for (size_t i = 0; i < WORDS; ++i) {
+            words[i].store(buffer[i], std::memory_order_release);
+        }
+        sequence.store(seq + 2, std::memory_order_release);
+    }
+
+    // Reader side - returns a consistent copy, never blocks the writer
+    T load() const {
+        uint64_t buffer[WORDS];
+        while (true) {
+            uint64_t before = sequence.load(std::memory_order_acquire);
+            if (before & 1) continue; // write in progress
+            for (size_t i = 0; i < WORDS; ++i) {
+                buffer[i] = words[i].load(std::memory_order_acquire);
+            }
+            if (sequence.load(std::memory_order_relaxed) == before) break;
+        }
+        T value;
+        std::memcpy(&value, buffer, sizeof(T));
+        return value;
+    }
+
+    // Number of completed writes, usable as a cheap change detector
+    uint64_t version() const {
+        return sequence.load(std::memory_order_acquire) / 2;
+    }
+};
+
+#endif // SEQLOCK_HPP
@@ -0,0 +1,265 @@
+#ifndef SHARDED_INVENTORY_HPP
+#define SHARDED_INVENTORY_HPP
+
+#include "Inventory.hpp"
+#include <sched.h>
+#include <array>
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Sharded Inventory - per-core ingredient counters for many order threads.
+// Each core owns a cache-line padded allotment of every ingredient, carved
+// out of a shared global pool. Orders consume from their core's allotment
+// with a single uncontended atomic per ingredient; only when an allotment
+// runs dry does the shard take the pool mutex and grab another batch.
+// Counters never go negative, so stock can never be oversold: when the pool
+// is short, stranded allotments are pulled back (reconciled) before an order
+// is refused.
+//
+// Low-level alerts are raised from the refill (slow) path, not on every
+// consume, using the reconciled level of the ingredient.
+class ShardedInventory : public InventorySubject {
+public:
+    static constexpr size_t MAX_INGREDIENTS = 8;
+    static constexpr size_t COFFEE_TYPES = static_cast<size_t>(CoffeeType::COUNT);
+
+private:
+    // One shard per core, padded so two cores never share a line
+    struct alignas(64) Shard {
+        std::array<std::atomic<int>, MAX_INGREDIENTS> levels{};
+    };
+
+    std::vector<std::string> names;                  // index -> ingredient name
+    std::array<int, MAX_INGREDIENTS> thresholds{};
+    std::array<int, MAX_INGREDIENTS> batchSizes{};   // allotment grabbed per refill
+    std::array<std::array<int, MAX_INGREDIENTS>, COFFEE_TYPES> recipes{};
+
+    std::vector<Shard> shards;
+    alignas(64) std::array<std::atomic<int>, MAX_INGREDIENTS> global{};
+    std::mutex poolMutex;                            // guards writes to global
+    std::vector<InventoryObserver*> observers;
+
+    int indexOf(const std::string& ingredient) const {
+        for (size_t i = 0; i < names.size(); ++i) {
+            if (names[i] == ingredient) return static_cast<int>(i);
+        }
+        return -1;
+    }
+
+    Shard& localShard() {
+        int cpu = sched_getcpu();
+        size_t idx = cpu < 0 ? 0 : static_cast<size_t>(cpu) % shards.size();
+        return shards[idx];
+    }
+
+    static bool takeLocal(Shard& shard, size_t ingredient, int amount) {
+        std::atomic<int>& level = shard.levels[ingredient];
+        int current = level.load(std::memory_order_relaxed);
+        while (current >= amount) {
+            if (level.compare_exchange_weak(current, current - amount,
+                                            std::memory_order_relaxed)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Caller holds poolMutex. Returns every shard's allotment of one
+    // ingredient to the global pool.
+    void drainLocked(size_t ingredient) {
+        int recovered = 0;
+        for (auto& shard : shards) {
+            recovered += shard.levels[ingredient].exchange(0, std::memory_order_relaxed);
+        }
+        global[ingredient].fetch_add(recovered, std::memory_order_relaxed);
+    }
+
+    int reconciledLevel(size_t ingredient) const {
+        int total = global[ingredient].load(std::memory_order_relaxed);
+        for (const auto& shard : shards) {
+            total += shard.levels[ingredient].load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+    // Slow path: move a batch from the pool into this shard's allotment.
+    // Returns false when the whole machine is short of the ingredient.
+    bool refillShard(Shard& shard, size_t ingredient, int needed) {
+        bool granted = false;
+        int level = 0;
+        {
+            std::lock_guard<std::mutex> lock(poolMutex);
+            int available = global[ingredient].load(std::memory_order_relaxed);
+            if (available < needed) {
+                drainLocked(ingredient);
+                available = global[ingredient].load(std::memory_order_relaxed);
+            }
+            if (available >= needed) {
+                int grant = std::min(available, std::max(needed, batchSizes[ingredient]));
+                global[ingredient].fetch_sub(grant, std::memory_order_relaxed);
+                shard.levels[ingredient].fetch_add(grant, std::memory_order_relaxed);
+                granted = true;
+            }
+            level = reconciledLevel(ingredient);
+        }
+        // Notify outside the lock; observers may call back into the inventory
+        if (level <= thresholds[ingredient]) {
+            notifyObservers(names[ingredient], level, thresholds[ingredient]);
+        }
+        return granted;
+    }
+
+public:
+    // Seed the global pool from an existing inventory's levels and thresholds.
+    // shardCount defaults to the number of online cores.
+    explicit ShardedInventory(const Inventory& seed, size_t shardCount = 0) {
+        if (shardCount == 0) {
+            unsigned hw = std::thread::hardware_concurrency();
+            shardCount = hw > 0 ? hw : 1;
+        }
+        shards = std::vector<Shard>(shardCount);
+
+        for (const auto& [ingredient, quantity] : seed.getIngredients()) {
+            if (names.size() == MAX_INGREDIENTS) break;
+            size_t idx = names.size();
+            names.push_back(ingredient);
+            global[idx].store(quantity, std::memory_order_relaxed);
+            auto threshIt = seed.getThresholds().find(ingredient);
+            thresholds[idx] = threshIt != seed.getThresholds().end() ? threshIt->second : 0;
+        }
+
+        int cups = indexOf("Cups");
+        for (size_t type = 0; type < COFFEE_TYPES; ++type) {
+            for (const auto& [ingredient, required] : Inventory::getRecipe(static_cast<CoffeeType>(type))) {
+                int idx = indexOf(ingredient);
+                if (idx >= 0) recipes[type][static_cast<size_t>(idx)] = required;
+            }
+            if (cups >= 0) recipes[type][static_cast<size_t>(cups)] = 1;
+        }
+
+        // An allotment covers roughly 16 of the most demanding drinks
+        for (size_t i = 0; i < names.size(); ++i) {
+            int largest = 1;
+            for (const auto& recipe : recipes) largest = std::max(largest, recipe[i]);
+            batchSizes[i] = largest * 16;
+        }
+    }
+
+    ShardedInventory(const ShardedInventory&) = delete;
+    ShardedInventory& operator=(const ShardedInventory&) = delete;
+
+    // Approximate under concurrent consumption, exact when quiescent
+    bool checkAvailability(CoffeeType coffeeType) const {
+        size_t type = static_cast<size_t>(coffeeType);
+        if (type >= COFFEE_TYPES) return false;
+        for (size_t i = 0; i < names.size(); ++i) {
+            if (recipes[type][i] > 0 && reconciledLevel(i) < recipes[type][i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // All-or-nothing: returns false (and takes nothing) if any ingredient
+    // cannot be covered
+    bool consumeIngredients(CoffeeType coffeeType) {
+        size_t type = static_cast<size_t>(coffeeType);
+        if (type >= COFFEE_TYPES) return false;
+        const auto& recipe = recipes[type];
+        Shard& shard = localShard();
+
+        size_t taken = 0;
+        for (; taken < names.size(); ++taken) {
+            int needed = recipe[taken];
+            if (needed == 0) continue;
+            // Another thread on this core may win the fresh batch; retry
+            // until the pool itself is short
+            bool ok = true;
+            while (ok && !takeLocal(shard, taken, needed)) {
+                ok = refillShard(shard, taken, needed);
+            }
+            if (!ok) break;
+        }
+        if (taken == names.size()) return true;
+
+        // Roll back what this order already took
+        for (size_t i = 0; i < taken; ++i) {
+            if (recipe[i] > 0) shard.levels[i].fetch_add(recipe[i], std::memory_order_relaxed);
+        }
+        return false;
+    }
+
+    void refillIngredient(const std::string& ingredient, int amount) {
+        int idx = indexOf(ingredient);
+        if (idx < 0) {
+            std::cout << "Unknown ingredient: " << ingredient << "\n";
+            return;
+        }
+        std::lock_guard<std::mutex> lock(poolMutex);
+        size_t i = static_cast<size_t>(idx);
+        int current = reconciledLevel(i);
+        global[i].fetch_add(amount, std::memory_order_relaxed);
+        std::cout << "Refilled " << ingredient << ": " << current
+                  << " + " << amount << " = " << current + amount << "\n";
+    }
+
+    // Periodic reconciliation: pull every allotment back into the pool.
+    // Shards re-borrow lazily on their next order.
+    void reconcile() {
+        std::lock_guard<std::mutex> lock(poolMutex);
+        for (size_t i = 0; i < names.size(); ++i) {
+            drainLocked(i);
+        }
+    }
+
+    // Exact view: reconciles first, so the levels reflect every consume that
+    // completed before the call
+    std::map<std::string, int> getIngredients() {
+        std::lock_guard<std::mutex> lock(poolMutex);
+        std::map<std::string, int> levels;
+        for (size_t i = 0; i < names.size(); ++i) {
+            drainLocked(i);
+            levels[names[i]] = global[i].load(std::memory_order_relaxed);
+        }
+        return levels;
+    }
+
+    void displayInventory() {
+        std::cout << "\n========== INVENTORY STATUS ==========\n";
+        for (const auto& [ingredient, quantity] : getIngredients()) {
+            std::string status = quantity <= thresholds[static_cast<size_t>(indexOf(ingredient))]
+                                 ? " [LOW]" : "";
+            std::cout << std::left << std::setw(15) << ingredient
+                      << ": " << quantity << status << "\n";
+        }
+        std::cout << "Shards         : " << shards.size() << "\n";
+        std::cout << "=======================================\n";
+    }
+
+    size_t getShardCount() const { return shards.size(); }
+
+    // Observer Pattern methods
+    void addObserver(InventoryObserver* observer) override {
+        observers.push_back(observer);
+    }
+
+    void removeObserver(InventoryObserver* observer) override {
+        observers.erase(
+            std::remove(observers.begin(), observers.end(), observer),
+            observers.end()
+        );
+    }
+
+    void notifyObservers(const std::string& ingredient, int currentLevel, int threshold) override {
+        for (auto* observer : observers) {
+            observer->update(ingredient, currentLevel, threshold);
+        }
+    }
+};
+
+#endif // SHARDED_INVENTORY_HPP
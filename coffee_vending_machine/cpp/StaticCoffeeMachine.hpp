@@ -0,0 +1,352 @@
+#ifndef STATIC_COFFEE_MACHINE_HPP
+#define STATIC_COFFEE_MACHINE_HPP
+
+#include "Observer.hpp"
+#include "PaymentStrategy.hpp"
+#include <array>
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Compile-time specialised coffee machine for fixed-menu (kiosk) builds.
+// The menu - recipes, prices, stock and thresholds - is a constexpr table,
+// states are a plain enum handled by switch, and payments passed by concrete
+// type are called without virtual dispatch. Availability checks and
+// ingredient consumption are expanded per drink at compile time, so they
+// become straight-line code with no map lookups.
+//
+// Public behaviour (console output, state transitions, observer alerts)
+// matches the dynamic CoffeeMachine.
+
+// Fixed ingredient slots, in the same (alphabetical) order Inventory prints
+struct StaticIngredients {
+    static constexpr size_t CHOCOLATE = 0;
+    static constexpr size_t COFFEE_BEANS = 1;
+    static constexpr size_t CUPS = 2;
+    static constexpr size_t MILK = 3;
+    static constexpr size_t WATER = 4;
+    static constexpr size_t COUNT = 5;
+
+    static constexpr std::array<const char*, COUNT> NAMES = {
+        "Chocolate", "Coffee Beans", "Cups", "Milk", "Water"
+    };
+};
+
+struct StaticRecipe {
+    const char* name;
+    double price;
+    int preparationTime; // in seconds
+    const char* preparation;
+    std::array<int, StaticIngredients::COUNT> amounts; // includes the cup
+};
+
+// The standard menu - mirrors the Coffee subclasses and Inventory defaults
+struct DefaultMenu {
+    //                                       Choc  Beans Cups  Milk  Water
+    static constexpr std::array<StaticRecipe, 5> RECIPES = {{
+        {"Espresso", 2.50, 30,
+         "Preparing Espresso: Grinding beans, extracting shot...",
+         {0, 20, 1, 0, 30}},
+        {"Cappuccino", 3.50, 45,
+         "Preparing Cappuccino: Extracting espresso, steaming milk, adding foam...",
+         {0, 20, 1, 100, 30}},
+        {"Latte", 3.00, 40,
+         "Preparing Latte: Extracting espresso, adding steamed milk...",
+         {0, 20, 1, 150, 30}},
+        {"Americano", 2.00, 25,
+         "Preparing Americano: Extracting espresso, adding hot water...",
+         {0, 20, 1, 0, 150}},
+        {"Mocha", 4.00, 50,
+         "Preparing Mocha: Adding chocolate, extracting espresso, steaming milk...",
+         {30, 20, 1, 100, 30}},
+    }};
+    static constexpr std::array<int, StaticIngredients::COUNT> INITIAL_STOCK = {200, 500, 50, 1000, 2000};
+    static constexpr std::array<int, StaticIngredients::COUNT> THRESHOLDS = {50, 100, 10, 200, 500};
+};
+
+template <typename Menu>
+class BasicCoffeeMachine {
+public:
+    static constexpr size_t MENU_SIZE = Menu::RECIPES.size();
+    static constexpr size_t INGREDIENTS = StaticIngredients::COUNT;
+
+    enum class State {
+        IDLE,
+        SELECTING,
+        PROCESSING,
+        DISPENSING
+    };
+
+private:
+    std::array<int, INGREDIENTS> levels;
+    State state;
+    int selected; // menu index of the pending order, -1 if none
+    bool isOperational;
+    std::vector<InventoryObserver*> observers;
+
+    // Call f(std::integral_constant<size_t, I>) for the I matching index
+    template <typename F, size_t... I>
+    static bool dispatch(size_t index, F&& f, std::index_sequence<I...>) {
+        return ((index == I ? (f(std::integral_constant<size_t, I>{}), true) : false) || ...);
+    }
+
+    template <typename F>
+    static bool dispatch(size_t index, F&& f) {
+        return dispatch(index, std::forward<F>(f), std::make_index_sequence<MENU_SIZE>{});
+    }
+
+    template <size_t I, size_t... K>
+    bool availableImpl(std::index_sequence<K...>) const {
+        return ((Menu::RECIPES[I].amounts[K] == 0 || levels[K] >= Menu::RECIPES[I].amounts[K]) && ...);
+    }
+
+    template <size_t I>
+    bool available() const {
+        return availableImpl<I>(std::make_index_sequence<INGREDIENTS>{});
+    }
+
+    template <size_t I, size_t K>
+    void consumeOne() {
+        constexpr int amount = Menu::RECIPES[I].amounts[K];
+        if constexpr (amount > 0) {
+            levels[K] -= amount;
+            if (levels[K] <= Menu::THRESHOLDS[K]) {
+                notifyObservers(StaticIngredients::NAMES[K], levels[K], Menu::THRESHOLDS[K]);
+            }
+        }
+    }
+
+    // Recipe ingredients first, then the cup - same order as Inventory
+    template <size_t I, size_t... K>
+    void consumeImpl(std::index_sequence<K...>) {
+        ((K != StaticIngredients::CUPS ? consumeOne<I, K>() : void()), ...);
+        consumeOne<I, StaticIngredients::CUPS>();
+    }
+
+    template <size_t I>
+    void consume() {
+        consumeImpl<I>(std::make_index_sequence<INGREDIENTS>{});
+    }
+
+    void notifyObservers(const std::string& ingredient, int currentLevel, int threshold) {
+        for (auto* observer : observers) {
+            observer->update(ingredient, currentLevel, threshold);
+        }
+    }
+
+    void resetOrder() {
+        selected = -1;
+        state = State::IDLE;
+    }
+
+    // Processing + Dispensing for the paid order
+    template <size_t I>
+    void brew() {
+        constexpr const StaticRecipe& recipe = Menu::RECIPES[I];
+        state = State::PROCESSING;
+        std::cout << "\nProcessing your order...\n";
+        std::cout << recipe.preparation << "\n";
+        std::cout << "Please wait " << recipe.preparationTime << " seconds...\n";
+        consume<I>();
+
+        state = State::DISPENSING;
+        std::cout << "\n*** Your " << recipe.name << " is ready! ***\n";
+        std::cout << "Please collect your coffee from the dispenser.\n";
+        std::cout << "Thank you for your purchase!\n\n";
+        resetOrder();
+    }
+
+    template <typename Pay>
+    void payForSelection(Pay&& pay) {
+        bool paid = false;
+        dispatch(static_cast<size_t>(selected), [&](auto index) {
+            constexpr size_t I = decltype(index)::value;
+            if (pay(Menu::RECIPES[I].price)) {
+                paid = true;
+                brew<I>();
+            }
+        });
+        if (!paid) {
+            std::cout << "Payment failed. Please try again or cancel.\n";
+        }
+    }
+
+    // Shared guard for both makePayment overloads; true if payment may proceed
+    bool acceptsPayment() const {
+        if (!isOperational) {
+            std::cout << "Machine is under maintenance. Please try later.\n";
+            return false;
+        }
+        switch (state) {
+            case State::IDLE:
+                std::cout << "Please select a coffee first.\n";
+                return false;
+            case State::PROCESSING:
+                std::cout << "Payment already received. Processing order.\n";
+                return false;
+            case State::DISPENSING:
+                std::cout << "Please collect your coffee first.\n";
+                return false;
+            case State::SELECTING:
+                break;
+        }
+        return true;
+    }
+
+public:
+    BasicCoffeeMachine()
+        : levels(Menu::INITIAL_STOCK), state(State::IDLE), selected(-1), isOperational(true) {}
+
+    BasicCoffeeMachine(const BasicCoffeeMachine&) = delete;
+    BasicCoffeeMachine& operator=(const BasicCoffeeMachine&) = delete;
+
+    void selectCoffee(int choice) {
+        if (!isOperational) {
+            std::cout << "Machine is under maintenance. Please try later.\n";
+            return;
+        }
+        switch (state) {
+            case State::SELECTING:
+                std::cout << "Coffee already selected. Please make payment or cancel.\n";
+                return;
+            case State::PROCESSING:
+                std::cout << "Machine is processing. Please wait.\n";
+                return;
+            case State::DISPENSING:
+                std::cout << "Please collect your coffee first.\n";
+                return;
+            case State::IDLE:
+                break;
+        }
+
+        size_t index = static_cast<size_t>(choice - 1);
+        bool known = dispatch(index, [&](auto idx) {
+            constexpr size_t I = decltype(idx)::value;
+            constexpr const StaticRecipe& recipe = Menu::RECIPES[I];
+            if (available<I>()) {
+                std::cout << "Selected: " << recipe.name << "\n";
+                std::cout << "Price: $" << Dollars{recipe.price} << "\n";
+                selected = static_cast<int>(I);
+                state = State::SELECTING;
+            } else {
+                std::cout << "Sorry, " << recipe.name
+                          << " is currently unavailable due to low ingredients.\n";
+            }
+        });
+        if (!known) {
+            std::cout << "Sorry, Unknown is currently unavailable due to low ingredients.\n";
+        }
+    }
+
+    // Static dispatch: the concrete payment type's pay() is called directly
+    template <typename Payment,
+              typename = std::enable_if_t<std::is_base_of_v<PaymentStrategy, std::decay_t<Payment>> &&
+                                          !std::is_abstract_v<std::decay_t<Payment>>>>
+    void makePayment(Payment&& payment) {
+        using Concrete = std::decay_t<Payment>;
+        if (!acceptsPayment()) return;
+        payForSelection([&payment](double amount) { return payment.Concrete::pay(amount); });
+    }
+
+    // Drop-in compatible with CoffeeMachine::makePayment
+    void makePayment(std::unique_ptr<PaymentStrategy> payment) {
+        if (!acceptsPayment()) return;
+        payForSelection([&payment](double amount) { return payment->pay(amount); });
+    }
+
+    void cancelOrder() {
+        switch (state) {
+            case State::IDLE:
+                std::cout << "Nothing to cancel.\n";
+                break;
+            case State::SELECTING:
+                std::cout << "Order cancelled.\n";
+                resetOrder();
+                break;
+            case State::PROCESSING:
+                std::cout << "Cannot cancel. Order is being processed.\n";
+                break;
+            case State::DISPENSING:
+                std::cout << "Cannot cancel. Coffee is being dispensed.\n";
+                break;
+        }
+    }
+
+    void displayMenu() const {
+        std::cout << "\n========== COFFEE MENU ==========\n";
+        for (size_t i = 0; i < MENU_SIZE; ++i) {
+            std::cout << (i + 1) << ". " << Menu::RECIPES[i].name
+                      << " - $" << Dollars{Menu::RECIPES[i].price} << "\n";
+        }
+        std::cout << "==================================\n";
+    }
+
+    void displayStatus() const {
+        std::cout << "\n===== MACHINE STATUS =====\n";
+        std::cout << "State: " << getStateName() << "\n";
+        std::cout << "Operational: " << (isOperational ? "Yes" : "No (Maintenance)") << "\n";
+        if (selected >= 0) {
+            std::cout << "Selected: " << Menu::RECIPES[static_cast<size_t>(selected)].name << "\n";
+        }
+        std::cout << "==========================\n";
+    }
+
+    void displayInventory() const {
+        std::cout << "\n========== INVENTORY STATUS ==========\n";
+        for (size_t i = 0; i < INGREDIENTS; ++i) {
+            std::string status = levels[i] <= Menu::THRESHOLDS[i] ? " [LOW]" : "";
+            std::cout << std::left << std::setw(15) << StaticIngredients::NAMES[i]
+                      << ": " << levels[i] << status << "\n";
+        }
+        std::cout << "=======================================\n";
+    }
+
+    void refillIngredient(const std::string& ingredient, int amount) {
+        for (size_t i = 0; i < INGREDIENTS; ++i) {
+            if (ingredient == StaticIngredients::NAMES[i]) {
+                int current = levels[i];
+                levels[i] += amount;
+                std::cout << "Refilled " << ingredient << ": " << current
+                          << " + " << amount << " = " << levels[i] << "\n";
+                return;
+            }
+        }
+        std::cout << "Unknown ingredient: " << ingredient << "\n";
+    }
+
+    const char* getStateName() const {
+        switch (state) {
+            case State::IDLE: return "Idle";
+            case State::SELECTING: return "Selecting";
+            case State::PROCESSING: return "Processing";
+            case State::DISPENSING: return "Dispensing";
+        }
+        return "Unknown";
+    }
+
+    State getState() const { return state; }
+    int getLevel(size_t ingredient) const { return levels[ingredient]; }
+
+    bool getIsOperational() const { return isOperational; }
+    void setOperational(bool operational) { isOperational = operational; }
+
+    void registerObserver(InventoryObserver* observer) {
+        observers.push_back(observer);
+    }
+
+    void removeObserver(InventoryObserver* observer) {
+        observers.erase(
+            std::remove(observers.begin(), observers.end(), observer),
+            observers.end()
+        );
+    }
+};
+
+using StaticCoffeeMachine = BasicCoffeeMachine<DefaultMenu>;
+
+#endif // STATIC_COFFEE_MACHINE_HPP
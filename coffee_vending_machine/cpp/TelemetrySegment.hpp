@@ -0,0 +1,275 @@
+#ifndef TELEMETRY_SEGMENT_HPP
+#define TELEMETRY_SEGMENT_HPP
+
+#include "Seqlock.hpp"
+#include "MachineEventLog.hpp"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+// Shared-memory telemetry - each machine's state is published into a POSIX
+// shared-memory segment that external monitoring processes map read-only.
+//
+//   [TelemetryHeader][Seqlock<TelemetryRecord>] x capacity
+//
+// Every slot is a Seqlock (see Seqlock.hpp): the order thread overwrites its
+// record without waiting, a reader copies it and retries if a write raced
+// the copy. Polling thousands of machines is a loop of memory reads - no
+// syscalls, no IPC round-trips, nothing the order path can block on.
+// The header carries a magic and layout version so readers built against a
+// different record layout refuse the segment instead of misreading it.
+
+struct TelemetryRecord {
+    static constexpr size_t MAX_INGREDIENTS = 8;
+
+    uint64_t machineId = 0;
+    uint64_t updatedAtNs = 0;       // system clock, comparable across processes
+    char stateName[16] = {};
+    uint8_t operational = 1;
+    int8_t selectedType = -1;
+    uint16_t ingredientCount = 0;
+    int32_t levels[MAX_INGREDIENTS] = {};
+    int32_t thresholds[MAX_INGREDIENTS] = {};
+    uint64_t selections = 0;
+    uint64_t paymentsAccepted = 0;
+    uint64_t paymentsDeclined = 0;
+    uint64_t cancellations = 0;
+    uint64_t dispensed = 0;
+    uint64_t queued = 0;
+    int64_t revenueCents = 0;
+};
+
+struct alignas(64) TelemetryHeader {
+    static constexpr uint64_t MAGIC = 0x434f464645544c4dULL; // "COFFETLM"
+    static constexpr uint32_t LAYOUT_VERSION = 1;
+    static constexpr size_t NAME_LENGTH = 16;
+
+    std::atomic<uint64_t> magic;     // stored last by the creator
+    uint32_t layoutVersion;
+    uint32_t slotBytes;
+    uint32_t capacity;
+    std::atomic<uint32_t> machineCount;
+    uint32_t ingredientCount;
+    uint32_t writerPid;
+    char ingredientNames[TelemetryRecord::MAX_INGREDIENTS][NAME_LENGTH];
+};
+
+using TelemetrySlot = Seqlock<TelemetryRecord>;
+
+// Writer for one machine's slot. Keeps a private copy of the record so each
+// update only touches the fields that changed before republishing it.
+class MachineTelemetry {
+private:
+    TelemetrySlot* slot;
+    TelemetryRecord record;
+
+    void publish() {
+        record.updatedAtNs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count());
+        slot->store(record);
+    }
+
+public:
+    MachineTelemetry(TelemetrySlot* machineSlot, uint64_t machineId) : slot(machineSlot) {
+        record.machineId = machineId;
+        publish();
+    }
+
+    void publishStatus(const char* stateName, bool operational, int selectedType) {
+        // The rest of the field is cleared, so a shorter name leaves no tail
+        size_t length = strnlen(stateName, sizeof(record.stateName) - 1);
+        std::memcpy(record.stateName, stateName, length);
+        std::memset(record.stateName + length, 0, sizeof(record.stateName) - length);
+        record.operational = operational ? 1 : 0;
+        record.selectedType = static_cast<int8_t>(selectedType);
+        publish();
+    }
+
+    void publishLevels(const int* levels, const int* thresholds, uint32_t count) {
+        record.ingredientCount = static_cast<uint16_t>(std::min<uint32_t>(count, TelemetryRecord::MAX_INGREDIENTS));
+        for (uint16_t i = 0; i < record.ingredientCount; ++i) {
+            record.levels[i] = levels[i];
+            record.thresholds[i] = thresholds[i];
+        }
+        publish();
+    }
+
+    // Counters follow the machine's event stream (see MachineEventLog.hpp);
+    // they ride along with the next status/level publish
+    void count(MachineEventType type, int arg, double value) {
+        switch (type) {
+            case MachineEventType::SELECT: record.selections++; break;
+            case MachineEventType::PAYMENT:
+                if (arg) {
+                    record.paymentsAccepted++;
+                    record.revenueCents += static_cast<int64_t>(value * 100.0 + 0.5);
+                } else {
+                    record.paymentsDeclined++;
+                }
+                break;
+            case MachineEventType::CANCEL: record.cancellations++; break;
+            case MachineEventType::DISPENSE: record.dispensed++; break;
+            case MachineEventType::QUEUE: record.queued++; break;
+            default: break;
+        }
+    }
+
+    uint64_t getMachineId() const { return record.machineId; }
+};
+
+// Owner (create) or reader (open) of a telemetry segment
+class TelemetrySegment {
+private:
+    std::string name;
+    void* base;
+    size_t size;
+    bool owner;
+    std::vector<std::unique_ptr<MachineTelemetry>> writers;
+
+    TelemetrySegment(std::string segmentName, void* mapping, size_t bytes, bool isOwner)
+        : name(std::move(segmentName)), base(mapping), size(bytes), owner(isOwner) {}
+
+    static size_t slotOffset() {
+        return (sizeof(TelemetryHeader) + alignof(TelemetrySlot) - 1) / alignof(TelemetrySlot)
+               * alignof(TelemetrySlot);
+    }
+
+    static size_t bytesFor(uint32_t capacity) {
+        return slotOffset() + static_cast<size_t>(capacity) * sizeof(TelemetrySlot);
+    }
+
+    TelemetryHeader* header() const { return static_cast<TelemetryHeader*>(base); }
+
+    TelemetrySlot* slot(uint32_t index) const {
+        return reinterpret_cast<TelemetrySlot*>(static_cast<char*>(base) + slotOffset()) + index;
+    }
+
+public:
+    ~TelemetrySegment() {
+        writers.clear();
+        if (base) munmap(base, size);
+    }
+
+    TelemetrySegment(const TelemetrySegment&) = delete;
+    TelemetrySegment& operator=(const TelemetrySegment&) = delete;
+
+    // Create (or replace) a segment with room for `capacity` machines.
+    // Reports failures via perror and returns nullptr.
+    static std::unique_ptr<TelemetrySegment> create(const std::string& segmentName, uint32_t capacity) {
+        int fd = shm_open(segmentName.c_str(), O_CREAT | O_RDWR | O_TRUNC, 0644);
+        if (fd < 0) {
+            std::perror("shm_open");
+            return nullptr;
+        }
+        size_t bytes = bytesFor(capacity);
+        if (ftruncate(fd, static_cast<off_t>(bytes)) < 0) {
+            std::perror("ftruncate");
+            ::close(fd);
+            return nullptr;
+        }
+        void* mapping = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (mapping == MAP_FAILED) {
+            std::perror("mmap");
+            return nullptr;
+        }
+
+        auto* hdr = new (mapping) TelemetryHeader();
+        hdr->layoutVersion = TelemetryHeader::LAYOUT_VERSION;
+        hdr->slotBytes = sizeof(TelemetrySlot);
+        hdr->capacity = capacity;
+        hdr->machineCount.store(0, std::memory_order_relaxed);
+        hdr->ingredientCount = 0;
+        hdr->writerPid = static_cast<uint32_t>(getpid());
+        std::unique_ptr<TelemetrySegment> segment(new TelemetrySegment(segmentName, mapping, bytes, true));
+        for (uint32_t i = 0; i < capacity; ++i) {
+            new (segment->slot(i)) TelemetrySlot();
+        }
+        hdr->magic.store(TelemetryHeader::MAGIC, std::memory_order_release);
+        return segment;
+    }
+
+    // Map an existing segment read-only; nullptr if missing or incompatible
+    static std::unique_ptr<TelemetrySegment> open(const std::string& segmentName) {
+        int fd = shm_open(segmentName.c_str(), O_RDONLY, 0);
+        if (fd < 0) {
+            std::perror("shm_open");
+            return nullptr;
+        }
+        struct stat info;
+        if (fstat(fd, &info) < 0 || static_cast<size_t>(info.st_size) < sizeof(TelemetryHeader)) {
+            std::fprintf(stderr, "%s: not a telemetry segment\n", segmentName.c_str());
+            ::close(fd);
+            return nullptr;
+        }
+        size_t bytes = static_cast<size_t>(info.st_size);
+        void* mapping = mmap(nullptr, bytes, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (mapping == MAP_FAILED) {
+            std::perror("mmap");
+            return nullptr;
+        }
+
+        std::unique_ptr<TelemetrySegment> segment(new TelemetrySegment(segmentName, mapping, bytes, false));
+        const TelemetryHeader* hdr = segment->header();
+        if (hdr->magic.load(std::memory_order_acquire) != TelemetryHeader::MAGIC ||
+            hdr->layoutVersion != TelemetryHeader::LAYOUT_VERSION ||
+            hdr->slotBytes != sizeof(TelemetrySlot) ||
+            bytesFor(hdr->capacity) > bytes) {
+            std::fprintf(stderr, "%s: incompatible telemetry layout\n", segmentName.c_str());
+            return nullptr;
+        }
+        return segment;
+    }
+
+    // Writer side: claim the next slot for a machine
+    MachineTelemetry* addMachine(uint64_t machineId, const std::vector<std::string>& ingredientNames) {
+        TelemetryHeader* hdr = header();
+        uint32_t index = hdr->machineCount.load(std::memory_order_relaxed);
+        if (!owner || index >= hdr->capacity) return nullptr;
+
+        if (index == 0) {
+            hdr->ingredientCount = static_cast<uint32_t>(
+                std::min<size_t>(ingredientNames.size(), TelemetryRecord::MAX_INGREDIENTS));
+            for (uint32_t i = 0; i < hdr->ingredientCount; ++i) {
+                std::strncpy(hdr->ingredientNames[i], ingredientNames[i].c_str(),
+                             TelemetryHeader::NAME_LENGTH - 1);
+            }
+        }
+        writers.push_back(std::make_unique<MachineTelemetry>(slot(index), machineId));
+        hdr->machineCount.store(index + 1, std::memory_order_release);
+        return writers.back().get();
+    }
+
+    // Reader side
+    uint32_t getMachineCount() const { return header()->machineCount.load(std::memory_order_acquire); }
+    uint32_t getCapacity() const { return header()->capacity; }
+    uint32_t getWriterPid() const { return header()->writerPid; }
+    uint32_t getIngredientCount() const { return header()->ingredientCount; }
+    const char* getIngredientName(uint32_t index) const { return header()->ingredientNames[index]; }
+
+    TelemetryRecord read(uint32_t index) const { return slot(index)->load(); }
+
+    // Number of updates a slot has seen (cheap change detection)
+    uint64_t version(uint32_t index) const { return slot(index)->version(); }
+
+    // Owner only: remove the name so new readers cannot attach
+    void unlink() {
+        if (owner) shm_unlink(name.c_str());
+    }
+
+    const std::string& getName() const { return name; }
+};
+
+#endif // TELEMETRY_SEGMENT_HPP
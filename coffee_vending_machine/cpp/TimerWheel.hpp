@@ -0,0 +1,260 @@
+#ifndef TIMER_WHEEL_HPP
+#define TIMER_WHEEL_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+// Hierarchical timer wheel for per-session deadlines (selection timeouts,
+// ingredient holds, payment retry windows). LEVELS wheels of 64 slots each;
+// level L covers 64^(L+1) ticks. A timer is filed in the coarsest slot its
+// deadline needs; when a finer wheel wraps, the next slot of the coarser
+// one is cascaded down. Schedule and cancel are O(1) (unlink from an
+// intrusive list), firing is O(1) per timer plus at most LEVELS-1
+// cascades, and advancing over empty stretches skips whole slots using a
+// per-level occupancy bitmap - no scan over sessions, no thread per timer.
+//
+// Timers live in one pooled array linked by index, so millions of them cost
+// one allocation; callbacks are plain function pointers with a context
+// pointer and a 64-bit argument, as with the other hooks in this codebase.
+// A TimerId carries the slot's generation, so cancelling a timer that has
+// already fired (and whose node was reused) is a harmless no-op.
+//
+// Not thread-safe: owned by the thread that drives the machines.
+class TimerWheel {
+public:
+    using TimerId = uint64_t;                        // 0 = no timer
+    using Callback = void (*)(void* context, uint64_t arg);
+
+    static constexpr int LEVELS = 5;                 // 64^5 ticks
+    static constexpr int SLOT_BITS = 6;
+    static constexpr int SLOTS = 1 << SLOT_BITS;
+
+    struct Stats {
+        uint64_t scheduled = 0;
+        uint64_t cancelled = 0;
+        uint64_t fired = 0;
+        uint64_t cascaded = 0;                       // timers moved down a level
+        size_t live = 0;
+        size_t peakLive = 0;
+    };
+
+private:
+    static constexpr uint32_t NIL = UINT32_MAX;
+    static constexpr int64_t RANGE = int64_t(1) << (SLOT_BITS * LEVELS);
+    static constexpr int FIRING = LEVELS * SLOTS;    // list of the tick being fired
+
+    struct Node {
+        int64_t expiry = 0;                          // tick
+        Callback callback = nullptr;
+        void* context = nullptr;
+        uint64_t arg = 0;
+        uint32_t next = NIL;
+        uint32_t prev = NIL;
+        uint32_t generation = 0;
+        int32_t slot = -1;                           // level * SLOTS + index, -1 if free
+    };
+
+    int64_t tickMs;
+    int64_t current;                                 // next tick to process
+    int64_t lastNowMs;                               // as of the last advance()
+    std::vector<Node> nodes;
+    uint32_t freeList = NIL;
+    uint32_t heads[LEVELS * SLOTS + 1];
+    uint64_t occupied[LEVELS] = {};
+    Stats stats;
+
+    void link(uint32_t index) {
+        Node& node = nodes[index];
+        int64_t delta = std::max<int64_t>(node.expiry - current, 0);
+        int64_t when = delta < RANGE ? node.expiry : current + RANGE - 1; // re-filed on cascade
+        if (delta >= RANGE) delta = RANGE - 1;
+        int level = 0;
+        while (level < LEVELS - 1 && delta >= (int64_t(1) << (SLOT_BITS * (level + 1)))) level++;
+        if (delta == 0) when = current;
+        int slotIndex = static_cast<int>((when >> (SLOT_BITS * level)) & (SLOTS - 1));
+        int slot = level * SLOTS + slotIndex;
+
+        node.slot = slot;
+        node.prev = NIL;
+        node.next = heads[slot];
+        if (node.next != NIL) nodes[node.next].prev = index;
+        heads[slot] = index;
+        occupied[level] |= uint64_t(1) << slotIndex;
+    }
+
+    void unlink(uint32_t index) {
+        Node& node = nodes[index];
+        int slot = node.slot;
+        if (node.prev != NIL) nodes[node.prev].next = node.next;
+        else heads[slot] = node.next;
+        if (node.next != NIL) nodes[node.next].prev = node.prev;
+        if (heads[slot] == NIL && slot != FIRING) occupied[slot / SLOTS] &= ~(uint64_t(1) << (slot % SLOTS));
+        node.slot = -1;
+    }
+
+    void release(uint32_t index) {
+        Node& node = nodes[index];
+        node.generation++;
+        node.slot = -1;
+        node.callback = nullptr;
+        node.next = freeList;
+        freeList = index;
+        stats.live--;
+    }
+
+    // Detach a whole slot's list
+    uint32_t take(int level, int slotIndex) {
+        int slot = level * SLOTS + slotIndex;
+        uint32_t list = heads[slot];
+        heads[slot] = NIL;
+        occupied[level] &= ~(uint64_t(1) << slotIndex);
+        return list;
+    }
+
+    // Re-file every timer of a coarse slot relative to the current tick
+    void cascade(int level, int slotIndex) {
+        uint32_t index = take(level, slotIndex);
+        while (index != NIL) {
+            uint32_t next = nodes[index].next;
+            link(index);
+            stats.cascaded++;
+            index = next;
+        }
+    }
+
+    // Process tick `current`: cascade on wrap, then fire its level-0 slot
+    size_t processTick() {
+        int slotIndex = static_cast<int>(current & (SLOTS - 1));
+        if (slotIndex == 0) {
+            for (int level = 1; level < LEVELS; ++level) {
+                int coarse = static_cast<int>((current >> (SLOT_BITS * level)) & (SLOTS - 1));
+                cascade(level, coarse);
+                if (coarse != 0) break;
+            }
+        }
+        // Move the due timers to the firing list one by one, so a callback
+        // may cancel a timer due on the same tick
+        uint32_t index = take(0, slotIndex);
+        while (index != NIL) {
+            uint32_t next = nodes[index].next;
+            nodes[index].slot = FIRING;
+            nodes[index].prev = NIL;
+            nodes[index].next = heads[FIRING];
+            if (heads[FIRING] != NIL) nodes[heads[FIRING]].prev = index;
+            heads[FIRING] = index;
+            index = next;
+        }
+        current++; // timers scheduled by callbacks land on a later tick
+
+        size_t fired = 0;
+        while (heads[FIRING] != NIL) {
+            index = heads[FIRING];
+            unlink(index);
+            Node& node = nodes[index];
+            Callback callback = node.callback;
+            void* context = node.context;
+            uint64_t arg = node.arg;
+            release(index);
+            stats.fired++;
+            fired++;
+            callback(context, arg);
+        }
+        return fired;
+    }
+
+public:
+    // tickMs is the resolution; deadlines are rounded up to whole ticks
+    explicit TimerWheel(int64_t tickMillis = 10, int64_t startMs = 0)
+        : tickMs(std::max<int64_t>(tickMillis, 1)), current(startMs / std::max<int64_t>(tickMillis, 1)),
+          lastNowMs(startMs) {
+        std::fill(std::begin(heads), std::end(heads), NIL);
+    }
+
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+
+    // Pre-size the node pool so scheduling never reallocates
+    void reserve(size_t timers) { nodes.reserve(timers); }
+
+    // Run callback(context, arg) once dueMs (same clock as advance()) passes;
+    // a deadline already processed fires on the next tick
+    TimerId scheduleAt(int64_t dueMs, Callback callback, void* context, uint64_t arg = 0) {
+        uint32_t index;
+        if (freeList != NIL) {
+            index = freeList;
+            freeList = nodes[index].next;
+        } else {
+            index = static_cast<uint32_t>(nodes.size());
+            nodes.emplace_back();
+        }
+        Node& node = nodes[index];
+        node.expiry = (dueMs + tickMs - 1) / tickMs;
+        node.callback = callback;
+        node.context = context;
+        node.arg = arg;
+        link(index);
+
+        stats.scheduled++;
+        stats.live++;
+        if (stats.live > stats.peakLive) stats.peakLive = stats.live;
+        return (static_cast<uint64_t>(node.generation) << 32) | (index + 1);
+    }
+
+    // Relative to the time of the last advance()
+    TimerId scheduleAfter(int64_t delayMs, Callback callback, void* context, uint64_t arg = 0) {
+        return scheduleAt(lastNowMs + std::max<int64_t>(delayMs, 0), callback, context, arg);
+    }
+
+    // False if the timer already fired or was cancelled
+    bool cancel(TimerId id) {
+        if (id == 0) return false;
+        uint32_t index = static_cast<uint32_t>(id & 0xffffffffu) - 1;
+        if (index >= nodes.size()) return false;
+        Node& node = nodes[index];
+        if (node.generation != static_cast<uint32_t>(id >> 32) || node.slot < 0) return false;
+        unlink(index);
+        release(index);
+        stats.cancelled++;
+        return true;
+    }
+
+    // Fire everything due at or before nowMs; returns the number fired
+    size_t advance(int64_t nowMs) {
+        if (nowMs > lastNowMs) lastNowMs = nowMs;
+        int64_t target = nowMs / tickMs;
+        size_t fired = 0;
+        while (current <= target) {
+            if (stats.live == 0) {
+                current = target + 1;
+                break;
+            }
+            // Nothing left in this turn of the finest wheel: skip to its wrap
+            int slotIndex = static_cast<int>(current & (SLOTS - 1));
+            if (slotIndex != 0 && (occupied[0] >> slotIndex) == 0) {
+                current = std::min((current | (SLOTS - 1)) + 1, target + 1);
+                continue;
+            }
+            fired += processTick();
+        }
+        return fired;
+    }
+
+    // Earliest time advance() may have work, for sizing a poll timeout. Exact
+    // for level-0 timers; otherwise the next cascade point (never late).
+    int64_t nextDueMs() const {
+        if (stats.live == 0) return INT64_MAX;
+        int slotIndex = static_cast<int>(current & (SLOTS - 1));
+        uint64_t ahead = occupied[0] >> slotIndex;
+        if (ahead != 0) return (current + __builtin_ctzll(ahead)) * tickMs;
+        return ((current | (SLOTS - 1)) + 1) * tickMs;
+    }
+
+    int64_t now() const { return lastNowMs; }
+    int64_t getTickMs() const { return tickMs; }
+    size_t size() const { return stats.live; }
+    const Stats& getStats() const { return stats; }
+};
+
+#endif // TIMER_WHEEL_HPP
@@ -2,6 +2,7 @@
 #define USER_HPP
 
 #include "CoffeeMachine.hpp"
+#include "WalletStore.hpp"
 #include <string>
 #include <iostream>
 
@@ -45,6 +46,11 @@ public:
         makePayment(std::move(payment));
     }
 
+    // Pay from this user's prepaid balance in the given wallet store
+    std::unique_ptr<PaymentStrategy> walletPayment(WalletStore& wallets) const {
+        return std::make_unique<WalletPayment>(wallets, userId);
+    }
+
     // Getters
     const std::string& getUserId() const { return userId; }
     const std::string& getName() const { return name; }
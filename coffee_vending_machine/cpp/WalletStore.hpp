@@ -0,0 +1,299 @@
+#ifndef WALLET_STORE_HPP
+#define WALLET_STORE_HPP
+
+#include "PaymentStrategy.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Prepaid wallets keyed by User::getUserId().
+//
+// Accounts live in a fixed-capacity open-addressing table (linear probing,
+// power-of-two size). Opening an account claims a slot with one CAS on its
+// hash word; lookups never lock. Balances are atomic cents and debit() is a
+// compare-and-swap loop that refuses to go negative, so any number of
+// machines can charge the same wallet concurrently.
+//
+// Every balance change is appended to a ledger: a chunked, append-only log
+// whose next index is taken with fetch_add. Top-ups are queued and applied
+// in batches by settleTopUps(), e.g. when the card processor confirms them.
+class WalletStore {
+public:
+    static constexpr size_t MAX_USER_ID = 23;
+
+    enum class EntryType : uint8_t { OPEN, DEBIT, DECLINED, TOPUP };
+
+    struct LedgerEntry {
+        uint64_t sequence;
+        int64_t timestampNs;
+        uint32_t account;
+        EntryType type;
+        int64_t amountCents;
+        int64_t balanceAfterCents;
+    };
+
+    // Result of one settlement batch
+    struct Settlement {
+        size_t applied = 0;
+        size_t rejected = 0; // unknown accounts
+        int64_t totalCents = 0;
+    };
+
+private:
+    struct alignas(64) Account {
+        std::atomic<uint64_t> hash{0};      // 0 = free slot
+        std::atomic<bool> ready{false};     // key written
+        char userId[MAX_USER_ID + 1] = {};
+        std::atomic<int64_t> balanceCents{0};
+    };
+
+    static constexpr size_t CHUNK_ENTRIES = 1 << 14;
+    static constexpr size_t MAX_CHUNKS = 1 << 12;
+
+    struct Chunk {
+        LedgerEntry entries[CHUNK_ENTRIES];
+        std::atomic<bool> committed[CHUNK_ENTRIES];
+
+        Chunk() {
+            for (auto& flag : committed) flag.store(false, std::memory_order_relaxed);
+        }
+    };
+
+    struct PendingTopUp {
+        std::string userId;
+        int64_t amountCents;
+    };
+
+    size_t capacity;
+    size_t mask;
+    std::unique_ptr<Account[]> accounts;
+    std::atomic<size_t> accountCount{0};
+
+    std::unique_ptr<std::atomic<Chunk*>[]> chunks;
+    std::atomic<uint64_t> ledgerTail{0};
+
+    std::mutex topUpMutex;
+    std::vector<PendingTopUp> pendingTopUps;
+
+    // FNV-1a; never 0 so that 0 can mark a free slot
+    static uint64_t hashOf(std::string_view key) {
+        uint64_t h = 1469598103934665603ULL;
+        for (char c : key) {
+            h ^= static_cast<uint8_t>(c);
+            h *= 1099511628211ULL;
+        }
+        return h ? h : 1;
+    }
+
+    static int64_t nowNs() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+
+    Chunk* chunkFor(uint64_t index) {
+        std::atomic<Chunk*>& slot = chunks[index / CHUNK_ENTRIES];
+        Chunk* chunk = slot.load(std::memory_order_acquire);
+        if (chunk) return chunk;
+        auto fresh = std::make_unique<Chunk>();
+        if (slot.compare_exchange_strong(chunk, fresh.get(), std::memory_order_acq_rel)) {
+            return fresh.release();
+        }
+        return chunk; // another thread installed it first
+    }
+
+    void appendLedger(uint32_t account, EntryType type, int64_t amount, int64_t balanceAfter) {
+        uint64_t index = ledgerTail.fetch_add(1, std::memory_order_relaxed);
+        if (index / CHUNK_ENTRIES >= MAX_CHUNKS) return; // ledger full; balances stay exact
+        Chunk* chunk = chunkFor(index);
+        chunk->entries[index % CHUNK_ENTRIES] = {index, nowNs(), account, type, amount, balanceAfter};
+        chunk->committed[index % CHUNK_ENTRIES].store(true, std::memory_order_release);
+    }
+
+    // Slot index for userId, or -1
+    long find(std::string_view userId) const {
+        uint64_t h = hashOf(userId);
+        for (size_t probe = 0; probe < capacity; ++probe) {
+            const Account& account = accounts[(h + probe) & mask];
+            uint64_t slotHash = account.hash.load(std::memory_order_acquire);
+            if (slotHash == 0) return -1;
+            if (slotHash != h) continue;
+            while (!account.ready.load(std::memory_order_acquire)) {
+                // opener is between claiming the slot and writing the key
+            }
+            if (userId == account.userId) return static_cast<long>((h + probe) & mask);
+        }
+        return -1;
+    }
+
+public:
+    // Capacity is fixed; keep it comfortably above the expected user count
+    explicit WalletStore(size_t expectedUsers = 1024) {
+        capacity = 16;
+        while (capacity < expectedUsers * 2) capacity <<= 1;
+        mask = capacity - 1;
+        accounts = std::make_unique<Account[]>(capacity);
+        chunks = std::make_unique<std::atomic<Chunk*>[]>(MAX_CHUNKS);
+        for (size_t i = 0; i < MAX_CHUNKS; ++i) chunks[i].store(nullptr, std::memory_order_relaxed);
+    }
+
+    ~WalletStore() {
+        for (size_t i = 0; i < MAX_CHUNKS; ++i) delete chunks[i].load(std::memory_order_relaxed);
+    }
+
+    WalletStore(const WalletStore&) = delete;
+    WalletStore& operator=(const WalletStore&) = delete;
+
+    // Returns false if the id is too long, already open, or the table is full
+    bool openAccount(std::string_view userId, int64_t initialCents = 0) {
+        if (userId.empty() || userId.size() > MAX_USER_ID) return false;
+        if (accountCount.load(std::memory_order_relaxed) * 4 >= capacity * 3) return false;
+        uint64_t h = hashOf(userId);
+        for (size_t probe = 0; probe < capacity; ++probe) {
+            size_t index = (h + probe) & mask;
+            Account& account = accounts[index];
+            uint64_t expected = 0;
+            if (account.hash.compare_exchange_strong(expected, h, std::memory_order_acq_rel)) {
+                std::memcpy(account.userId, userId.data(), userId.size());
+                account.balanceCents.store(initialCents, std::memory_order_relaxed);
+                account.ready.store(true, std::memory_order_release);
+                accountCount.fetch_add(1, std::memory_order_relaxed);
+                appendLedger(static_cast<uint32_t>(index), EntryType::OPEN, initialCents, initialCents);
+                return true;
+            }
+            if (expected == h) {
+                while (!account.ready.load(std::memory_order_acquire)) {}
+                if (userId == account.userId) return false;
+            }
+        }
+        return false;
+    }
+
+    // Atomic debit; false (and nothing charged) if unknown, insufficient or
+    // negative - a negative debit would be an unsettled top-up. A zero
+    // debit (a free menu item) succeeds without touching the account.
+    // balanceAfter, if given, receives the balance this debit left, not a
+    // later re-read that a concurrent debit or top-up may already have moved.
+    bool debit(std::string_view userId, int64_t amountCents, int64_t* balanceAfter = nullptr) {
+        if (amountCents < 0) return false;
+        long index = find(userId);
+        if (index < 0) return false;
+        Account& account = accounts[static_cast<size_t>(index)];
+        int64_t balance = account.balanceCents.load(std::memory_order_acquire);
+        if (amountCents == 0) {
+            if (balanceAfter) *balanceAfter = balance;
+            return true;
+        }
+        while (true) {
+            if (balance < amountCents) {
+                appendLedger(static_cast<uint32_t>(index), EntryType::DECLINED, amountCents, balance);
+                return false;
+            }
+            if (account.balanceCents.compare_exchange_weak(balance, balance - amountCents,
+                                                           std::memory_order_acq_rel)) {
+                appendLedger(static_cast<uint32_t>(index), EntryType::DEBIT, amountCents, balance - amountCents);
+                if (balanceAfter) *balanceAfter = balance - amountCents;
+                return true;
+            }
+        }
+    }
+
+    // Queue a top-up; it becomes spendable at the next settleTopUps()
+    void requestTopUp(std::string_view userId, int64_t amountCents) {
+        std::lock_guard<std::mutex> guard(topUpMutex);
+        pendingTopUps.push_back({std::string(userId), amountCents});
+    }
+
+    Settlement settleTopUps() {
+        std::vector<PendingTopUp> batch;
+        {
+            std::lock_guard<std::mutex> guard(topUpMutex);
+            batch.swap(pendingTopUps);
+        }
+        Settlement result;
+        for (const auto& topUp : batch) {
+            long index = find(topUp.userId);
+            if (index < 0 || topUp.amountCents <= 0) {
+                result.rejected++;
+                continue;
+            }
+            int64_t after = accounts[static_cast<size_t>(index)].balanceCents.fetch_add(
+                topUp.amountCents, std::memory_order_acq_rel) + topUp.amountCents;
+            appendLedger(static_cast<uint32_t>(index), EntryType::TOPUP, topUp.amountCents, after);
+            result.applied++;
+            result.totalCents += topUp.amountCents;
+        }
+        return result;
+    }
+
+    // Balance in cents, or -1 for an unknown user
+    int64_t balance(std::string_view userId) const {
+        long index = find(userId);
+        return index < 0 ? -1 : accounts[static_cast<size_t>(index)].balanceCents.load(std::memory_order_acquire);
+    }
+
+    // Committed ledger entries in order (entries still being written by a
+    // concurrent debit are skipped)
+    std::vector<LedgerEntry> ledger(std::string_view userId = std::string_view()) const {
+        long only = userId.empty() ? -1 : find(userId);
+        std::vector<LedgerEntry> entries;
+        uint64_t tail = std::min<uint64_t>(ledgerTail.load(std::memory_order_acquire),
+                                           MAX_CHUNKS * CHUNK_ENTRIES);
+        for (uint64_t i = 0; i < tail; ++i) {
+            const Chunk* chunk = chunks[i / CHUNK_ENTRIES].load(std::memory_order_acquire);
+            if (!chunk || !chunk->committed[i % CHUNK_ENTRIES].load(std::memory_order_acquire)) continue;
+            const LedgerEntry& entry = chunk->entries[i % CHUNK_ENTRIES];
+            if (only < 0 || entry.account == static_cast<uint32_t>(only)) entries.push_back(entry);
+        }
+        return entries;
+    }
+
+    const char* accountUserId(uint32_t account) const { return accounts[account].userId; }
+    size_t getAccountCount() const { return accountCount.load(std::memory_order_relaxed); }
+    uint64_t getLedgerSize() const { return ledgerTail.load(std::memory_order_relaxed); }
+
+    static int64_t toCents(double amount) {
+        return static_cast<int64_t>(std::llround(amount * 100.0));
+    }
+};
+
+// Concrete Strategy - prepaid wallet; settles in-process with one atomic debit
+class WalletPayment : public PaymentStrategy {
+private:
+    WalletStore& wallets;
+    std::pmr::string userId;
+
+public:
+    WalletPayment(WalletStore& store, std::string_view user)
+        : wallets(store), userId(user, OrderArena::currentResource()) {}
+
+    bool pay(double amount) override {
+        int64_t left = 0;
+        if (wallets.debit(userId, WalletStore::toCents(amount), &left)) {
+            std::cout << "Payment of $" << Dollars{amount} << " accepted via Wallet (" << userId
+                      << ", balance $" << Dollars{static_cast<double>(left) / 100.0} << ").\n";
+            return true;
+        }
+        std::cout << "Wallet payment failed. Unknown account or insufficient balance.\n";
+        return false;
+    }
+
+    std::string_view getPaymentMethod() const override {
+        return "Wallet";
+    }
+
+    std::string_view getMaskedReference() const override {
+        return userId;
+    }
+};
+
+#endif // WALLET_STORE_HPP
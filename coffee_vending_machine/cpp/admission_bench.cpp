@@ -0,0 +1,202 @@
+/**
+ * Coffee Vending Machine - Admission Control Benchmark (C++)
+ *
+ * Replays a rush (Poisson arrivals above the brewer's capacity) against a
+ * machine with a coalescing BrewQueue, once accepting every selection and
+ * once behind an AdmissionController. Deferred customers come back once
+ * after the suggested delay; anyone turned away twice leaves. The operator
+ * refills on a fixed round, so stock can run out between visits.
+ * Reports served orders, order time (first arrival to cup) for the orders
+ * that were served, shed rate and queue depth.
+ *
+ * Usage: admission_bench [--minutes N] [--rate ORDERS_PER_MIN]
+ *                        [--target-s N] [--max-s N] [--max-depth N]
+ *                        [--refill-min N] [--seed N]
+ */
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <queue>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "ConsoleGuard.hpp"
+#include "CoffeeMachine.hpp"
+#include "Operator.hpp"
+#include "AdmissionController.hpp"
+
+static int64_t simulatedNow = 0;
+static int64_t simulatedClock() { return simulatedNow; }
+
+struct Visit {
+    int64_t at;
+    int64_t firstArrival;
+    int choice;
+    bool retry;
+
+    bool operator>(const Visit& other) const { return at > other.at; }
+};
+
+class WaitCollector : public BrewObserver {
+public:
+    std::vector<int64_t> waits;
+    std::vector<int64_t> firstArrivals; // by order number
+
+    void onOrderCompleted(const BrewCompletion& completion) override {
+        waits.push_back(completion.completedAt - firstArrivals[completion.orderId]);
+    }
+};
+
+struct RunResult {
+    size_t served = 0;
+    size_t unavailable = 0;
+    size_t walkedAway = 0;
+    size_t retriesServed = 0;
+    double meanWaitSec = 0.0;
+    double p95WaitSec = 0.0;
+    double maxWaitSec = 0.0;
+    AdmissionController::Stats admission;
+    size_t peakDepth = 0;
+};
+
+static RunResult runSession(const std::vector<Visit>& arrivals, int64_t refillEveryMs,
+                            AdmissionController* controller) {
+    simulatedNow = 0;
+    auto machine = CoffeeMachine::create();
+    BrewQueue queue(machine->getInventory());
+    queue.setTimeSource(&simulatedClock);
+    machine->attachBrewQueue(&queue);
+    machine->attachAdmission(controller);
+    WaitCollector collector;
+    collector.firstArrivals.push_back(0); // order numbers start at 1
+    queue.addObserver(&collector);
+
+    std::priority_queue<Visit, std::vector<Visit>, std::greater<Visit>> visits(arrivals.begin(), arrivals.end());
+    RunResult result;
+    int64_t nextRefill = refillEveryMs;
+    ConsoleGuard quiet;
+    while (!visits.empty() || !queue.isIdle()) {
+        int64_t visitAt = visits.empty() ? INT64_MAX : visits.top().at;
+        int64_t due = std::min({visitAt, queue.nextDueTime(), nextRefill});
+        simulatedNow = std::max(simulatedNow, due);
+        queue.poll();
+        if (simulatedNow >= nextRefill) {
+            for (const auto& [ingredient, amount] : Operator::getRefillAmounts()) {
+                machine->getInventory()->refillIngredient(ingredient, amount);
+            }
+            nextRefill += refillEveryMs;
+            if (visits.empty()) nextRefill = INT64_MAX;
+        }
+        if (visits.empty() || visits.top().at > simulatedNow) continue;
+
+        Visit visit = visits.top();
+        visits.pop();
+        machine->selectCoffee(visit.choice);
+        if (machine->getSelectedCoffee() == nullptr) {
+            ShedReason reason = controller ? controller->getLastDecision().reason : ShedReason::STOCK;
+            if (reason == ShedReason::NONE || reason == ShedReason::STOCK) {
+                result.unavailable++;
+            } else if (controller->getLastDecision().verdict == AdmissionVerdict::DEFER && !visit.retry) {
+                int64_t retryAfter = controller->getLastDecision().retryAfterMs;
+                visits.push({simulatedNow + retryAfter, visit.firstArrival, visit.choice, true});
+            } else {
+                result.walkedAway++;
+            }
+            continue;
+        }
+        collector.firstArrivals.push_back(visit.firstArrival);
+        machine->makePayment(std::make_unique<CashPayment>(10.00));
+        if (visit.retry) result.retriesServed++;
+        result.peakDepth = std::max(result.peakDepth, queue.getDepth());
+        queue.poll();
+    }
+
+    if (controller) result.admission = controller->getStats();
+    std::vector<int64_t> waits = collector.waits;
+    std::sort(waits.begin(), waits.end());
+    result.served = waits.size();
+    double total = 0.0;
+    for (int64_t w : waits) total += static_cast<double>(w);
+    if (!waits.empty()) {
+        result.meanWaitSec = total / static_cast<double>(waits.size()) / 1000.0;
+        result.p95WaitSec = static_cast<double>(waits[waits.size() * 95 / 100]) / 1000.0;
+        result.maxWaitSec = static_cast<double>(waits.back()) / 1000.0;
+    }
+    return result;
+}
+
+static void printResult(const char* label, const RunResult& r, bool controlled) {
+    std::cout << label << "\n"
+              << "  served " << r.served << " (" << r.retriesServed << " on a second visit), "
+              << r.unavailable << " out of stock, " << r.walkedAway << " turned away\n"
+              << "  order time mean " << std::setprecision(1) << r.meanWaitSec << " s, p95 "
+              << r.p95WaitSec << " s, max " << r.maxWaitSec << " s\n"
+              << "  peak queue depth " << r.peakDepth << "\n";
+    if (!controlled) return;
+    const AdmissionController::Stats& s = r.admission;
+    std::cout << "  admission: " << s.evaluated << " evaluated, " << s.admitted << " admitted, "
+              << s.deferred << " deferred, rejected " << s.rejectedWait << " wait / " << s.rejectedDepth
+              << " depth / " << s.rejectedStock << " stock\n"
+              << "  shed rate " << std::setprecision(1) << s.shedRate() * 100.0 << "%, mean depth at arrival "
+              << s.meanQueueDepth() << "\n";
+}
+
+int main(int argc, char* argv[]) {
+    int minutes = 60;
+    double rate = 6.0;
+    int refillMinutes = 5;
+    unsigned seed = 17;
+    AdmissionConfig config;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--minutes") == 0 && i + 1 < argc) {
+            minutes = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--rate") == 0 && i + 1 < argc) {
+            rate = std::max(0.1, std::atof(argv[++i]));
+        } else if (std::strcmp(argv[i], "--target-s") == 0 && i + 1 < argc) {
+            config.targetWaitMs = std::max(1L, std::atol(argv[++i])) * 1000;
+        } else if (std::strcmp(argv[i], "--max-s") == 0 && i + 1 < argc) {
+            config.maxWaitMs = std::max(1L, std::atol(argv[++i])) * 1000;
+        } else if (std::strcmp(argv[i], "--max-depth") == 0 && i + 1 < argc) {
+            config.maxQueueDepth = static_cast<size_t>(std::max(1L, std::atol(argv[++i])));
+        } else if (std::strcmp(argv[i], "--refill-min") == 0 && i + 1 < argc) {
+            refillMinutes = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = static_cast<unsigned>(std::atoi(argv[++i]));
+        } else {
+            std::cerr << "Usage: " << argv[0]
+                      << " [--minutes N] [--rate ORDERS_PER_MIN] [--target-s N] [--max-s N]\n"
+                      << "       [--max-depth N] [--refill-min N] [--seed N]\n";
+            return 1;
+        }
+    }
+
+    std::mt19937 rng(seed);
+    std::exponential_distribution<double> gap(rate / 60000.0);
+    std::discrete_distribution<int> drink({10, 20, 50, 10, 10});
+    std::vector<Visit> arrivals;
+    for (double t = gap(rng); t < minutes * 60000.0; t += gap(rng)) {
+        int64_t at = static_cast<int64_t>(t);
+        arrivals.push_back({at, at, drink(rng) + 1, false});
+    }
+
+    std::cout << "Rush: " << arrivals.size() << " customers over " << minutes << " min (" << std::fixed
+              << std::setprecision(1) << rate << "/min), refill every " << refillMinutes << " min\n\n";
+
+    RunResult unbounded = runSession(arrivals, refillMinutes * 60000LL, nullptr);
+    AdmissionController controller(config);
+    RunResult controlled = runSession(arrivals, refillMinutes * 60000LL, &controller);
+
+    printResult("Accept everything:", unbounded, false);
+    std::cout << "\n";
+    std::string label = "Admission control (target " + std::to_string(config.targetWaitMs / 1000) + " s, max "
+                      + std::to_string(controller.getConfig().maxWaitMs / 1000) + " s, depth "
+                      + std::to_string(config.maxQueueDepth) + "):";
+    printResult(label.c_str(), controlled, true);
+    return 0;
+}
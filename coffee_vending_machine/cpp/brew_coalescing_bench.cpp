@@ -0,0 +1,177 @@
+/**
+ * Coffee Vending Machine - Brew Coalescing Benchmark (C++)
+ *
+ * Replays a simulated office rush hour (Poisson arrivals, skewed drink mix)
+ * against a machine whose paid orders go through a BrewQueue, once with
+ * coalescing disabled (one cup per cycle, as ProcessingState brews today)
+ * and once with a coalescing window. Both runs see the same arrivals.
+ * Reports cups per brewer-hour, makespan throughput and order wait times.
+ *
+ * Usage: brew_coalescing_bench [--minutes N] [--rate ORDERS_PER_MIN]
+ *                              [--window-ms N] [--max-cups N]
+ *                              [--extra-cup-percent N] [--mix E,C,L,A,M] [--seed N]
+ */
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "ConsoleGuard.hpp"
+#include "CoffeeMachine.hpp"
+#include "Operator.hpp"
+#include "BrewQueue.hpp"
+
+static int64_t simulatedNow = 0;
+static int64_t simulatedClock() { return simulatedNow; }
+
+struct Arrival {
+    int64_t at;
+    int choice;
+};
+
+class WaitCollector : public BrewObserver {
+public:
+    std::vector<int64_t> waits;
+    int64_t lastCompletion = 0;
+
+    void onOrderCompleted(const BrewCompletion& completion) override {
+        waits.push_back(completion.completedAt - completion.enqueuedAt);
+        lastCompletion = std::max(lastCompletion, completion.completedAt);
+    }
+};
+
+struct RunResult {
+    BrewQueue::Stats stats;
+    uint64_t refills = 0;
+    double meanWaitSec = 0.0;
+    double p95WaitSec = 0.0;
+    int64_t makespanMs = 0;
+};
+
+static RunResult runSession(const std::vector<Arrival>& arrivals, const BrewQueueConfig& config) {
+    simulatedNow = 0;
+    auto machine = CoffeeMachine::create();
+    BrewQueue queue(machine->getInventory(), config);
+    queue.setTimeSource(&simulatedClock);
+    machine->attachBrewQueue(&queue);
+    WaitCollector collector;
+    queue.addObserver(&collector);
+
+    RunResult result;
+    ConsoleGuard quiet;
+    size_t next = 0;
+    while (next < arrivals.size() || !queue.isIdle()) {
+        int64_t arrivalAt = next < arrivals.size() ? arrivals[next].at : INT64_MAX;
+        simulatedNow = std::max(simulatedNow, std::min(arrivalAt, queue.nextDueTime()));
+        queue.poll();
+        if (next < arrivals.size() && arrivals[next].at <= simulatedNow) {
+            CoffeeType type = static_cast<CoffeeType>(arrivals[next].choice - 1);
+            if (!machine->getInventory()->checkAvailability(type)) {
+                for (const auto& [ingredient, amount] : Operator::getRefillAmounts()) {
+                    machine->getInventory()->refillIngredient(ingredient, amount);
+                }
+                result.refills++;
+            }
+            machine->selectCoffee(arrivals[next].choice);
+            machine->makePayment(std::make_unique<CashPayment>(10.00));
+            queue.poll();
+            next++;
+        }
+    }
+
+    result.stats = queue.getStats();
+    std::vector<int64_t> waits = collector.waits;
+    std::sort(waits.begin(), waits.end());
+    double total = 0.0;
+    for (int64_t w : waits) total += static_cast<double>(w);
+    if (!waits.empty()) {
+        result.meanWaitSec = total / static_cast<double>(waits.size()) / 1000.0;
+        result.p95WaitSec = static_cast<double>(waits[waits.size() * 95 / 100]) / 1000.0;
+    }
+    result.makespanMs = collector.lastCompletion - (arrivals.empty() ? 0 : arrivals.front().at);
+    return result;
+}
+
+static void printResult(const char* label, const RunResult& r) {
+    double brewerHours = static_cast<double>(r.stats.brewingMs) / 3600000.0;
+    double makespanHours = static_cast<double>(r.makespanMs) / 3600000.0;
+    std::cout << label << "\n"
+              << "  orders " << r.stats.ordersCompleted << " in " << r.stats.cycles << " cycles ("
+              << std::setprecision(2) << static_cast<double>(r.stats.ordersCompleted) / r.stats.cycles
+              << " cups/cycle), " << r.refills << " refills\n"
+              << "  cups per brewer-hour : " << std::setprecision(1)
+              << static_cast<double>(r.stats.ordersCompleted) / brewerHours << "\n"
+              << "  cups per hour (makespan " << std::setprecision(1) << makespanHours * 60 << " min): "
+              << static_cast<double>(r.stats.ordersCompleted) / makespanHours << "\n"
+              << "  wait mean " << r.meanWaitSec << " s, p95 " << r.p95WaitSec << " s\n";
+}
+
+int main(int argc, char* argv[]) {
+    int minutes = 60;
+    double rate = 2.5;
+    BrewQueueConfig config;
+    std::vector<double> mix = {10, 20, 50, 10, 10};
+    unsigned seed = 11;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--minutes") == 0 && i + 1 < argc) {
+            minutes = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--rate") == 0 && i + 1 < argc) {
+            rate = std::max(0.1, std::atof(argv[++i]));
+        } else if (std::strcmp(argv[i], "--window-ms") == 0 && i + 1 < argc) {
+            config.windowMs = std::max(0L, std::atol(argv[++i]));
+        } else if (std::strcmp(argv[i], "--max-cups") == 0 && i + 1 < argc) {
+            config.maxCupsPerCycle = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--extra-cup-percent") == 0 && i + 1 < argc) {
+            config.extraCupPercent = std::max(0, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--mix") == 0 && i + 1 < argc) {
+            mix.clear();
+            std::stringstream ss(argv[++i]);
+            std::string item;
+            while (std::getline(ss, item, ',')) mix.push_back(std::atof(item.c_str()));
+            if (mix.size() != static_cast<size_t>(CoffeeType::COUNT)) {
+                std::cerr << "--mix needs " << static_cast<int>(CoffeeType::COUNT) << " weights\n";
+                return 1;
+            }
+        } else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = static_cast<unsigned>(std::atoi(argv[++i]));
+        } else {
+            std::cerr << "Usage: " << argv[0]
+                      << " [--minutes N] [--rate ORDERS_PER_MIN] [--window-ms N] [--max-cups N]\n"
+                      << "       [--extra-cup-percent N] [--mix E,C,L,A,M] [--seed N]\n";
+            return 1;
+        }
+    }
+
+    std::mt19937 rng(seed);
+    std::exponential_distribution<double> gap(rate / 60000.0);
+    std::discrete_distribution<int> drink(mix.begin(), mix.end());
+    std::vector<Arrival> arrivals;
+    for (double t = gap(rng); t < minutes * 60000.0; t += gap(rng)) {
+        arrivals.push_back({static_cast<int64_t>(t), drink(rng) + 1});
+    }
+
+    std::cout << "Rush hour: " << arrivals.size() << " orders over " << minutes
+              << " min (" << rate << "/min)\n\n";
+
+    BrewQueueConfig single = config;
+    single.windowMs = 0;
+    single.maxCupsPerCycle = 1;
+    RunResult baseline = runSession(arrivals, single);
+    RunResult coalesced = runSession(arrivals, config);
+
+    std::cout << std::fixed;
+    printResult("One cup per cycle:", baseline);
+    std::cout << "\n";
+    std::string label = "Coalescing (window " + std::to_string(config.windowMs) + " ms, max "
+                      + std::to_string(config.maxCupsPerCycle) + " cups):";
+    printResult(label.c_str(), coalesced);
+    return 0;
+}
@@ -0,0 +1,182 @@
+/**
+ * Coffee Vending Machine - Event Log Replay Benchmark (C++)
+ *
+ * Drives a machine through a long randomised session (orders, declined
+ * payments, cancellations, refills, maintenance windows) on a synthetic
+ * clock with a MachineEventLog attached. At random moments the live machine
+ * state is captured; afterwards every capture is rebuilt from the log with
+ * stateAt() and compared, and the average point-in-time rebuild cost is
+ * reported. Finally prints the audit trail around one moment, as used to
+ * settle an "I paid but got no coffee" dispute.
+ *
+ * A huge --snapshot-every shows the cost of replaying from the first event.
+ *
+ * Usage: event_replay_bench [--orders N] [--snapshot-every N] [--seed N]
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "ConsoleGuard.hpp"
+#include "CoffeeMachine.hpp"
+#include "MachineEventLog.hpp"
+
+static int64_t simulatedNow = 0;
+static int64_t simulatedClock() { return simulatedNow; }
+
+// Live state in the same shape as the replayed image
+static MachineImage captureLive(CoffeeMachine& machine) {
+    MachineImage image;
+    MachineStatusSnapshot status = machine.readStatus();
+    std::string stateName = status.stateName;
+    image.phase = stateName == "Selecting" ? MachinePhase::SELECTING
+                : stateName == "Idle" ? MachinePhase::IDLE : MachinePhase::PROCESSING;
+    image.operational = status.operational;
+    image.selectedType = status.selectedType;
+    InventorySnapshot levels = machine.getInventory()->readSnapshot();
+    image.ingredientCount = std::min<uint32_t>(levels.count, MachineImage::MAX_INGREDIENTS);
+    std::copy(levels.levels, levels.levels + image.ingredientCount, image.levels);
+    return image;
+}
+
+int main(int argc, char* argv[]) {
+    long orders = 200000;
+    uint64_t snapshotEvery = MachineEventLog::DEFAULT_SNAPSHOT_INTERVAL;
+    unsigned seed = 7;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--orders") == 0 && i + 1 < argc) {
+            orders = std::max(1L, std::atol(argv[++i]));
+        } else if (std::strcmp(argv[i], "--snapshot-every") == 0 && i + 1 < argc) {
+            snapshotEvery = static_cast<uint64_t>(std::max(1L, std::atol(argv[++i])));
+        } else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = static_cast<unsigned>(std::atoi(argv[++i]));
+        } else {
+            std::cerr << "Usage: " << argv[0]
+                      << " [--orders N] [--snapshot-every N] [--seed N]\n";
+            return 1;
+        }
+    }
+
+    auto machine = CoffeeMachine::create();
+    MachineEventLog log(snapshotEvery);
+    log.setTimeSource(&simulatedClock);
+    machine->attachEventLog(&log);
+
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> drink(1, 5);
+    std::uniform_int_distribution<int> percent(0, 99);
+    std::uniform_int_distribution<int64_t> step(200, 20000);
+
+    struct Capture {
+        int64_t timestamp;
+        MachineImage image;
+    };
+    std::vector<Capture> captures;
+    const Inventory defaults;
+
+    auto start = std::chrono::steady_clock::now();
+    {
+        ConsoleGuard quiet;
+        for (long i = 0; i < orders; ++i) {
+            simulatedNow += step(rng);
+
+            int roll = percent(rng);
+            if (roll == 0) {
+                // Short maintenance window
+                machine->setOperational(false);
+                simulatedNow += step(rng) * 10;
+                machine->setOperational(true);
+                continue;
+            }
+
+            int choice = drink(rng);
+            if (!machine->getInventory()->checkAvailability(static_cast<CoffeeType>(choice - 1))) {
+                for (const auto& [ingredient, full] : defaults.getIngredients()) {
+                    int missing = full - machine->getInventory()->getIngredients().at(ingredient);
+                    if (missing > 0) machine->getInventory()->refillIngredient(ingredient, missing);
+                }
+            }
+            machine->selectCoffee(choice);
+
+            // Sometimes capture mid-order, between selection and payment
+            // (captures must not share a timestamp with later events)
+            simulatedNow += step(rng);
+            if (percent(rng) < 2) captures.push_back({simulatedNow, captureLive(*machine)});
+            simulatedNow += step(rng);
+
+            if (roll < 5) {
+                machine->cancelOrder();
+            } else if (roll < 12) {
+                machine->makePayment(std::make_unique<CashPayment>(0.50)); // declined
+                machine->cancelOrder();
+            } else {
+                machine->makePayment(std::make_unique<CashPayment>(10.00));
+            }
+            if (percent(rng) < 2) captures.push_back({simulatedNow, captureLive(*machine)});
+        }
+    }
+    double runSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "Session: " << orders << " orders, " << log.getEventCount() << " events, "
+              << log.getSnapshotCount() << " snapshots (every " << log.getSnapshotInterval()
+              << " events), " << std::fixed << std::setprecision(2) << runSeconds << " s\n";
+
+    // Verify every capture against a point-in-time rebuild
+    size_t mismatches = 0;
+    start = std::chrono::steady_clock::now();
+    for (const auto& capture : captures) {
+        if (!log.stateAt(capture.timestamp).sameMachineState(capture.image)) mismatches++;
+    }
+    double rebuildMicros = std::chrono::duration<double, std::micro>(
+        std::chrono::steady_clock::now() - start).count() / std::max<size_t>(1, captures.size());
+
+    std::cout << "Rebuilt " << captures.size() << " captured states: "
+              << (mismatches == 0 ? "all match" : "MISMATCHES: " + std::to_string(mismatches)) << "\n";
+    std::cout << "Point-in-time rebuild: " << std::setprecision(2) << rebuildMicros << " us average\n";
+
+    // Audit trail for the last paid order before a capture
+    if (!captures.empty()) {
+        int64_t moment = captures[captures.size() / 2].timestamp;
+        MachineImage then = log.stateAt(moment);
+        std::cout << "\nState at t=" << moment << " ms: " << MachineImage::phaseName(then.phase)
+                  << (then.operational ? "" : " (maintenance)") << ", served " << then.ordersServed
+                  << ", revenue $" << then.revenue << "\n";
+        const auto& names = log.getIngredientNames();
+        for (uint32_t i = 0; i < then.ingredientCount; ++i) {
+            std::cout << "  " << std::left << std::setw(13) << names[i] << std::right
+                      << std::setw(6) << then.levels[i] << "\n";
+        }
+        std::cout << "Events in the preceding minute:\n";
+        for (const auto& event : log.eventsBetween(moment - 60000, moment)) {
+            std::cout << "  t=" << event.timestamp << "  " << std::left << std::setw(12)
+                      << MachineEventLog::eventTypeName(event.type) << std::right;
+            switch (event.type) {
+                case MachineEventType::SELECT:
+                    std::cout << CoffeeFactory::getCoffeeTypeName(static_cast<CoffeeType>(event.arg));
+                    break;
+                case MachineEventType::PAYMENT:
+                    std::cout << (event.arg ? "accepted $" : "declined $") << event.value;
+                    break;
+                case MachineEventType::CONSUME:
+                case MachineEventType::REFILL:
+                    std::cout << names[event.arg] << " " << event.amount;
+                    break;
+                case MachineEventType::OPERATIONAL:
+                    std::cout << (event.arg ? "in service" : "maintenance");
+                    break;
+                default:
+                    break;
+            }
+            std::cout << "\n";
+        }
+    }
+
+    return mismatches == 0 ? 0 : 1;
+}
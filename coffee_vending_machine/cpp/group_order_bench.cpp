@@ -0,0 +1,141 @@
+/**
+ * Coffee Vending Machine - Group Order Planner Benchmark (C++)
+ *
+ * Plans group orders of 20, 100 and 500 random drinks with the
+ * GroupOrderPlanner and compares them with brewing one drink at a time in
+ * submission order, under the same stage model: makespan, mean completion
+ * time, distance from the lower bound and how long planning takes. Every
+ * plan (both kinds) is checked: each drink appears once with all its
+ * stages and finishes when its last stage does, no shot waits longer than
+ * the limit for the rest of its drink, and no station unit runs two stages
+ * at the same time.
+ *
+ * Usage: group_order_bench [--groups N] [--steamers N] [--shot-wait S] [--seed N]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "GroupOrderPlanner.hpp"
+
+static bool validPlan(const GroupOrderPlanner& planner, const std::vector<CoffeeType>& drinks, const GroupPlan& plan) {
+    if (plan.drinks.size() != drinks.size()) return false;
+    std::vector<bool> seen(drinks.size(), false);
+    // (start, end) per station unit
+    std::vector<std::pair<int64_t, int64_t>> busy[GroupOrderPlanner::STATIONS][GroupPlannerConfig::MAX_UNITS];
+    for (const PlannedDrink& drink : plan.drinks) {
+        if (drink.position >= drinks.size() || seen[drink.position] || drink.type != drinks[drink.position]) return false;
+        seen[drink.position] = true;
+        const DrinkStages& stages = planner.getStages(drink.type);
+        int64_t lastEnd = 0;
+        for (int s = 0; s < GroupOrderPlanner::STATIONS; ++s) {
+            if ((stages.ms[s] > 0) != (drink.unit[s] >= 0)) return false;
+            if (drink.unit[s] < 0) continue;
+            if (drink.startMs[s] < 0 || drink.endMs[s] - drink.startMs[s] != stages.ms[s]) return false;
+            lastEnd = std::max(lastEnd, drink.endMs[s]);
+            busy[s][drink.unit[s]].push_back({drink.startMs[s], drink.endMs[s]});
+        }
+        const int shot = static_cast<int>(BrewStation::ESPRESSO_GROUP);
+        if (drink.completeMs != lastEnd) return false;
+        if (drink.unit[shot] >= 0 && drink.completeMs - drink.endMs[shot] > planner.getConfig().maxShotWaitMs) {
+            return false;
+        }
+    }
+    for (auto& station : busy) {
+        for (auto& unit : station) {
+            std::sort(unit.begin(), unit.end());
+            for (size_t i = 1; i < unit.size(); ++i) {
+                if (unit[i].first < unit[i - 1].second) return false;
+            }
+        }
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    int groups = 200;
+    int steamers = 1;
+    int64_t shotWaitMs = GroupPlannerConfig().maxShotWaitMs;
+    unsigned seed = 8;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--groups") == 0 && i + 1 < argc) {
+            groups = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--steamers") == 0 && i + 1 < argc) {
+            steamers = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--shot-wait") == 0 && i + 1 < argc) {
+            shotWaitMs = static_cast<int64_t>(std::max(0.0, std::atof(argv[++i])) * 1000.0);
+        } else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = static_cast<unsigned>(std::atoi(argv[++i]));
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--groups N] [--steamers N] [--shot-wait S] [--seed N]\n";
+            return 1;
+        }
+    }
+
+    GroupPlannerConfig config;
+    config.units[static_cast<int>(BrewStation::STEAMER)] = steamers;
+    config.maxShotWaitMs = shotWaitMs;
+    GroupOrderPlanner planner(config);
+    const char* stationNames[] = {"espresso", "steam", "water"};
+    std::cout << "Stations: " << config.units[0] << " espresso groups, " << config.units[1] << " steamer(s), "
+              << config.units[2] << " water tap; a shot waits at most " << config.maxShotWaitMs / 1000.0
+              << " s\nStages (s):";
+    for (int t = 0; t < static_cast<int>(CoffeeType::COUNT); ++t) {
+        const DrinkStages& stages = planner.getStages(static_cast<CoffeeType>(t));
+        std::cout << "  " << CoffeeFactory::getCoffeeTypeName(static_cast<CoffeeType>(t));
+        for (int s = 0; s < GroupOrderPlanner::STATIONS; ++s) {
+            if (stages.ms[s] > 0) std::cout << " " << stationNames[s] << " " << stages.ms[s] / 1000.0;
+        }
+    }
+    std::cout << "\n\n";
+
+    std::mt19937 rng(seed);
+    std::discrete_distribution<int> drink({10, 20, 50, 10, 10});
+    bool ok = true;
+    std::cout << std::fixed;
+    for (size_t size : {20, 100, 500}) {
+        double sequentialMakespan = 0, sequentialMean = 0, plannedMakespan = 0, plannedMean = 0, bound = 0;
+        double planUs = 0;
+        int rules[4] = {};
+        const char* names[4] = {"submission order", "shortest first", "bottleneck shortest first", "longest first"};
+        for (int g = 0; g < groups; ++g) {
+            std::vector<CoffeeType> order(size);
+            for (auto& type : order) type = static_cast<CoffeeType>(drink(rng));
+
+            GroupPlan before = planner.sequential(order);
+            auto start = std::chrono::steady_clock::now();
+            GroupPlan plan = planner.plan(order);
+            planUs += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+            ok = ok && validPlan(planner, order, before) && validPlan(planner, order, plan)
+                    && plan.makespanMs >= plan.lowerBoundMs;
+
+            sequentialMakespan += before.makespanMs;
+            sequentialMean += before.meanCompletionMs;
+            plannedMakespan += plan.makespanMs;
+            plannedMean += plan.meanCompletionMs;
+            bound += plan.lowerBoundMs;
+            for (int r = 0; r < 4; ++r) rules[r] += std::strcmp(plan.rule, names[r]) == 0;
+        }
+        double n = groups * 1000.0;
+        std::cout << size << "-drink orders (" << groups << " random groups)\n" << std::setprecision(0)
+                  << "  one at a time : makespan " << sequentialMakespan / n << " s, mean completion "
+                  << sequentialMean / n << " s\n"
+                  << "  planned       : makespan " << plannedMakespan / n << " s (lower bound " << bound / n
+                  << " s), mean completion " << plannedMean / n << " s\n"
+                  << std::setprecision(1) << "  planning " << planUs / groups << " us per order; rule chosen:";
+        for (int r = 0; r < 4; ++r) {
+            if (rules[r]) std::cout << " " << names[r] << " x" << rules[r];
+        }
+        std::cout << "\n\n";
+    }
+    std::cout << "Plan check (every drink once, shots within the wait, no overlapping stages): "
+              << (ok ? "ok" : "FAILED") << "\n";
+    return ok ? 0 : 1;
+}
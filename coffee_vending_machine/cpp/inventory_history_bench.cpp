@@ -0,0 +1,160 @@
+/**
+ * Coffee Vending Machine - Inventory History Benchmark (C++)
+ *
+ * Simulates a machine serving orders for a number of days on a synthetic
+ * clock, with an operator topping up whatever runs low, and records every
+ * level change into an InventoryHistory. Reports compressed bytes per
+ * sample, verifies the decoded series against an uncompressed copy, and
+ * times a one-day range query and an hourly downsample.
+ *
+ * Usage: inventory_history_bench [--days N] [--orders-per-day N] [--tick-ms N] [--seed N]
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstring>
+#include <cstdlib>
+#include <map>
+#include <random>
+#include <vector>
+
+#include "ConsoleGuard.hpp"
+#include "Inventory.hpp"
+#include "InventoryHistory.hpp"
+
+static int64_t simulatedNow = 0;
+static int64_t simulatedClock() { return simulatedNow; }
+
+int main(int argc, char* argv[]) {
+    int days = 7;
+    long ordersPerDay = 2000;
+    int64_t tickMs = 1000;
+    unsigned seed = 42;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--days") == 0 && i + 1 < argc) {
+            days = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--orders-per-day") == 0 && i + 1 < argc) {
+            ordersPerDay = std::max(1L, std::atol(argv[++i]));
+        } else if (std::strcmp(argv[i], "--tick-ms") == 0 && i + 1 < argc) {
+            tickMs = std::max(1L, std::atol(argv[++i]));
+        } else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = static_cast<unsigned>(std::atoi(argv[++i]));
+        } else {
+            std::cerr << "Usage: " << argv[0]
+                      << " [--days N] [--orders-per-day N] [--tick-ms N] [--seed N]\n";
+            return 1;
+        }
+    }
+
+    const int64_t DAY_MS = 24LL * 3600 * 1000;
+    const int64_t HOUR_MS = 3600LL * 1000;
+
+    // Orders arrive as a Poisson process during 16 opening hours
+    const int64_t openMs = 16 * HOUR_MS;
+    std::mt19937 rng(seed);
+    std::exponential_distribution<double> gap(static_cast<double>(ordersPerDay) / openMs);
+    std::discrete_distribution<int> mix({40, 25, 20, 10, 5});
+
+    InventoryHistory history(tickMs);
+    history.setTimeSource(&simulatedClock);
+    Inventory inventory;
+    Inventory defaults;
+
+    // Uncompressed reference copy for verification (at tick resolution)
+    std::map<std::string, std::vector<TimeSeries::Sample>> reference;
+    auto tickOf = [tickMs](int64_t ms) { return ms / tickMs * tickMs; };
+    inventory.attachHistory(&history);
+    for (const auto& [ingredient, quantity] : inventory.getIngredients()) {
+        reference[ingredient].push_back({tickOf(simulatedNow), quantity});
+    }
+
+    long orders = 0;
+    long refills = 0;
+    auto start = std::chrono::steady_clock::now();
+    {
+        ConsoleGuard quiet;
+        for (int day = 0; day < days; ++day) {
+            simulatedNow = day * DAY_MS + 6 * HOUR_MS;
+            int64_t closing = simulatedNow + openMs;
+            while (true) {
+                simulatedNow += static_cast<int64_t>(gap(rng));
+                if (simulatedNow >= closing) break;
+                CoffeeType type = static_cast<CoffeeType>(mix(rng));
+                if (!inventory.checkAvailability(type)) {
+                    // Operator tops everything back up to the default levels
+                    for (const auto& [ingredient, full] : defaults.getIngredients()) {
+                        int missing = full - inventory.getIngredients().at(ingredient);
+                        if (missing <= 0) continue;
+                        inventory.refillIngredient(ingredient, missing);
+                        reference[ingredient].push_back({tickOf(simulatedNow), full});
+                        refills++;
+                    }
+                }
+                std::map<std::string, int> before = inventory.getIngredients();
+                inventory.consumeIngredients(type);
+                for (const auto& [ingredient, level] : inventory.getIngredients()) {
+                    if (level != before[ingredient]) {
+                        reference[ingredient].push_back({tickOf(simulatedNow), level});
+                    }
+                }
+                orders++;
+            }
+        }
+    }
+    double recordSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    uint64_t samples = history.getSampleCount();
+    size_t bytes = history.getMemoryBytes();
+    std::cout << "Simulated " << days << " day(s), " << orders << " orders, "
+              << refills << " refills\n";
+    std::cout << "Samples recorded : " << samples << "\n";
+    std::cout << "Compressed bytes : " << bytes << "\n";
+    std::cout << "Bytes per sample : " << std::fixed << std::setprecision(3)
+              << static_cast<double>(bytes) / static_cast<double>(samples)
+              << " (raw " << sizeof(TimeSeries::Sample) << ")\n";
+    std::cout << "Record rate      : " << std::setprecision(0)
+              << static_cast<double>(samples) / recordSeconds << " samples/s\n";
+
+    // Round-trip check
+    bool ok = true;
+    for (const auto& [ingredient, expected] : reference) {
+        const TimeSeries* series = history.getSeries(ingredient);
+        std::vector<TimeSeries::Sample> decoded = series
+            ? series->query(INT64_MIN, INT64_MAX) : std::vector<TimeSeries::Sample>();
+        bool same = decoded.size() == expected.size();
+        for (size_t i = 0; same && i < decoded.size(); ++i) {
+            same = decoded[i].timestamp == expected[i].timestamp
+                && decoded[i].value == expected[i].value;
+        }
+        if (!same) {
+            std::cout << "MISMATCH in " << ingredient << " history ("
+                      << decoded.size() << " decoded vs " << expected.size() << ")\n";
+            ok = false;
+        }
+    }
+
+    // Range query and downsample over the last simulated day
+    int64_t dayStart = (days - 1) * DAY_MS;
+    int64_t dayEnd = dayStart + DAY_MS - 1;
+    const TimeSeries* beans = history.getSeries("Coffee Beans");
+    start = std::chrono::steady_clock::now();
+    std::vector<TimeSeries::Sample> lastDay = beans->query(dayStart, dayEnd);
+    double queryMicros = std::chrono::duration<double, std::micro>(
+        std::chrono::steady_clock::now() - start).count();
+    std::vector<TimeSeries::Bucket> hourly = beans->downsample(dayStart, dayEnd, HOUR_MS);
+
+    std::cout << "Last-day query   : " << lastDay.size() << " samples in "
+              << std::setprecision(1) << queryMicros << " us\n";
+    std::cout << "\nCoffee Beans, last day, hourly (min/max/last):\n";
+    for (const auto& bucket : hourly) {
+        std::cout << "  " << std::setw(2) << (bucket.start - dayStart) / HOUR_MS << ":00  "
+                  << std::setw(4) << bucket.min << " / " << std::setw(4) << bucket.max
+                  << " / " << std::setw(4) << bucket.last
+                  << "  (" << bucket.count << " samples)\n";
+    }
+
+    std::cout << "\nRound-trip: " << (ok ? "OK" : "FAILED") << "\n";
+    return ok ? 0 : 1;
+}
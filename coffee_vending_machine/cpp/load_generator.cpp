@@ -0,0 +1,265 @@
+/**
+ * Coffee Vending Machine - Load Generator for the Order Server (C++)
+ *
+ * Opens many connections to order_server and keeps each one busy with
+ * pipelined batches of "select + cash payment" orders, refilling the machine
+ * whenever an order comes back unavailable. Reports requests per second and
+ * batch round-trip latency percentiles.
+ *
+ * Usage: load_generator [--host A] [--port N] [--connections N]
+ *                       [--pipeline N] [--duration SECONDS]
+ */
+
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+using Clock = std::chrono::steady_clock;
+
+struct ClientConnection {
+    int fd = -1;
+    std::string out;
+    size_t outOffset = 0;
+    size_t expected = 0;     // responses still owed for the current batch
+    bool needRefill = false;
+    int nextChoice = 1;
+    Clock::time_point batchStart;
+};
+
+struct LoadStats {
+    uint64_t requests = 0;
+    uint64_t ordersServed = 0;
+    uint64_t unavailable = 0;
+    uint64_t errors = 0;
+    std::vector<double> batchLatencyUs;
+};
+
+static int connectTo(const char* host, uint16_t port) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    if (inet_pton(AF_INET, host, &addr.sin_addr) != 1 ||
+        connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+        close(fd);
+        return -1;
+    }
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    return fd;
+}
+
+static void buildBatch(ClientConnection& conn, int orders) {
+    conn.out.clear();
+    conn.outOffset = 0;
+    conn.expected = 0;
+    if (conn.needRefill) {
+        conn.out += "R\n";
+        conn.expected++;
+        conn.needRefill = false;
+    }
+    for (int i = 0; i < orders; ++i) {
+        conn.out += "S ";
+        conn.out += std::to_string(conn.nextChoice);
+        conn.out += "\nP C 10\n";
+        conn.expected += 2;
+        conn.nextChoice = conn.nextChoice % 5 + 1;
+    }
+    conn.batchStart = Clock::now();
+}
+
+static bool sendPending(ClientConnection& conn) {
+    while (conn.outOffset < conn.out.size()) {
+        ssize_t n = send(conn.fd, conn.out.data() + conn.outOffset,
+                         conn.out.size() - conn.outOffset, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return errno == EAGAIN || errno == EWOULDBLOCK;
+        }
+        conn.outOffset += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+static void countResponse(ClientConnection& conn, const std::string& line, LoadStats& stats) {
+    stats.requests++;
+    if (line.compare(0, 2, "OK") == 0) {
+        // Successful payments answer "OK <coffee>"; selections add a price
+        size_t spaces = std::count(line.begin(), line.end(), ' ');
+        if (spaces == 1) stats.ordersServed++;
+    } else if (line == "ERR UNAVAILABLE") {
+        stats.unavailable++;
+        conn.needRefill = true;
+    } else if (line != "ERR NOSELECTION") {
+        stats.errors++;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    const char* host = "127.0.0.1";
+    uint16_t port = 7070;
+    int connectionCount = 32;
+    int pipeline = 16;
+    double duration = 5.0;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--host") == 0 && i + 1 < argc) {
+            host = argv[++i];
+        } else if (std::strcmp(argv[i], "--port") == 0 && i + 1 < argc) {
+            port = static_cast<uint16_t>(std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--connections") == 0 && i + 1 < argc) {
+            connectionCount = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--pipeline") == 0 && i + 1 < argc) {
+            pipeline = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--duration") == 0 && i + 1 < argc) {
+            duration = std::atof(argv[++i]);
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--host A] [--port N] [--connections N]"
+                      << " [--pipeline N] [--duration SECONDS]\n";
+            return 1;
+        }
+    }
+
+    int epollFd = epoll_create1(0);
+    std::vector<ClientConnection> conns(static_cast<size_t>(connectionCount));
+    std::vector<std::string> inbufs(conns.size());
+
+    for (size_t i = 0; i < conns.size(); ++i) {
+        conns[i].fd = connectTo(host, port);
+        if (conns[i].fd < 0) {
+            std::perror("connect");
+            return 1;
+        }
+        conns[i].nextChoice = static_cast<int>(i % 5) + 1;
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.u64 = i;
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, conns[i].fd, &ev);
+    }
+
+    // Pipeline depth counts requests, i.e. two per order
+    int ordersPerBatch = std::max(1, pipeline / 2);
+    LoadStats stats;
+    stats.batchLatencyUs.reserve(1 << 20);
+
+    Clock::time_point start = Clock::now();
+    Clock::time_point deadline = start + std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(duration));
+
+    for (auto& conn : conns) {
+        buildBatch(conn, ordersPerBatch);
+        if (!sendPending(conn)) {
+            std::perror("send");
+            return 1;
+        }
+    }
+
+    std::vector<epoll_event> events(conns.size());
+    char buffer[64 * 1024];
+    size_t active = conns.size();
+
+    while (active > 0) {
+        int n = epoll_wait(epollFd, events.data(), static_cast<int>(events.size()), 1000);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            std::perror("epoll_wait");
+            break;
+        }
+        if (n == 0) {
+            std::cerr << "Timed out waiting for responses\n";
+            break;
+        }
+        bool stopping = Clock::now() >= deadline;
+
+        for (int e = 0; e < n; ++e) {
+            size_t idx = events[e].data.u64;
+            ClientConnection& conn = conns[idx];
+            std::string& in = inbufs[idx];
+
+            if (conn.outOffset < conn.out.size() && !sendPending(conn)) {
+                std::perror("send");
+                return 1;
+            }
+
+            ssize_t got = recv(conn.fd, buffer, sizeof(buffer), 0);
+            if (got <= 0) {
+                if (got < 0 && (errno == EAGAIN || errno == EINTR)) continue;
+                std::cerr << "Server closed the connection\n";
+                return 1;
+            }
+            in.append(buffer, static_cast<size_t>(got));
+
+            size_t pos = 0;
+            while (conn.expected > 0) {
+                size_t nl = in.find('\n', pos);
+                if (nl == std::string::npos) break;
+                countResponse(conn, in.substr(pos, nl - pos), stats);
+                conn.expected--;
+                pos = nl + 1;
+            }
+            in.erase(0, pos);
+
+            if (conn.expected == 0) {
+                auto elapsed = std::chrono::duration<double, std::micro>(Clock::now() - conn.batchStart);
+                stats.batchLatencyUs.push_back(elapsed.count());
+                if (stopping) {
+                    epoll_ctl(epollFd, EPOLL_CTL_DEL, conn.fd, nullptr);
+                    close(conn.fd);
+                    conn.fd = -1;
+                    active--;
+                } else {
+                    buildBatch(conn, ordersPerBatch);
+                    if (!sendPending(conn)) {
+                        std::perror("send");
+                        return 1;
+                    }
+                }
+            }
+        }
+    }
+
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    auto& lat = stats.batchLatencyUs;
+    std::sort(lat.begin(), lat.end());
+    auto percentile = [&lat](double p) {
+        if (lat.empty()) return 0.0;
+        size_t idx = static_cast<size_t>(p * static_cast<double>(lat.size() - 1));
+        return lat[idx];
+    };
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "\n========== LOAD TEST RESULTS ==========\n";
+    std::cout << "Connections     : " << connectionCount << "\n";
+    std::cout << "Pipeline depth  : " << ordersPerBatch * 2 << " requests\n";
+    std::cout << "Duration        : " << seconds << " s\n";
+    std::cout << "Requests        : " << stats.requests << "\n";
+    std::cout << "Requests/sec    : " << static_cast<double>(stats.requests) / seconds << "\n";
+    std::cout << "Orders served   : " << stats.ordersServed << "\n";
+    std::cout << "Orders/sec      : " << static_cast<double>(stats.ordersServed) / seconds << "\n";
+    std::cout << "Unavailable     : " << stats.unavailable << "\n";
+    std::cout << "Other errors    : " << stats.errors << "\n";
+    std::cout << "Batch RTT p50   : " << percentile(0.50) << " us\n";
+    std::cout << "Batch RTT p99   : " << percentile(0.99) << " us\n";
+    std::cout << "Batch RTT max   : " << percentile(1.0) << " us\n";
+    std::cout << "========================================\n";
+
+    for (auto& conn : conns) {
+        if (conn.fd >= 0) close(conn.fd);
+    }
+    close(epollFd);
+    return stats.errors == 0 ? 0 : 1;
+}
@@ -20,12 +20,20 @@
  * 3. Machine - Central system (Singleton)
  * 4. Payment - Handles transactions (Strategy Pattern)
  * 5. Inventory - Manages ingredients (Observer Subject)
+ *
+ * Usage:
+ *   coffee_vending_machine                    demo scenarios + interactive mode
+ *   coffee_vending_machine --headless [FILE]  run protocol commands from FILE
+ *                                             (default "-" = stdin), one result
+ *                                             line per command, summary on stderr
+ *   add --no-results to print the summary only
  */
 
 #include <iostream>
 #include <string>
 #include <memory>
 #include <limits>
+#include <cstring>
 
 #include "Coffee.hpp"
 #include "CoffeeFactory.hpp"
@@ -35,11 +43,34 @@
 #include "CoffeeMachine.hpp"
 #include "User.hpp"
 #include "Operator.hpp"
+#include "ConsoleGuard.hpp"
+#include "CommandStream.hpp"
 
 void runInteractiveMode(CoffeeMachine* machine, Operator* op);
 void orderCoffeeInteractive(User& user);
+int runHeadless(const std::string& input, bool printResults);
+
+int main(int argc, char* argv[]) {
+    bool headless = false;
+    bool printResults = true;
+    std::string input = "-";
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--headless") == 0) {
+            headless = true;
+            if (i + 1 < argc && argv[i + 1][0] != '-') input = argv[++i];
+        } else if (std::strcmp(argv[i], "--no-results") == 0) {
+            printResults = false;
+        } else if (std::strcmp(argv[i], "-") == 0 && headless) {
+            input = "-";
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--headless [FILE|-] [--no-results]]\n";
+            return 1;
+        }
+    }
+    if (headless) {
+        return runHeadless(input, printResults);
+    }
 
-int main() {
     std::cout << "╔══════════════════════════════════════════════════════════╗\n";
     std::cout << "║       COFFEE VENDING MACHINE - SYSTEM DEMONSTRATION      ║\n";
     std::cout << "╚══════════════════════════════════════════════════════════╝\n";
@@ -132,6 +163,24 @@ int main() {
     return 0;
 }
 
+int runHeadless(const std::string& input, bool printResults) {
+    CoffeeMachine* machine = CoffeeMachine::getInstance();
+    bool ok;
+    {
+        ConsoleGuard quiet;
+        CommandStreamRunner runner(machine, printResults ? STDOUT_FILENO : -1);
+        ok = runner.run(input);
+
+        const auto& summary = runner.getSummary();
+        double rate = summary.seconds > 0 ? static_cast<double>(summary.commands) / summary.seconds : 0.0;
+        std::cerr << "Processed " << summary.commands << " commands (" << summary.ok
+                  << " ok, " << summary.errors << " errors) in " << summary.seconds
+                  << " s, " << static_cast<uint64_t>(rate) << " commands/s\n";
+    }
+    CoffeeMachine::destroyInstance();
+    return ok ? 0 : 1;
+}
+
 void runInteractiveMode(CoffeeMachine* machine, Operator* op) {
     std::cout << "\n\nWould you like to try the interactive mode? (y/n): ";
     std::string choice;
@@ -0,0 +1,169 @@
+/**
+ * Coffee Vending Machine - Hot Menu Reload Benchmark (C++)
+ *
+ * Serves Espresso orders on one thread while another thread keeps reloading
+ * the menu, alternating between two versions that differ in both price and
+ * recipe. Every order must be charged and brewed to the same version - a
+ * mixed order means a torn or swapped-mid-order menu - and retired versions
+ * must be reclaimed once no order pins them. Also times acquire(), and
+ * checks that pricing rules apply on top of the menu version's price, in
+ * the displayed menu and the charge alike.
+ *
+ * Usage: menu_reload_bench [--orders N] [--acquires N]
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <set>
+#include <sstream>
+#include <thread>
+
+#include "ConsoleGuard.hpp"
+#include "CoffeeMachine.hpp"
+#include "Operator.hpp"
+
+static const char* MENU_A =
+    "price  Espresso 2.50\n"
+    "recipe Espresso Coffee Beans=20, Water=30\n";
+
+static const char* MENU_B =
+    "price  Espresso 3.10\n"
+    "recipe Espresso Coffee Beans=25, Water=35\n"
+    "threshold Coffee Beans=150\n";
+
+// Records what the machine actually charged
+class RecordingPayment : public PaymentStrategy {
+private:
+    double* charged;
+
+public:
+    explicit RecordingPayment(double* out) : charged(out) {}
+
+    bool pay(double amount) override {
+        *charged = amount;
+        return true;
+    }
+
+    std::string_view getPaymentMethod() const override {
+        return "Recording";
+    }
+};
+
+int main(int argc, char* argv[]) {
+    long orders = 200000;
+    long acquires = 10000000;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--orders") == 0 && i + 1 < argc) {
+            orders = std::max(1L, std::atol(argv[++i]));
+        } else if (std::strcmp(argv[i], "--acquires") == 0 && i + 1 < argc) {
+            acquires = std::max(1L, std::atol(argv[++i]));
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--orders N] [--acquires N]\n";
+            return 1;
+        }
+    }
+
+    MenuRegistry menu;
+    if (!menu.reload(MENU_A)) {
+        std::cerr << "Menu rejected: " << menu.getLastError() << "\n";
+        return 1;
+    }
+
+    // Pin cost on the order path
+    uint64_t checksum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (long i = 0; i < acquires; ++i) {
+        MenuHandle version = menu.acquire();
+        checksum += version->version;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "acquire()+release: " << seconds * 1e9 / acquires << " ns (checksum " << checksum << ")\n";
+
+    auto machine = CoffeeMachine::create();
+    machine->attachMenu(&menu);
+
+    std::atomic<bool> done{false};
+    std::atomic<long> reloads{0};
+    std::thread reloader([&] {
+        long count = 0;
+        while (!done.load(std::memory_order_relaxed)) {
+            menu.reload(count % 2 ? MENU_A : MENU_B);
+            count++;
+            std::this_thread::yield();
+        }
+        reloads.store(count);
+    });
+
+    long mixed = 0;
+    long onA = 0;
+    long onB = 0;
+    std::set<uint64_t> versions;
+    start = std::chrono::steady_clock::now();
+    {
+        ConsoleGuard quiet;
+        Inventory* inventory = machine->getInventory();
+        for (long i = 0; i < orders; ++i) {
+            if (inventory->getIngredients().at("Coffee Beans") < 25 ||
+                inventory->getIngredients().at("Water") < 35 ||
+                inventory->getIngredients().at("Cups") < 1) {
+                for (const auto& [ingredient, amount] : Operator::getRefillAmounts()) {
+                    inventory->refillIngredient(ingredient, amount);
+                }
+            }
+            int beansBefore = inventory->getIngredients().at("Coffee Beans");
+            machine->selectCoffee(1);
+            if (machine->getSelectedCoffee() == nullptr) {
+                mixed++;
+                continue;
+            }
+            versions.insert(machine->getOrderMenu()->version);
+            std::this_thread::yield(); // let reloads land between select and pay
+            double charged = 0.0;
+            machine->makePayment(std::make_unique<RecordingPayment>(&charged));
+            int used = beansBefore - inventory->getIngredients().at("Coffee Beans");
+            if (charged == 2.50 && used == 20) onA++;
+            else if (charged == 3.10 && used == 25) onB++;
+            else mixed++;
+        }
+    }
+    seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    done.store(true);
+    reloader.join();
+    machine.reset();
+
+    size_t retired = menu.getRetiredCount();
+    std::cout << orders << " orders in " << std::setprecision(3) << seconds << " s during "
+              << reloads.load() << " reloads; orders ran on " << versions.size() << " versions ("
+              << onA << " on A, " << onB << " on B), " << mixed << " mixed\n";
+    std::cout << "Reclaimed " << menu.getReclaimedCount() << " retired versions, " << retired
+              << " still retired\n";
+
+    // Precedence: menu B's 3.10 is the base, a 10% surcharge applies on top
+    PricingEngine pricing;
+    pricing.compile("percent Espresso * * 10\n");
+    menu.reload(MENU_B);
+    auto priced = CoffeeMachine::create();
+    priced->attachMenu(&menu);
+    priced->attachPricing(&pricing);
+    std::ostringstream shown;
+    double charged = 0.0;
+    {
+        std::streambuf* console = std::cout.rdbuf(shown.rdbuf());
+        priced->displayMenu();
+        std::cout.rdbuf(nullptr);
+        priced->selectCoffee(1);
+        priced->makePayment(std::make_unique<RecordingPayment>(&charged));
+        std::cout.rdbuf(console);
+        std::cout.clear();
+    }
+    bool agreed = charged == 3.41 && shown.str().find("Espresso - $3.41") != std::string::npos;
+    std::cout << "Menu price 3.10 + 10% rule: displayed and charged " << std::setprecision(2) << charged
+              << (agreed ? " - consistent" : " - MISMATCH") << "\n";
+    return mixed == 0 && retired == 0 && agreed ? 0 : 1;
+}
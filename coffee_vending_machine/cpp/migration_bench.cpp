@@ -0,0 +1,367 @@
+/**
+ * Coffee Vending Machine - Machine Migration Benchmark (C++)
+ *
+ * A kiosk (machine, brew queue, session timers, supplier observers) runs a
+ * scripted stream of customers on a simulated clock: orders, selections
+ * left to time out, declined payments and refills. The same script runs
+ * twice:
+ *
+ *   reference  one kiosk from start to finish
+ *   migrated   the kiosk is saved halfway - with a selection awaiting
+ *              payment and orders queued and brewing - dropped, and
+ *              restored on a fresh kiosk (new machine, queue, wheel and
+ *              observer objects) that finishes the script
+ *
+ * Both runs must complete the same orders (numbers, drinks, completion
+ * times), end with the same stock and deliver the same supplier alerts.
+ * Also reports the image size, save and restore times, and checks that
+ * damaged images and unsuitable targets are refused.
+ *
+ * Usage: migration_bench [--customers N] [--suppliers N] [--repeat N] [--seed N]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "ConsoleGuard.hpp"
+#include "CoffeeMachine.hpp"
+#include "MachineMigration.hpp"
+#include "Operator.hpp"
+
+static int64_t simulatedNow = 0;
+static int64_t simulatedClock() { return simulatedNow; }
+
+enum class Action { ORDER, SELECT, PAY, DECLINE, REFILL };
+
+struct Step {
+    int64_t at;
+    Action action;
+    int choice;
+};
+
+class Supplier : public InventoryObserver {
+public:
+    uint64_t alerts = 0;
+    uint64_t refills = 0;
+
+    void update(const std::string&, int, int) override { alerts++; }
+    void refilled(const std::string&, int, int) override { refills++; }
+};
+
+class Completions : public BrewObserver {
+public:
+    std::vector<BrewCompletion> done;
+
+    void onOrderCompleted(const BrewCompletion& completion) override { done.push_back(completion); }
+};
+
+// Everything one controller process holds for a machine
+struct Kiosk {
+    std::unique_ptr<CoffeeMachine> machine = CoffeeMachine::create();
+    BrewQueue queue{machine->getInventory()};
+    TimerWheel wheel{10, simulatedNow};
+    Completions completions;
+    std::vector<std::unique_ptr<Supplier>> suppliers;
+    ObserverDirectory directory;
+
+    // Supplier i has id 100 + i and watches one ingredient; the last one
+    // watches everything
+    explicit Kiosk(size_t supplierCount) {
+        queue.setTimeSource(&simulatedClock);
+        queue.addObserver(&completions);
+        machine->attachBrewQueue(&queue);
+        machine->attachTimers(&wheel);
+        for (size_t i = 0; i < supplierCount; ++i) {
+            suppliers.push_back(std::make_unique<Supplier>());
+            directory.add(static_cast<uint32_t>(100 + i), suppliers.back().get());
+        }
+    }
+
+    ~Kiosk() {
+        machine->attachTimers(nullptr);
+        queue.removeObserver(&completions);
+        for (const auto& supplier : suppliers) machine->removeObserver(supplier.get());
+    }
+
+    void subscribeSuppliers() {
+        const std::vector<std::string>& names = machine->getInventory()->getIngredientNames();
+        for (size_t i = 0; i + 1 < suppliers.size(); ++i) {
+            machine->registerObserver(suppliers[i].get(), names[i % names.size()], ALL_INVENTORY_EVENTS);
+        }
+        machine->getInventory()->subscribeAll(suppliers.back().get(), eventMask(InventoryEvent::LOW_LEVEL));
+    }
+
+    // Advance the clock to t, firing timers and brew cycles on the way
+    void runUntil(int64_t t) {
+        while (true) {
+            int64_t due = std::min(queue.nextDueTime(), wheel.nextDueMs());
+            if (due > t) break;
+            simulatedNow = std::max(simulatedNow, due);
+            wheel.advance(simulatedNow);
+            queue.poll();
+        }
+        simulatedNow = std::max(simulatedNow, t);
+        wheel.advance(simulatedNow);
+        queue.poll();
+    }
+
+    void perform(const Step& step) {
+        runUntil(step.at);
+        switch (step.action) {
+            case Action::ORDER:
+                machine->selectCoffee(step.choice);
+                machine->makePayment(std::make_unique<CashPayment>(10.00));
+                break;
+            case Action::SELECT:
+                machine->selectCoffee(step.choice);
+                break;
+            case Action::PAY:
+                machine->makePayment(std::make_unique<CashPayment>(10.00));
+                break;
+            case Action::DECLINE:
+                machine->makePayment(std::make_unique<CashPayment>(0.10));
+                break;
+            case Action::REFILL:
+                for (const auto& [ingredient, amount] : Operator::getRefillAmounts()) {
+                    machine->getInventory()->refillIngredient(ingredient, amount);
+                }
+                break;
+        }
+    }
+
+    void drain() {
+        while (!queue.isIdle() || wheel.size() > 0) runUntil(std::min(queue.nextDueTime(), wheel.nextDueMs()));
+    }
+};
+
+struct Outcome {
+    std::vector<BrewCompletion> completions;
+    std::map<std::string, int> levels;
+    std::vector<uint64_t> alerts;
+    uint64_t timeouts = 0;
+    BrewQueue::Stats queue;
+};
+
+static void collect(Kiosk& kiosk, Outcome& outcome) {
+    outcome.completions.insert(outcome.completions.end(), kiosk.completions.done.begin(),
+                               kiosk.completions.done.end());
+    outcome.alerts.resize(kiosk.suppliers.size());
+    for (size_t i = 0; i < kiosk.suppliers.size(); ++i) {
+        outcome.alerts[i] += kiosk.suppliers[i]->alerts + kiosk.suppliers[i]->refills;
+    }
+    outcome.levels = kiosk.machine->getInventory()->getIngredients();
+    outcome.timeouts = kiosk.machine->getSessionTimeouts();
+    outcome.queue = kiosk.queue.getStats();
+}
+
+static bool sameOutcome(const Outcome& a, const Outcome& b) {
+    if (a.completions.size() != b.completions.size()) return false;
+    for (size_t i = 0; i < a.completions.size(); ++i) {
+        const BrewCompletion& x = a.completions[i];
+        const BrewCompletion& y = b.completions[i];
+        if (x.orderId != y.orderId || x.type != y.type || x.cycleId != y.cycleId ||
+            x.enqueuedAt != y.enqueuedAt || x.completedAt != y.completedAt) {
+            return false;
+        }
+    }
+    return a.levels == b.levels && a.alerts == b.alerts && a.timeouts == b.timeouts
+        && a.queue.ordersQueued == b.queue.ordersQueued && a.queue.ordersCompleted == b.queue.ordersCompleted
+        && a.queue.cycles == b.queue.cycles && a.queue.brewingMs == b.queue.brewingMs;
+}
+
+struct Report {
+    std::string image;
+    bool same = false;
+    size_t queuedAtHandover = 0;
+    bool brewingAtHandover = false;
+    std::string stateAtHandover;
+    Outcome reference;
+    Outcome migrated;
+    double saveUs = 0.0;
+    double restoreUs = 0.0;
+    double worstUs = 0.0;
+    std::pair<MigrationError, bool> refusals[6];
+    MigrationError busyError = MigrationError::NONE;
+    bool refused = false;
+};
+
+static Report runBench(const std::vector<Step>& script, size_t handover, size_t supplierCount, int repeat) {
+    Report report;
+    ConsoleGuard quiet;
+    simulatedNow = 0;
+    Outcome& reference = report.reference;
+    {
+        Kiosk kiosk(supplierCount);
+        kiosk.subscribeSuppliers();
+        for (const Step& step : script) kiosk.perform(step);
+        kiosk.drain();
+        collect(kiosk, reference);
+    }
+
+    simulatedNow = 0;
+    Outcome& migrated = report.migrated;
+    MigrationError saved;
+    MigrationError restored;
+    {
+        auto source = std::make_unique<Kiosk>(supplierCount);
+        source->subscribeSuppliers();
+        for (size_t i = 0; i < handover; ++i) source->perform(script[i]);
+        saved = MachineMigration::save(*source->machine, source->directory, report.image);
+        report.queuedAtHandover = source->queue.getDepth();
+        report.brewingAtHandover = source->queue.isBrewing();
+        report.stateAtHandover = source->machine->getCurrentState()->getStateName();
+        collect(*source, migrated);
+        source.reset();
+
+        Kiosk target(supplierCount);
+        restored = MachineMigration::restore(*target.machine, report.image, target.directory);
+        for (size_t i = handover; i < script.size(); ++i) target.perform(script[i]);
+        target.drain();
+        collect(target, migrated);
+    }
+    report.same = saved == MigrationError::NONE && restored == MigrationError::NONE
+               && sameOutcome(reference, migrated);
+
+    // Timing: save the same kiosk repeatedly; restore into fresh kiosks
+    simulatedNow = 0;
+    Kiosk source(supplierCount);
+    source.subscribeSuppliers();
+    for (size_t i = 0; i < handover; ++i) source.perform(script[i]);
+    std::string scratch;
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < repeat; ++r) MachineMigration::save(*source.machine, source.directory, scratch);
+    report.saveUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / repeat;
+    for (int r = 0; r < repeat; ++r) {
+        Kiosk target(supplierCount);
+        auto begin = std::chrono::steady_clock::now();
+        MachineMigration::restore(*target.machine, scratch, target.directory);
+        double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - begin).count();
+        report.restoreUs += us;
+        report.worstUs = std::max(report.worstUs, us);
+    }
+    report.restoreUs /= repeat;
+
+    // Refusals leave the target untouched
+    auto refusal = [&](std::string bytes, Kiosk& target, const ObserverDirectory& directory) {
+        MigrationError error = MachineMigration::restore(*target.machine, bytes, directory);
+        bool untouched = target.queue.isIdle() && target.machine->getInventory()->getObserverCount() == 0
+                      && target.machine->getCurrentState()->getPhase() == OrderPathPhase::IDLE;
+        return std::make_pair(error, untouched);
+    };
+    std::string flipped = report.image;
+    flipped[flipped.size() / 2] ^= 0x20;
+    ObserverDirectory nobody;
+    Kiosk fresh(supplierCount);
+    Kiosk busy(supplierCount);
+    busy.machine->selectCoffee(1);
+    report.refusals[0] = refusal(flipped, fresh, fresh.directory);
+    report.refusals[1] = refusal(report.image.substr(0, report.image.size() - 3), fresh, fresh.directory);
+    report.refusals[2] = refusal(std::string(report.image.size(), 'x'), fresh, fresh.directory);
+    report.refusals[3] = refusal(report.image, fresh, nobody);
+    report.busyError = MachineMigration::restore(*busy.machine, report.image, busy.directory);
+
+    // A drained kiosk: nothing queued, but order and receipt numbers issued
+    // that a target without a BrewQueue or ReceiptLog would silently reset
+    {
+        ReceiptConfig discard;
+        discard.rotateBytes = 0;
+        discard.sync = false;
+        ReceiptWriter writer(discard);
+        std::unique_ptr<ReceiptLog> sourceLog = writer.openLog("/dev/null", 1);
+        std::unique_ptr<ReceiptLog> targetLog = writer.openLog("/dev/null", 2);
+        Kiosk drained(supplierCount);
+        drained.machine->attachReceipts(sourceLog.get());
+        drained.perform({simulatedNow + 1000, Action::ORDER, 1});
+        drained.drain();
+        std::string numbered;
+        MachineMigration::save(*drained.machine, drained.directory, numbered);
+        Kiosk noQueue(supplierCount);
+        noQueue.machine->attachBrewQueue(nullptr);
+        noQueue.machine->attachReceipts(targetLog.get());
+        Kiosk noReceipts(supplierCount);
+        report.refusals[4] = refusal(numbered, noQueue, noQueue.directory);
+        report.refusals[5] = refusal(numbered, noReceipts, noReceipts.directory);
+        drained.machine->attachReceipts(nullptr);
+        noQueue.machine->attachReceipts(nullptr);
+    }
+
+    MigrationError expected[] = {MigrationError::CHECKSUM, MigrationError::TRUNCATED, MigrationError::BAD_MAGIC,
+                                 MigrationError::UNKNOWN_OBSERVER, MigrationError::NO_QUEUE,
+                                 MigrationError::NO_RECEIPTS};
+    report.refused = report.busyError == MigrationError::NOT_IDLE;
+    for (size_t i = 0; i < 6; ++i) {
+        report.refused = report.refused && report.refusals[i].first == expected[i] && report.refusals[i].second;
+    }
+    busy.machine->cancelOrder();
+    return report;
+}
+
+int main(int argc, char* argv[]) {
+    size_t customers = 400;
+    size_t supplierCount = 64;
+    int repeat = 2000;
+    unsigned seed = 5;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--customers") == 0 && i + 1 < argc) {
+            customers = static_cast<size_t>(std::max(4L, std::atol(argv[++i])));
+        } else if (std::strcmp(argv[i], "--suppliers") == 0 && i + 1 < argc) {
+            supplierCount = static_cast<size_t>(std::max(1L, std::atol(argv[++i])));
+        } else if (std::strcmp(argv[i], "--repeat") == 0 && i + 1 < argc) {
+            repeat = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = static_cast<unsigned>(std::atol(argv[++i]));
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--customers N] [--suppliers N] [--repeat N] [--seed N]\n";
+            return 1;
+        }
+    }
+
+    // The script; the handover falls between a selection and its payment
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int64_t> gap(5000, 30000);
+    std::uniform_int_distribution<int> drink(1, 5);
+    std::discrete_distribution<int> action({70, 10, 0, 12, 8});
+    std::vector<Step> script;
+    int64_t t = 0;
+    for (size_t i = 0; i < customers; ++i) {
+        t += gap(rng);
+        script.push_back({t, static_cast<Action>(action(rng)), drink(rng)});
+    }
+    size_t handover = customers / 2;
+    script[handover - 1].action = Action::SELECT;
+    script[handover].action = Action::PAY;
+
+    Report report = runBench(script, handover, supplierCount, repeat);
+
+    std::cout << customers << " customers, " << supplierCount << " supplier observers; handover after customer "
+              << handover << " (" << report.stateAtHandover << ", " << report.queuedAtHandover << " orders queued"
+              << (report.brewingAtHandover ? ", a cycle brewing" : "") << ")\n";
+    std::cout << "  image " << report.image.size() << " bytes; save " << std::fixed << std::setprecision(1)
+              << report.saveUs << " us, restore " << report.restoreUs << " us (max " << report.worstUs << " us) over "
+              << repeat << " runs\n";
+    const Outcome& reference = report.reference;
+    const Outcome& migrated = report.migrated;
+    std::cout << "  reference vs migrated: " << reference.completions.size() << " / " << migrated.completions.size()
+              << " orders completed, " << reference.queue.ordersQueued << " / " << migrated.queue.ordersQueued
+              << " queued, " << reference.timeouts << " / " << migrated.timeouts << " timeouts -> "
+              << (report.same ? "identical" : "DIFFER") << "\n";
+    std::cout << "  refused: flipped byte (" << MachineMigration::errorName(report.refusals[0].first)
+              << "), cut short ("
+              << MachineMigration::errorName(report.refusals[1].first) << "), garbage ("
+              << MachineMigration::errorName(report.refusals[2].first) << "), unknown observers ("
+              << MachineMigration::errorName(report.refusals[3].first) << "), busy target ("
+              << MachineMigration::errorName(report.busyError) << "),\n           numbered orders, no queue ("
+              << MachineMigration::errorName(report.refusals[4].first) << "), issued receipts, no log ("
+              << MachineMigration::errorName(report.refusals[5].first) << ") -> "
+              << (report.refused ? "ok" : "FAILED") << "\n";
+    return report.same && report.refused ? 0 : 1;
+}
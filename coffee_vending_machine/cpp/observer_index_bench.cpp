@@ -0,0 +1,235 @@
+/**
+ * Coffee Vending Machine - Observer Index Benchmark (C++)
+ *
+ * Part 1 attaches supplier observers to an Inventory, each responsible for
+ * one ingredient (milk supplier, bean supplier, cup supplier...), and
+ * brews with thresholds set so every consumption raises low-level alerts.
+ * Suppliers either observe everything and filter in update(), which is
+ * all the old observer list allowed, or subscribe to their ingredient
+ * through the subscriber index. Reports the cost per brew and how many
+ * callbacks ran, and checks that both deliver the same alerts.
+ *
+ * Part 2 registers and removes the same observers in random order on the
+ * index and on a plain vector with remove/erase, as Inventory did before.
+ *
+ * Also checks routing, and that observers unsubscribing (themselves or
+ * another) from inside a callback neither skip nor repeat anyone.
+ *
+ * Usage: observer_index_bench [--observers N] [--brews N] [--seed N]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "ConsoleGuard.hpp"
+#include "Inventory.hpp"
+
+class Supplier : public InventoryObserver {
+public:
+    std::string ingredient;
+    bool filter;                  // observing every ingredient
+    uint64_t callbacks = 0;
+    uint64_t alerts = 0;
+    uint64_t refills = 0;
+
+    Supplier(std::string supplies, bool filterAlerts) : ingredient(std::move(supplies)), filter(filterAlerts) {}
+
+    void update(const std::string& name, int, int) override {
+        callbacks++;
+        if (filter && name != ingredient) return;
+        alerts++;
+    }
+
+    void refilled(const std::string& name, int, int) override {
+        callbacks++;
+        if (filter && name != ingredient) return;
+        refills++;
+    }
+};
+
+// Removes `target` (itself by default) from inside its first alert
+class Unsubscriber : public InventoryObserver {
+public:
+    Inventory* inventory;
+    InventoryObserver* target;
+    uint64_t alerts = 0;
+
+    explicit Unsubscriber(Inventory* owner, InventoryObserver* removes = nullptr)
+        : inventory(owner), target(removes ? removes : this) {}
+
+    void update(const std::string&, int, int) override {
+        if (alerts++ == 0) inventory->removeObserver(target);
+    }
+};
+
+struct DispatchResult {
+    double nsPerBrew = 0.0;
+    uint64_t callbacks = 0;
+    uint64_t alerts = 0;
+    std::vector<uint64_t> perSupplier;
+};
+
+static DispatchResult runDispatch(size_t observers, size_t brews, bool indexed) {
+    Inventory inventory;
+    std::map<std::string, int> alwaysLow;
+    for (const auto& name : inventory.getIngredientNames()) alwaysLow[name] = 1 << 30;
+    inventory.applyThresholds(alwaysLow);
+
+    const std::vector<std::string>& names = inventory.getIngredientNames();
+    std::vector<std::unique_ptr<Supplier>> suppliers;
+    for (size_t i = 0; i < observers; ++i) {
+        suppliers.push_back(std::make_unique<Supplier>(names[i % names.size()], !indexed));
+        if (indexed) inventory.subscribe(suppliers.back().get(), suppliers.back()->ingredient);
+        else inventory.addObserver(suppliers.back().get());
+    }
+
+    const Recipe& mocha = Inventory::getRecipe(CoffeeType::MOCHA); // every ingredient
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < brews; ++i) inventory.consumeIngredients(mocha);
+    DispatchResult result;
+    result.nsPerBrew = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count()
+                     / static_cast<double>(brews);
+    for (const auto& supplier : suppliers) {
+        result.callbacks += supplier->callbacks;
+        result.alerts += supplier->alerts;
+        result.perSupplier.push_back(supplier->alerts);
+        inventory.removeObserver(supplier.get());
+    }
+    return result;
+}
+
+template <typename Add, typename Remove>
+static double churnNs(const std::vector<std::unique_ptr<Supplier>>& suppliers, const std::vector<size_t>& order,
+                      Add add, Remove remove) {
+    auto start = std::chrono::steady_clock::now();
+    for (const auto& supplier : suppliers) add(supplier.get());
+    for (size_t i : order) remove(suppliers[i].get());
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count()
+         / static_cast<double>(2 * suppliers.size());
+}
+
+// Subscriptions land where they should: one list per ingredient and event
+// kind, nothing delivered twice to an observer that also watches everything
+static bool checkRouting() {
+    ConsoleGuard quiet;
+    Inventory inventory;
+    Supplier milk("Milk", false);
+    Supplier beans("Coffee Beans", false);
+    Supplier everything("", true);
+    inventory.subscribe(&milk, "Milk", ALL_INVENTORY_EVENTS);
+    inventory.subscribe(&beans, "Coffee Beans");
+    inventory.subscribe(&everything, "Milk");
+    inventory.subscribeAll(&everything, ALL_INVENTORY_EVENTS);
+    bool unknownRejected = !inventory.subscribe(&beans, "Sugar");
+
+    inventory.refillIngredient("Milk", 10);
+    inventory.refillIngredient("Coffee Beans", 10);
+    inventory.notifyObservers("Milk", 1, 2);
+    inventory.notifyObservers("Water", 1, 2);
+    bool ok = unknownRejected && milk.refills == 1 && milk.alerts == 1 && beans.refills == 0 && beans.alerts == 0
+           && everything.callbacks == 4;
+
+    inventory.removeObserver(&milk);
+    inventory.notifyObservers("Milk", 1, 2);
+    ok = ok && milk.alerts == 1 && everything.callbacks == 5 && inventory.getObserverCount() == 2;
+    inventory.removeObserver(&everything);
+    inventory.removeObserver(&beans);
+    return ok && inventory.getObserverCount() == 0;
+}
+
+// Delivery list [once, other, victim, remover, last]: 'once' drops itself
+// and 'remover' drops 'victim', already notified. A swap-remove mid-walk
+// would move 'last' into a visited slot and skip it.
+static bool checkUnsubscribeInCallback() {
+    Inventory inventory;
+    Unsubscriber once(&inventory);
+    Supplier other("Milk", false);
+    Supplier victim("Milk", false);
+    Unsubscriber remover(&inventory, &victim);
+    Supplier last("Milk", false);
+    for (InventoryObserver* observer : std::vector<InventoryObserver*>{&once, &other, &victim, &remover, &last}) {
+        inventory.subscribe(observer, "Milk");
+    }
+
+    inventory.notifyObservers("Milk", 1, 2);
+    bool ok = once.alerts == 1 && other.alerts == 1 && victim.alerts == 1 && remover.alerts == 1 && last.alerts == 1;
+    inventory.notifyObservers("Milk", 1, 2);
+    ok = ok && once.alerts == 1 && other.alerts == 2 && victim.alerts == 1 && remover.alerts == 2 && last.alerts == 2;
+
+    size_t listed = 0;
+    inventory.forEachSubscription([&](InventoryObserver*, const std::string&, InventoryEventMask) { listed++; });
+    ok = ok && listed == 3 && inventory.getObserverCount() == 3;
+    inventory.removeObserver(&last);   // positions were renumbered correctly
+    inventory.notifyObservers("Milk", 1, 2);
+    ok = ok && other.alerts == 3 && remover.alerts == 3 && last.alerts == 2;
+    inventory.removeObserver(&other);
+    inventory.removeObserver(&remover);
+    return ok && inventory.getObserverCount() == 0;
+}
+
+int main(int argc, char* argv[]) {
+    size_t observers = 500;
+    size_t brews = 20000;
+    unsigned seed = 3;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--observers") == 0 && i + 1 < argc) {
+            observers = static_cast<size_t>(std::max(1L, std::atol(argv[++i])));
+        } else if (std::strcmp(argv[i], "--brews") == 0 && i + 1 < argc) {
+            brews = static_cast<size_t>(std::max(1L, std::atol(argv[++i])));
+        } else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = static_cast<unsigned>(std::atol(argv[++i]));
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--observers N] [--brews N] [--seed N]\n";
+            return 1;
+        }
+    }
+
+    DispatchResult filtered = runDispatch(observers, brews, false);
+    DispatchResult indexed = runDispatch(observers, brews, true);
+    bool same = filtered.perSupplier == indexed.perSupplier;
+
+    std::cout << std::fixed << std::setprecision(0);
+    std::cout << observers << " suppliers, one ingredient each; " << brews
+              << " brews, every ingredient low after each\n";
+    std::cout << "  observe all + filter : " << filtered.nsPerBrew << " ns/brew, " << filtered.callbacks
+              << " callbacks for " << filtered.alerts << " relevant alerts\n";
+    std::cout << "  subscriber index     : " << indexed.nsPerBrew << " ns/brew, " << indexed.callbacks
+              << " callbacks for " << indexed.alerts << " relevant alerts\n";
+    std::cout << "  alerts per supplier " << (same ? "identical" : "DIFFER") << "\n";
+
+    std::vector<std::unique_ptr<Supplier>> suppliers;
+    Inventory inventory;
+    const std::vector<std::string>& names = inventory.getIngredientNames();
+    for (size_t i = 0; i < observers; ++i) suppliers.push_back(std::make_unique<Supplier>(names[i % names.size()], false));
+    std::vector<size_t> order(observers);
+    std::iota(order.begin(), order.end(), 0);
+    std::shuffle(order.begin(), order.end(), std::mt19937(seed));
+
+    std::vector<InventoryObserver*> list;
+    double vectorNs = churnNs(suppliers, order,
+        [&](InventoryObserver* o) { list.push_back(o); },
+        [&](InventoryObserver* o) { list.erase(std::remove(list.begin(), list.end(), o), list.end()); });
+    double indexNs = churnNs(suppliers, order,
+        [&](InventoryObserver* o) { inventory.subscribe(o, static_cast<Supplier*>(o)->ingredient); },
+        [&](InventoryObserver* o) { inventory.removeObserver(o); });
+    std::cout << std::setprecision(1) << "\nRegister then remove " << observers << " observers in random order\n"
+              << "  vector + remove/erase : " << vectorNs << " ns/op\n"
+              << "  subscriber index      : " << indexNs << " ns/op (" << inventory.getObserverCount()
+              << " left)\n";
+
+    bool routed = checkRouting();
+    std::cout << "\nRouting check (per-ingredient, per-event, no duplicates): " << (routed ? "ok" : "FAILED") << "\n";
+    bool reentrant = checkUnsubscribeInCallback();
+    std::cout << "Unsubscribe inside a callback (self and another): " << (reentrant ? "ok" : "FAILED") << "\n";
+    return same && routed && reentrant && inventory.getObserverCount() == 0 ? 0 : 1;
+}
@@ -0,0 +1,209 @@
+/**
+ * Coffee Vending Machine - Order Path Profile (C++)
+ *
+ * Counts the hidden costs of an order: global-heap allocations (operator
+ * new/delete replaced with counting versions), console output through a
+ * SinkTap - insertions into std::cout and the write() calls stdio turns
+ * them into - and the receipt file's writev() and fdatasync() calls
+ * (counting ReceiptFileOps). Unlike order_alloc_bench the console is live
+ * (written to /dev/null), so formatting and output are part of the order,
+ * and an Operator observes the inventory, so low-stock alerts are too.
+ *
+ * Drives the protocol session's order script (cash, card and UPI orders,
+ * a cancellation, a declined payment, a refill) after a warm-up and
+ * reports per-order figures broken down by the machine state that caused
+ * them (see OrderPathProfile.hpp). With --receipts the machine also writes
+ * receipts and the flusher thread's file calls are reported; with
+ * --low-stock every ingredient sits below its threshold, so each brew
+ * alerts the Operator.
+ *
+ * Exits non-zero when steady-state allocations per order exceed --budget
+ * (default 0) or allocations still live at the end (allocations minus
+ * frees) exceed --growth-budget per order (default 0.01), so
+ * `make profile-check` catches both slower orders and memory that builds
+ * up over a long run.
+ *
+ * Usage: order_path_profile [--orders N] [--budget N] [--growth-budget N] [--block-buffered]
+ *                           [--low-stock] [--receipts DIR]
+ */
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <string>
+
+#include "OrderPathProfile.hpp"
+#include "OrderProtocol.hpp"
+#include "Operator.hpp"
+
+// GCC pairs the inlined free() below with library operator new call sites
+// and warns; the replacement new is malloc-based, so this is sound
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+
+void* operator new(std::size_t size) {
+    OrderPathProfile::recordAllocation(size);
+    if (void* ptr = std::malloc(size ? size : 1)) return ptr;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    if (ptr) OrderPathProfile::recordFree();
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    if (ptr) OrderPathProfile::recordFree();
+    std::free(ptr);
+}
+
+static ssize_t countedWritev(int fd, const struct iovec* iov, int count) {
+    OrderPathProfile::recordFileWrite();
+    return ::writev(fd, iov, count);
+}
+
+static int countedFdatasync(int fd) {
+    OrderPathProfile::recordFileSync();
+    return ::fdatasync(fd);
+}
+
+static const char* const ORDER_SCRIPT[] = {
+    "S 1", "P C 5",
+    "S 2", "P K 1234567890123456 1234",
+    "S 3", "P U frequent.customer@examplebank",
+    "S 4", "X",
+    "S 5", "P C 1", "P C 10",
+    "R",
+};
+
+int main(int argc, char* argv[]) {
+    long orders = 100000;
+    double budget = 0.0;
+    double growthBudget = 0.01;   // room for containers reaching their size, not a per-order leak
+    bool lineBuffered = true;
+    bool lowStock = false;
+    std::string receiptDir;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--orders") == 0 && i + 1 < argc) {
+            orders = std::max(1L, std::atol(argv[++i]));
+        } else if (std::strcmp(argv[i], "--budget") == 0 && i + 1 < argc) {
+            budget = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--growth-budget") == 0 && i + 1 < argc) {
+            growthBudget = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--block-buffered") == 0) {
+            lineBuffered = false;
+        } else if (std::strcmp(argv[i], "--low-stock") == 0) {
+            lowStock = true;
+        } else if (std::strcmp(argv[i], "--receipts") == 0 && i + 1 < argc) {
+            receiptDir = argv[++i];
+        } else {
+            std::cerr << "Usage: " << argv[0]
+                      << " [--orders N] [--budget N] [--growth-budget N] [--block-buffered]\n"
+                      << "       [--low-stock] [--receipts DIR]\n";
+            return 1;
+        }
+    }
+
+    int devNull = ::open("/dev/null", O_WRONLY | O_CLOEXEC);
+    if (devNull < 0) {
+        std::perror("/dev/null");
+        return 1;
+    }
+
+    CoffeeMachine* machine = CoffeeMachine::getInstance();
+    if (lowStock) {
+        std::map<std::string, int> alwaysLow;
+        for (const auto& name : machine->getInventory()->getIngredientNames()) alwaysLow[name] = 1 << 30;
+        machine->getInventory()->applyThresholds(alwaysLow);
+    }
+    std::unique_ptr<ReceiptWriter> writer;
+    std::unique_ptr<ReceiptLog> receipts;
+    if (!receiptDir.empty()) {
+        ReceiptConfig config;
+        config.files.writev = &countedWritev;
+        config.files.fdatasync = &countedFdatasync;
+        writer = std::make_unique<ReceiptWriter>(config);
+        receipts = writer->openLog(receiptDir + "/machine-1.log", 1);
+        if (!receipts) return 1;
+        machine->attachReceipts(receipts.get());
+    }
+    MachineLease lease;
+    lease.machine = machine;
+    OrderSession session(1, &lease);
+    std::string out;
+    out.reserve(4096);
+
+    // One script pass is five orders (one of them cancelled)
+    const long ordersPerPass = 5;
+    long passes = std::max(1L, orders / ordersPerPass);
+    OrderPathProfile::Snapshot used;
+    {
+        SinkTap tap(devNull, lineBuffered);
+        if (!tap.ok()) {
+            std::perror("fopencookie");
+            return 1;
+        }
+        std::streambuf* console = std::cout.rdbuf(&tap);
+        Operator staff("OP001", "Profile");
+        auto runPasses = [&](long count) {
+            for (long p = 0; p < count; ++p) {
+                for (const char* line : ORDER_SCRIPT) {
+                    session.execute(OrderProtocol::parse(line), out);
+                }
+                out.clear();
+            }
+        };
+        runPasses(100); // warm-up: first-touch allocations, static tables
+
+        std::cout.flush();
+        if (writer) writer->flush();
+        OrderPathProfile::Snapshot before = OrderPathProfile::read();
+        runPasses(passes);
+        std::cout.flush();
+        if (writer) writer->flush();
+        used = OrderPathProfile::read();
+        used -= before;
+        std::cout.rdbuf(console);
+    }
+    machine->attachReceipts(nullptr);
+    ::close(devNull);
+
+    double n = static_cast<double>(passes * ordersPerPass);
+    auto row = [n](const char* label, const OrderPathCounters& c) {
+        std::cout << std::left << std::setw(12) << label << std::right << std::setw(10)
+                  << c.allocations / n << std::setw(10) << c.bytes / n << std::setw(10) << c.frees / n
+                  << std::setw(10) << c.sinkCalls / n << std::setw(10) << c.sinkBytes / n
+                  << std::setw(10) << c.writes / n << "\n";
+    };
+    OrderPathCounters total = used.total();
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "\n========== ORDER PATH PROFILE (per order) ==========\n";
+    std::cout << static_cast<long>(n) << " orders, console stdio " << (lineBuffered ? "line" : "block")
+              << "-buffered to /dev/null" << (lowStock ? ", every ingredient low" : "") << "\n\n";
+    std::cout << std::left << std::setw(12) << "State" << std::right << std::setw(10) << "allocs"
+              << std::setw(10) << "bytes" << std::setw(10) << "frees" << std::setw(10) << "inserts"
+              << std::setw(10) << "out B" << std::setw(10) << "writes" << "\n";
+    for (int p = 0; p < OrderPathProfile::PHASES; ++p) {
+        row(OrderPathProfile::phaseName(static_cast<OrderPathPhase>(p)), used.phases[p]);
+    }
+    row("Total", total);
+    if (writer) {
+        // Batched: far below one call per order, so shown as totals
+        std::cout << "\nReceipt file: " << total.fileWrites << " writev and " << total.fileSyncs
+                  << " fdatasync calls for " << static_cast<long>(n) << " orders (flusher thread)\n";
+    }
+    double perOrder = static_cast<double>(total.allocations) / n;
+    double growth = static_cast<double>(total.growth()) / n;
+    bool within = perOrder <= budget && growth <= growthBudget;
+    std::cout << "\nAllocation budget: " << perOrder << " per order against " << budget << " -> "
+              << (perOrder <= budget ? "ok" : "OVER BUDGET") << "\n";
+    std::cout << "Growth budget    : " << growth << " live allocations per order against " << growthBudget
+              << " -> " << (growth <= growthBudget ? "ok" : "OVER BUDGET") << "\n";
+    std::cout << "=====================================================\n";
+    CoffeeMachine::destroyInstance();
+    return within ? 0 : 1;
+}
@@ -0,0 +1,141 @@
+/**
+ * Coffee Vending Machine - Network Order Server (C++)
+ *
+ * Exposes CoffeeMachine sessions over TCP using the compact line protocol
+ * from OrderProtocol.hpp (menu, select, pay, cancel, status, refill).
+ *
+ * Usage: order_server [--port N] [--machines N] [--selection-timeout S]
+ *                     [--receipts DIR] [--telemetry NAME] [--verbose]
+ *   --port       TCP port to listen on (default 7070)
+ *   --machines   number of machines hosted; connections are spread over them
+ *   --selection-timeout
+ *                cancel a selection left unpaid for S seconds (default 60,
+ *                0 waits for the client forever)
+ *   --receipts   append a receipt line per paid order to DIR/machine-N.log
+ *                (batched writes, rotated at 64 MB); see ReceiptLog.hpp
+ *   --telemetry  publish every machine's state into the POSIX shared-memory
+ *                segment NAME (e.g. /coffee_telemetry); see telemetry_monitor
+ *   --verbose    keep the machines' console output (off by default)
+ *
+ * Try it with: printf 'M\nS 2\nP C 5\nT\n' | nc -q1 localhost 7070
+ */
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <cstring>
+#include <cstdlib>
+#include <csignal>
+
+#include "ConsoleGuard.hpp"
+#include "OrderServer.hpp"
+#include "ReceiptLog.hpp"
+#include "TelemetrySegment.hpp"
+
+static OrderServer* g_server = nullptr;
+
+static void handleSignal(int) {
+    if (g_server) g_server->stop();
+}
+
+int main(int argc, char* argv[]) {
+    uint16_t port = 7070;
+    size_t machineCount = 1;
+    bool verbose = false;
+    const char* telemetryName = nullptr;
+    long selectionTimeout = 60;
+    const char* receiptDir = nullptr;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--port") == 0 && i + 1 < argc) {
+            port = static_cast<uint16_t>(std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--machines") == 0 && i + 1 < argc) {
+            machineCount = static_cast<size_t>(std::atol(argv[++i]));
+        } else if (std::strcmp(argv[i], "--selection-timeout") == 0 && i + 1 < argc) {
+            selectionTimeout = std::max(0L, std::atol(argv[++i]));
+        } else if (std::strcmp(argv[i], "--receipts") == 0 && i + 1 < argc) {
+            receiptDir = argv[++i];
+        } else if (std::strcmp(argv[i], "--telemetry") == 0 && i + 1 < argc) {
+            telemetryName = argv[++i];
+        } else if (std::strcmp(argv[i], "--verbose") == 0) {
+            verbose = true;
+        } else {
+            std::cerr << "Usage: " << argv[0]
+                      << " [--port N] [--machines N] [--selection-timeout S] [--receipts DIR]\n"
+                      << "       [--telemetry NAME] [--verbose]\n";
+            return 1;
+        }
+    }
+
+    OrderServer server(port, machineCount);
+    if (!server.start()) {
+        return 1;
+    }
+    if (selectionTimeout > 0) {
+        SessionTimeoutConfig timeouts;
+        timeouts.selectionTimeoutMs = selectionTimeout * 1000;
+        timeouts.paymentRetryMs = std::min(timeouts.paymentRetryMs, timeouts.selectionTimeoutMs);
+        server.enableSessionTimeouts(timeouts);
+    }
+
+    // Declared before the logs, which must be closed first
+    std::unique_ptr<ReceiptWriter> receiptWriter;
+    std::vector<std::unique_ptr<ReceiptLog>> receiptLogs;
+    if (receiptDir) {
+        receiptWriter = std::make_unique<ReceiptWriter>();
+        for (size_t i = 0; i < server.getMachineCount(); ++i) {
+            std::string path = std::string(receiptDir) + "/machine-" + std::to_string(i + 1) + ".log";
+            receiptLogs.push_back(receiptWriter->openLog(path, static_cast<uint32_t>(i + 1)));
+            if (!receiptLogs.back()) {
+                return 1;
+            }
+            server.getMachine(i)->attachReceipts(receiptLogs.back().get());
+        }
+        std::cerr << "Writing receipts to " << receiptDir << "\n";
+    }
+
+    std::unique_ptr<TelemetrySegment> telemetry;
+    if (telemetryName) {
+        telemetry = TelemetrySegment::create(telemetryName, static_cast<uint32_t>(server.getMachineCount()));
+        if (!telemetry) {
+            return 1;
+        }
+        for (size_t i = 0; i < server.getMachineCount(); ++i) {
+            CoffeeMachine* machine = server.getMachine(i);
+            machine->attachTelemetry(telemetry->addMachine(i + 1, machine->getInventory()->getIngredientNames()));
+        }
+        std::cerr << "Publishing telemetry to shared memory " << telemetryName << "\n";
+    }
+
+    g_server = &server;
+    std::signal(SIGINT, handleSignal);
+    std::signal(SIGTERM, handleSignal);
+
+    std::cerr << "Order server listening on port " << port << " with "
+              << server.getMachineCount() << " machine(s)\n";
+    {
+        ConsoleGuard quiet(!verbose);
+        server.run();
+    }
+
+    const auto& stats = server.getStats();
+    uint64_t timedOut = 0;
+    for (size_t i = 0; i < server.getMachineCount(); ++i) {
+        timedOut += server.getMachine(i)->getSessionTimeouts();
+    }
+    std::cerr << "Shutting down. Connections: " << stats.connectionsAccepted
+              << ", requests: " << stats.requests
+              << ", bytes in/out: " << stats.bytesIn << "/" << stats.bytesOut
+              << ", selections timed out: " << timedOut << "\n";
+    g_server = nullptr;
+    for (size_t i = 0; i < receiptLogs.size(); ++i) {
+        server.getMachine(i)->attachReceipts(nullptr);
+    }
+    if (telemetry) {
+        for (size_t i = 0; i < server.getMachineCount(); ++i) {
+            server.getMachine(i)->attachTelemetry(nullptr);
+        }
+        telemetry->unlink();
+    }
+    return 0;
+}
@@ -0,0 +1,225 @@
+/**
+ * Coffee Vending Machine - Coroutine Order Workflow Simulation (C++20)
+ *
+ * Runs a fleet of kiosks on a single controller thread. Every order is one
+ * coroutine (see OrderWorkflow.hpp) that queues for its kiosk, selects,
+ * waits for the customer's payment with a confirmation timeout, waits for
+ * the payment authorisation round-trip, brews for the drink's preparation
+ * time and dispenses; an empty kiosk is refilled by the operator first.
+ * All orders are spawned up front, so thousands are suspended at once.
+ *
+ * Time is simulated: the executor jumps to the next due timer, so a day of
+ * kiosk traffic takes well under a second of wall time.
+ *
+ * Usage: order_workflow_sim [--kiosks N] [--orders N] [--timeout S] [--seed N]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "ConsoleGuard.hpp"
+#include "CoffeeMachine.hpp"
+#include "Operator.hpp"
+#include "OrderWorkflow.hpp"
+
+enum class PaymentChoice { CASH, CARD, DECLINED_CARD };
+
+struct OrderSpec {
+    uint64_t id;
+    size_t kiosk;
+    int choice;
+    int64_t arrivalMs;
+    int64_t thinkMs;      // customer time to pay
+    int64_t authMs;       // payment authorisation round-trip
+    PaymentChoice payment;
+};
+
+struct Kiosk {
+    std::unique_ptr<CoffeeMachine> machine;
+    AsyncLock lock;
+    // The order currently waiting for this kiosk's customer, if any
+    uint64_t awaitingOrder = 0;
+    OrderSignal<PaymentChoice>* awaitingPayment = nullptr;
+
+    explicit Kiosk(OrderExecutor& executor) : machine(CoffeeMachine::create()), lock(executor) {}
+
+    // Payment from the kiosk UI; dropped if that order already timed out
+    void deliverPayment(uint64_t orderId, PaymentChoice choice) {
+        if (awaitingPayment && awaitingOrder == orderId) awaitingPayment->set(choice);
+    }
+};
+
+struct SimStats {
+    long completed = 0;
+    long timedOut = 0;
+    long declined = 0;
+    long unavailable = 0;
+    long refills = 0;
+    std::vector<int64_t> latencyMs; // arrival to dispense
+};
+
+static const int64_t REFILL_MS = 120000;
+
+// The customer at the kiosk: looks at the screen, then pays
+static OrderTask customer(OrderExecutor& executor, Kiosk& kiosk, OrderSpec spec) {
+    co_await executor.sleep(spec.thinkMs);
+    kiosk.deliverPayment(spec.id, spec.payment);
+}
+
+// One order, start to finish
+static OrderTask order(OrderExecutor& executor, Kiosk& kiosk, OrderSpec spec, int64_t confirmTimeoutMs,
+                       SimStats& stats) {
+    co_await executor.sleepUntil(spec.arrivalMs);
+    auto held = co_await kiosk.lock.lock();
+    CoffeeMachine* machine = kiosk.machine.get();
+
+    if (!machine->getInventory()->checkAvailability(static_cast<CoffeeType>(spec.choice - 1))) {
+        co_await executor.sleep(REFILL_MS);
+        for (const auto& [ingredient, amount] : Operator::getRefillAmounts()) {
+            machine->getInventory()->refillIngredient(ingredient, amount);
+        }
+        stats.refills++;
+    }
+    machine->selectCoffee(spec.choice);
+    if (machine->getSelectedCoffee() == nullptr) {
+        stats.unavailable++;
+        co_return;
+    }
+    int brewSeconds = machine->preparationTime(machine->getSelectedCoffee(), machine->getSelectedCoffeeType());
+
+    // Wait for the customer, at most confirmTimeoutMs
+    OrderSignal<PaymentChoice> payment(executor);
+    kiosk.awaitingOrder = spec.id;
+    kiosk.awaitingPayment = &payment;
+    executor.spawn(customer(executor, kiosk, spec));
+    std::optional<PaymentChoice> paid = co_await payment.wait(confirmTimeoutMs);
+    kiosk.awaitingPayment = nullptr;
+    kiosk.awaitingOrder = 0;
+    if (!paid) {
+        machine->cancelOrder();
+        stats.timedOut++;
+        co_return;
+    }
+
+    // Authorisation round-trip, then charge
+    co_await executor.sleep(spec.authMs);
+    switch (*paid) {
+        case PaymentChoice::CASH:
+            machine->makePayment(std::make_unique<CashPayment>(10.00));
+            break;
+        case PaymentChoice::CARD:
+            machine->makePayment(std::make_unique<CardPayment>("4111111111111111", "1234"));
+            break;
+        case PaymentChoice::DECLINED_CARD:
+            machine->makePayment(std::make_unique<CardPayment>("4111", "1234"));
+            break;
+    }
+    if (machine->getSelectedCoffee() != nullptr) {
+        machine->cancelOrder();
+        stats.declined++;
+        co_return;
+    }
+
+    co_await executor.sleep(static_cast<int64_t>(brewSeconds) * 1000);
+    stats.completed++;
+    stats.latencyMs.push_back(executor.now() - spec.arrivalMs);
+}
+
+int main(int argc, char* argv[]) {
+    long kiosks = 500;
+    long orders = 20000;
+    long timeoutSeconds = 45;
+    unsigned seed = 7;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--kiosks") == 0 && i + 1 < argc) {
+            kiosks = std::max(1L, std::atol(argv[++i]));
+        } else if (std::strcmp(argv[i], "--orders") == 0 && i + 1 < argc) {
+            orders = std::max(1L, std::atol(argv[++i]));
+        } else if (std::strcmp(argv[i], "--timeout") == 0 && i + 1 < argc) {
+            timeoutSeconds = std::max(1L, std::atol(argv[++i]));
+        } else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = static_cast<unsigned>(std::atol(argv[++i]));
+        } else {
+            std::cerr << "Usage: " << argv[0]
+                      << " [--kiosks N] [--orders N] [--timeout S] [--seed N]\n";
+            return 1;
+        }
+    }
+
+    OrderExecutor executor;
+    std::vector<std::unique_ptr<Kiosk>> fleet;
+    for (long k = 0; k < kiosks; ++k) {
+        fleet.push_back(std::make_unique<Kiosk>(executor));
+    }
+
+    // Arrivals spread over an 8-hour day; customers take 5-60 s to pay
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int64_t> arrival(0, 8LL * 3600 * 1000);
+    std::uniform_int_distribution<int64_t> think(5000, 60000);
+    std::uniform_int_distribution<int64_t> auth(200, 2500);
+    std::uniform_int_distribution<long> kioskPick(0, kiosks - 1);
+    std::uniform_int_distribution<int> drink(1, 5);
+    std::uniform_int_distribution<int> method(0, 99);
+
+    SimStats stats;
+    stats.latencyMs.reserve(static_cast<size_t>(orders));
+    for (long i = 0; i < orders; ++i) {
+        OrderSpec spec;
+        spec.id = static_cast<uint64_t>(i + 1);
+        spec.kiosk = static_cast<size_t>(kioskPick(rng));
+        spec.choice = drink(rng);
+        spec.arrivalMs = arrival(rng);
+        spec.thinkMs = think(rng);
+        spec.authMs = auth(rng);
+        int m = method(rng);
+        spec.payment = m < 45 ? PaymentChoice::CASH : m < 97 ? PaymentChoice::CARD : PaymentChoice::DECLINED_CARD;
+        executor.spawn(order(executor, *fleet[spec.kiosk], spec, timeoutSeconds * 1000, stats));
+    }
+    OrderTask::FrameStats spawned = OrderTask::frameStats();
+
+    auto start = std::chrono::steady_clock::now();
+    {
+        ConsoleGuard quiet;
+        executor.run();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    const OrderExecutor::Stats& exec = executor.getStats();
+    OrderTask::FrameStats frames = OrderTask::frameStats();
+    std::sort(stats.latencyMs.begin(), stats.latencyMs.end());
+    auto percentile = [&](double q) {
+        if (stats.latencyMs.empty()) return 0.0;
+        size_t index = std::min(stats.latencyMs.size() - 1, static_cast<size_t>(stats.latencyMs.size() * q));
+        return static_cast<double>(stats.latencyMs[index]) / 1000.0;
+    };
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "Fleet: " << kiosks << " kiosks, " << orders << " orders over "
+              << executor.now() / 3600000.0 << " simulated hours, one controller thread\n";
+    std::cout << "Orders: " << stats.completed << " dispensed, " << stats.timedOut << " payment timeouts, "
+              << stats.declined << " declined, " << stats.unavailable << " unavailable, "
+              << stats.refills << " refills\n";
+    std::cout << "Order time (arrival to dispense): p50 " << percentile(0.50) << " s, p95 "
+              << percentile(0.95) << " s, max " << percentile(1.0) << " s\n";
+    std::cout << "Coroutines: " << frames.created << " frames, peak " << frames.peak << " in flight ("
+              << spawned.peakBytes / std::max<uint64_t>(spawned.peak, 1) << " B each, "
+              << frames.peakBytes / 1024 << " KB peak), " << exec.peakTimers << " peak timers\n";
+    std::cout << "Executor: " << exec.resumptions << " resumptions, " << exec.timersFired << " timers fired, "
+              << exec.timersCancelled << " cancelled, in " << std::setprecision(3) << seconds << " s wall ("
+              << std::setprecision(2) << exec.resumptions / seconds / 1e6 << " M resumptions/s)\n";
+
+    long accounted = stats.completed + stats.timedOut + stats.declined + stats.unavailable;
+    if (frames.live != 0 || accounted != orders) {
+        std::cerr << "Unfinished orders: " << orders - accounted << ", live frames " << frames.live << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,257 @@
+/**
+ * Coffee Vending Machine - Cross-Language Parity Driver (C++)
+ *
+ * Runs the shared workload in parity/workload.conf headless against this
+ * implementation and prints one PARITY line in the format shared with the
+ * Java driver (java/src/ParityDriver.java):
+ *
+ *   PARITY impl=cpp orders=N completed=N cancelled=N declined=N refills=N
+ *          revenue=D seconds=D orders_per_sec=D p50_us=D p90_us=D p99_us=D
+ *          p999_us=D max_us=D peak_rss_kb=N
+ *
+ * Startup time is measured from outside by parity/run_parity.sh, which
+ * launches the driver with --startup (build the machine, serve one order,
+ * exit) so that process and runtime start-up are included.
+ *
+ * Usage: parity_driver [--workload FILE] [--orders N] [--startup]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "ConsoleGuard.hpp"
+#include "CoffeeMachine.hpp"
+#include "Operator.hpp"
+
+struct Workload {
+    uint64_t seed = 1;
+    long warmupOrders = 0;
+    long orders = 0;
+    std::vector<long> orderMix;
+    std::vector<long> paymentMix;
+    long cancelPercent = 0;
+    long declinePercent = 0;
+    long refillEvery = 0;
+};
+
+// key = value lines, '#' comments; values are whitespace-separated integers
+static bool loadWorkload(const std::string& path, Workload& workload) {
+    std::ifstream file(path);
+    if (!file) {
+        std::cerr << "Cannot open workload " << path << "\n";
+        return false;
+    }
+    std::map<std::string, std::vector<long>> values;
+    std::string line;
+    while (std::getline(file, line)) {
+        line = line.substr(0, line.find('#'));
+        size_t eq = line.find('=');
+        if (eq == std::string::npos) continue;
+        std::stringstream key(line.substr(0, eq));
+        std::stringstream rest(line.substr(eq + 1));
+        std::string name;
+        key >> name;
+        long value = 0;
+        while (rest >> value) values[name].push_back(value);
+    }
+    auto scalar = [&](const char* name, long& out) {
+        if (values[name].size() != 1) {
+            std::cerr << "Workload: '" << name << "' needs one value\n";
+            return false;
+        }
+        out = values[name][0];
+        return true;
+    };
+    long seed = 0;
+    if (!scalar("seed", seed) || !scalar("warmup_orders", workload.warmupOrders) ||
+        !scalar("orders", workload.orders) || !scalar("cancel_percent", workload.cancelPercent) ||
+        !scalar("decline_percent", workload.declinePercent) || !scalar("refill_every", workload.refillEvery)) {
+        return false;
+    }
+    workload.seed = static_cast<uint64_t>(seed);
+    workload.orderMix = values["order_mix"];
+    workload.paymentMix = values["payment_mix"];
+    if (workload.orderMix.size() != 5 || workload.paymentMix.size() != 3) {
+        std::cerr << "Workload: order_mix needs 5 weights, payment_mix 3\n";
+        return false;
+    }
+    return true;
+}
+
+// splitmix64, identical to the Java driver's
+class ParityRandom {
+private:
+    uint64_t state;
+
+public:
+    explicit ParityRandom(uint64_t seed) : state(seed) {}
+
+    long next() {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return static_cast<long>((z ^ (z >> 31)) >> 1);
+    }
+};
+
+static int pickWeighted(const std::vector<long>& weights, long r) {
+    long total = 0;
+    for (long w : weights) total += w;
+    long target = r % total;
+    for (size_t i = 0; i < weights.size(); ++i) {
+        if (target < weights[i]) return static_cast<int>(i);
+        target -= weights[i];
+    }
+    return static_cast<int>(weights.size()) - 1;
+}
+
+struct Counters {
+    long completed = 0;
+    long cancelled = 0;
+    long declined = 0;
+    long refills = 0;
+    long revenueCents = 0;
+};
+
+static void refillAll(CoffeeMachine* machine) {
+    for (const auto& [ingredient, amount] : Operator::getRefillAmounts()) {
+        machine->getInventory()->refillIngredient(ingredient, amount);
+    }
+}
+
+static void runOrder(CoffeeMachine* machine, const Workload& workload, ParityRandom& rng,
+                     long index, Counters& counters) {
+    int choice = pickWeighted(workload.orderMix, rng.next()) + 1;
+    bool cancel = rng.next() % 100 < workload.cancelPercent;
+    int method = pickWeighted(workload.paymentMix, rng.next());
+    bool shortCash = rng.next() % 100 < workload.declinePercent;
+
+    if (index > 0 && index % workload.refillEvery == 0) {
+        refillAll(machine);
+        counters.refills++;
+    }
+    if (!machine->getInventory()->checkAvailability(static_cast<CoffeeType>(choice - 1))) {
+        refillAll(machine);
+        counters.refills++;
+    }
+
+    machine->selectCoffee(choice);
+    if (cancel) {
+        machine->cancelOrder();
+        counters.cancelled++;
+        return;
+    }
+    long priceCents = std::lround(machine->getSelectedCoffee()->getPrice() * 100.0);
+    switch (method) {
+        case 0:
+            if (shortCash) {
+                machine->makePayment(std::make_unique<CashPayment>(0.50));
+                counters.declined++;
+            }
+            machine->makePayment(std::make_unique<CashPayment>(10.00));
+            break;
+        case 1:
+            machine->makePayment(std::make_unique<CardPayment>("4111111111111111", "1234"));
+            break;
+        default:
+            machine->makePayment(std::make_unique<UPIPayment>("parity@bank"));
+            break;
+    }
+    if (machine->getSelectedCoffee() == nullptr) {
+        counters.completed++;
+        counters.revenueCents += priceCents;
+    }
+}
+
+// Peak resident set from the kernel, read the same way by both drivers
+static long peakRssKb() {
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.rfind("VmHWM:", 0) == 0) return std::atol(line.c_str() + 6);
+    }
+    return -1;
+}
+
+static double percentileUs(const std::vector<int64_t>& sorted, double q) {
+    size_t index = std::min(sorted.size() - 1, static_cast<size_t>(static_cast<double>(sorted.size()) * q));
+    return static_cast<double>(sorted[index]) / 1000.0;
+}
+
+int main(int argc, char* argv[]) {
+    std::string path = "../parity/workload.conf";
+    long ordersOverride = 0;
+    bool startupOnly = false;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--workload") == 0 && i + 1 < argc) {
+            path = argv[++i];
+        } else if (std::strcmp(argv[i], "--orders") == 0 && i + 1 < argc) {
+            ordersOverride = std::max(1L, std::atol(argv[++i]));
+        } else if (std::strcmp(argv[i], "--startup") == 0) {
+            startupOnly = true;
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--workload FILE] [--orders N] [--startup]\n";
+            return 1;
+        }
+    }
+
+    Workload workload;
+    if (!loadWorkload(path, workload)) {
+        return 1;
+    }
+    if (ordersOverride > 0) workload.orders = ordersOverride;
+    if (workload.refillEvery <= 0) workload.refillEvery = 1;
+
+    auto machine = CoffeeMachine::create();
+    ParityRandom rng(workload.seed);
+    Counters counters;
+
+    if (startupOnly) {
+        {
+            ConsoleGuard quiet;
+            runOrder(machine.get(), workload, rng, 0, counters);
+        }
+        std::printf("PARITY impl=cpp ready completed=%ld\n", counters.completed);
+        return 0;
+    }
+
+    std::vector<int64_t> latencies(static_cast<size_t>(workload.orders));
+    double seconds = 0.0;
+    {
+        ConsoleGuard quiet;
+        for (long i = 0; i < workload.warmupOrders; ++i) {
+            runOrder(machine.get(), workload, rng, i, counters);
+        }
+        counters = Counters();
+        auto start = std::chrono::steady_clock::now();
+        for (long i = 0; i < workload.orders; ++i) {
+            auto begin = std::chrono::steady_clock::now();
+            runOrder(machine.get(), workload, rng, workload.warmupOrders + i, counters);
+            latencies[static_cast<size_t>(i)] = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - begin).count();
+        }
+        seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+    std::printf("PARITY impl=cpp orders=%ld completed=%ld cancelled=%ld declined=%ld refills=%ld "
+                "revenue=%ld.%02ld seconds=%.3f orders_per_sec=%.0f p50_us=%.2f p90_us=%.2f p99_us=%.2f "
+                "p999_us=%.2f max_us=%.2f peak_rss_kb=%ld\n",
+                workload.orders, counters.completed, counters.cancelled, counters.declined,
+                counters.refills, counters.revenueCents / 100, counters.revenueCents % 100, seconds, static_cast<double>(workload.orders) / seconds,
+                percentileUs(latencies, 0.50), percentileUs(latencies, 0.90), percentileUs(latencies, 0.99),
+                percentileUs(latencies, 0.999), static_cast<double>(latencies.back()) / 1000.0, peakRssKb());
+    return 0;
+}
@@ -0,0 +1,252 @@
+/**
+ * Coffee Vending Machine - Pre-Order Simulation (C++)
+ *
+ * A morning at one machine (7:00 - 10:00, simulated time): walk-up
+ * customers all morning, plus commuters who want their drink at a
+ * particular time around 8:15 and decide 20 - 60 min beforehand. Run
+ * twice:
+ *
+ *   walk-up only  commuters order at the machine at their chosen time
+ *   pre-orders    commuters book through the PreOrderBook when they
+ *                 decide and come at the slot they are given (a full
+ *                 slot moves them by up to maxShiftSlots); a refused
+ *                 booking falls back to ordering at the machine
+ *
+ * Reports how long commuters and walk-ups wait for their drink, how long
+ * pre-ordered drinks stand before pickup, shifts, refusals and queue depth.
+ * The operator keeps stock ample so the runs differ only in scheduling.
+ *
+ * Usage: preorder_sim [--commuters N] [--walkups-per-hour N] [--spread-min N]
+ *                     [--bookable N] [--max-shift N] [--seed N]
+ */
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <queue>
+#include <random>
+#include <vector>
+
+#include "ConsoleGuard.hpp"
+#include "CoffeeMachine.hpp"
+#include "Operator.hpp"
+#include "PreOrderBook.hpp"
+
+static const int64_t MINUTE = 60000;
+static const int64_t OPEN = 7 * 60 * MINUTE;
+static const int64_t CLOSE = 10 * 60 * MINUTE;
+
+static int64_t simulatedNow = 0;
+static int64_t simulatedClock() { return simulatedNow; }
+
+enum class EventKind { WALK_UP, COMMUTER_DECIDES, COMMUTER_ORDERS };
+
+struct Event {
+    int64_t at;
+    EventKind kind;
+    int choice;
+    int64_t wantedMs;           // commuter's chosen pickup time
+
+    bool operator>(const Event& other) const { return at > other.at; }
+};
+
+struct OrderInfo {
+    bool commuter = false;
+    int64_t arrivalMs = 0;      // when the customer is at the machine
+    int64_t readyMs = -1;
+};
+
+class ReadyCollector : public BrewObserver {
+public:
+    std::vector<OrderInfo> orders{1}; // by order number, from 1
+
+    void onOrderCompleted(const BrewCompletion& completion) override {
+        orders[completion.orderId].readyMs = completion.completedAt;
+    }
+};
+
+struct Morning {
+    ReadyCollector* collector;
+    PreOrderBook* book;
+};
+
+// A released booking's customer arrives at the start of the booked slot
+static void onReleased(void* context, uint64_t bookingId, uint64_t orderId) {
+    Morning* morning = static_cast<Morning*>(context);
+    const PreOrderBook::Booking* booking = morning->book->getBooking(bookingId);
+    morning->collector->orders.resize(orderId + 1);
+    morning->collector->orders[orderId] = {true, booking->slot * morning->book->getConfig().slotMs, -1};
+}
+
+struct RunResult {
+    std::vector<int64_t> commuterWaits;
+    std::vector<int64_t> walkUpWaits;
+    std::vector<int64_t> standing;  // pre-ordered drink ready before its customer
+    size_t peakDepth = 0;
+    PreOrderBook::Stats book;
+};
+
+static RunResult runMorning(const std::vector<Event>& events, bool preOrders, PreOrderConfig config) {
+    simulatedNow = OPEN - 60 * MINUTE;
+    auto machine = CoffeeMachine::create();
+    BrewQueue queue(machine->getInventory());
+    queue.setTimeSource(&simulatedClock);
+    machine->attachBrewQueue(&queue);
+    ReadyCollector collector;
+    queue.addObserver(&collector);
+    PreOrderBook book(machine->getInventory(), &queue, config);
+    book.setTimeSource(&simulatedClock);
+    Morning morning{&collector, &book};
+    book.setReleaseHook(&onReleased, &morning);
+
+    std::priority_queue<Event, std::vector<Event>, std::greater<Event>> pending(events.begin(), events.end());
+    RunResult result;
+    int64_t nextRefill = OPEN;
+    ConsoleGuard quiet;
+
+    auto orderAtMachine = [&](int choice, bool commuter) {
+        machine->selectCoffee(choice);
+        if (machine->getSelectedCoffee() == nullptr) return;
+        machine->makePayment(std::make_unique<CashPayment>(10.00));
+        uint64_t orderId = queue.getStats().ordersQueued; // numbers run from 1
+        collector.orders.resize(orderId + 1);
+        collector.orders[orderId] = {commuter, simulatedNow, -1};
+    };
+
+    while (!pending.empty() || !queue.isIdle() || book.getWaitingCount() > 0) {
+        int64_t eventAt = pending.empty() ? INT64_MAX : pending.top().at;
+        int64_t due = std::min({eventAt, queue.nextDueTime(), book.nextDueTime(), nextRefill});
+        simulatedNow = std::max(simulatedNow, due);
+
+        book.poll();
+        queue.poll();
+        result.peakDepth = std::max(result.peakDepth, queue.getDepth());
+        if (simulatedNow >= nextRefill) {
+            for (const auto& [ingredient, amount] : Operator::getRefillAmounts()) {
+                machine->getInventory()->refillIngredient(ingredient, amount * 4);
+            }
+            nextRefill = nextRefill + 5 * MINUTE < CLOSE ? nextRefill + 5 * MINUTE : INT64_MAX;
+        }
+        if (pending.empty() || pending.top().at > simulatedNow) continue;
+
+        Event event = pending.top();
+        pending.pop();
+        switch (event.kind) {
+            case EventKind::WALK_UP:
+                orderAtMachine(event.choice, false);
+                break;
+            case EventKind::COMMUTER_ORDERS:
+                orderAtMachine(event.choice, true);
+                break;
+            case EventKind::COMMUTER_DECIDES:
+                if (!preOrders) {
+                    pending.push({event.wantedMs, EventKind::COMMUTER_ORDERS, event.choice, event.wantedMs});
+                    break;
+                }
+                if (!book.book(static_cast<CoffeeType>(event.choice - 1), event.wantedMs).accepted()) {
+                    pending.push({event.wantedMs, EventKind::COMMUTER_ORDERS, event.choice, event.wantedMs});
+                }
+                break;
+        }
+    }
+    queue.removeObserver(&collector);
+
+    for (const auto& order : collector.orders) {
+        if (order.readyMs < 0) continue;
+        int64_t wait = std::max<int64_t>(order.readyMs - order.arrivalMs, 0);
+        (order.commuter ? result.commuterWaits : result.walkUpWaits).push_back(wait);
+        if (order.commuter && preOrders && order.readyMs < order.arrivalMs) {
+            result.standing.push_back(order.arrivalMs - order.readyMs);
+        }
+    }
+    result.book = book.getStats();
+    return result;
+}
+
+static void printWaits(const char* label, std::vector<int64_t> waits) {
+    std::sort(waits.begin(), waits.end());
+    double total = 0.0;
+    size_t overMinute = 0;
+    for (int64_t w : waits) {
+        total += static_cast<double>(w);
+        if (w > MINUTE) overMinute++;
+    }
+    double n = static_cast<double>(std::max<size_t>(waits.size(), 1));
+    std::cout << "  " << label << waits.size() << " served, wait mean " << std::setprecision(1)
+              << total / n / 1000.0 << " s, p95 "
+              << (waits.empty() ? 0.0 : static_cast<double>(waits[waits.size() * 95 / 100]) / 1000.0) << " s, max "
+              << (waits.empty() ? 0.0 : static_cast<double>(waits.back()) / 1000.0) << " s, "
+              << std::setprecision(0) << 100.0 * static_cast<double>(overMinute) / n << "% over 1 min\n";
+}
+
+int main(int argc, char* argv[]) {
+    int commuters = 60;
+    double walkUpsPerHour = 30.0;
+    int spreadMinutes = 12;
+    unsigned seed = 11;
+    PreOrderConfig config;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--commuters") == 0 && i + 1 < argc) {
+            commuters = std::max(0, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--walkups-per-hour") == 0 && i + 1 < argc) {
+            walkUpsPerHour = std::max(0.1, std::atof(argv[++i]));
+        } else if (std::strcmp(argv[i], "--spread-min") == 0 && i + 1 < argc) {
+            spreadMinutes = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--bookable") == 0 && i + 1 < argc) {
+            config.bookablePercent = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--max-shift") == 0 && i + 1 < argc) {
+            config.maxShiftSlots = std::max(0, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = static_cast<unsigned>(std::atoi(argv[++i]));
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--commuters N] [--walkups-per-hour N] [--spread-min N]\n"
+                      << "       [--bookable N] [--max-shift N] [--seed N]\n";
+            return 1;
+        }
+    }
+
+    std::mt19937 rng(seed);
+    std::discrete_distribution<int> drink({10, 20, 50, 10, 10});
+    std::vector<Event> events;
+    std::exponential_distribution<double> gap(walkUpsPerHour / 60.0 / MINUTE);
+    for (double t = OPEN + gap(rng); t < CLOSE; t += gap(rng)) {
+        events.push_back({static_cast<int64_t>(t), EventKind::WALK_UP, drink(rng) + 1, 0});
+    }
+    std::normal_distribution<double> wanted(8 * 60 * MINUTE + 15 * MINUTE, spreadMinutes * MINUTE);
+    std::uniform_int_distribution<int64_t> ahead(20 * MINUTE, 60 * MINUTE);
+    for (int i = 0; i < commuters; ++i) {
+        int64_t at = std::clamp(static_cast<int64_t>(wanted(rng)), OPEN + 30 * MINUTE, CLOSE - 10 * MINUTE);
+        at = at / MINUTE * MINUTE;
+        events.push_back({at - ahead(rng), EventKind::COMMUTER_DECIDES, drink(rng) + 1, at});
+    }
+
+    RunResult walkUp = runMorning(events, false, config);
+    RunResult booked = runMorning(events, true, config);
+
+    std::cout << "Morning 7:00-10:00: " << commuters << " commuters around 8:15 (sd " << spreadMinutes
+              << " min), " << std::fixed << std::setprecision(0) << walkUpsPerHour << " walk-ups/hour\n\n";
+    std::cout << "Walk-up only (peak queue depth " << walkUp.peakDepth << "):\n";
+    printWaits("commuters ", walkUp.commuterWaits);
+    printWaits("walk-ups  ", walkUp.walkUpWaits);
+
+    const PreOrderBook::Stats& s = booked.book;
+    std::cout << "\nPre-orders, " << config.slotMs / MINUTE << " min slots, " << config.bookablePercent
+              << "% bookable, shift up to " << config.maxShiftSlots << " slots (peak queue depth "
+              << booked.peakDepth << "):\n";
+    printWaits("commuters ", booked.commuterWaits);
+    printWaits("walk-ups  ", booked.walkUpWaits);
+    std::vector<int64_t> standing = booked.standing;
+    std::sort(standing.begin(), standing.end());
+    std::cout << "  bookings: " << s.booked << " of " << s.requested << ", " << s.shifted << " moved (mean "
+              << std::setprecision(1) << (s.shifted ? s.shiftMsTotal / static_cast<double>(s.shifted) / MINUTE : 0.0)
+              << " min), refused " << s.refusedFull << " full / " << s.refusedStock << " stock / " << s.refusedTime
+              << " time; busiest slot " << s.peakSlotWorkMs / 1000 << " s of " << config.slotMs / 1000 << " s\n"
+              << "  " << standing.size() << " drinks ready before their customer, median "
+              << (standing.empty() ? 0.0 : standing[standing.size() / 2] / 1000.0) << " s, max "
+              << (standing.empty() ? 0.0 : standing.back() / 1000.0) << " s\n";
+    return 0;
+}
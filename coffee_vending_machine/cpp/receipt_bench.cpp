@@ -0,0 +1,244 @@
+/**
+ * Coffee Vending Machine - Receipt Log Benchmark (C++)
+ *
+ * Part 1 has writer threads append receipts to a set of per-machine logs
+ * sharing one ReceiptWriter (batched writev, fdatasync per batch, rotation
+ * under load), next to the straightforward design of one write() per
+ * receipt, and reports receipts per second, batching and stalls.
+ *
+ * Part 2 sells drinks on real machines with cash, card and UPI payments
+ * and a receipt log attached. Afterwards every log, rotated files
+ * included, is read back: each machine must have exactly the orders it
+ * sold, numbered without gaps, and no full card number may appear.
+ *
+ * Usage: receipt_bench [--receipts N] [--machines N] [--threads N]
+ *                      [--dir PATH] [--rotate-mb N] [--no-sync]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "ConsoleGuard.hpp"
+#include "CoffeeMachine.hpp"
+#include "Operator.hpp"
+#include "ReceiptLog.hpp"
+
+static const int KEEP_FILES = 64; // enough that the check sees every line
+
+static std::string logPath(const std::string& dir, const char* prefix, size_t machine) {
+    return dir + "/" + prefix + "-" + std::to_string(machine + 1) + ".log";
+}
+
+static void removeLogs(const std::string& path) {
+    ::unlink(path.c_str());
+    for (int generation = 1; generation <= KEEP_FILES; ++generation) {
+        ::unlink((path + "." + std::to_string(generation)).c_str());
+    }
+}
+
+// Order numbers found in a log and its rotated files, oldest first
+struct LogCheck {
+    uint64_t lines = 0;
+    uint64_t gaps = 0;          // order numbers out of sequence
+    uint64_t fullCardNumbers = 0;
+};
+
+static LogCheck checkLog(const std::string& path, const std::string& cardNumber) {
+    LogCheck check;
+    uint64_t expected = 1;
+    for (int generation = KEEP_FILES; generation >= 0; --generation) {
+        std::ifstream in(generation == 0 ? path : path + "." + std::to_string(generation));
+        std::string line;
+        while (std::getline(in, line)) {
+            check.lines++;
+            size_t at = line.find(" order=");
+            uint64_t order = at == std::string::npos ? 0 : std::strtoull(line.c_str() + at + 7, nullptr, 10);
+            if (order != expected) check.gaps++;
+            expected = order + 1;
+            if (!cardNumber.empty() && line.find(cardNumber) != std::string::npos) check.fullCardNumbers++;
+        }
+    }
+    return check;
+}
+
+static double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// One write() per receipt, the design the log replaces
+static double perReceiptWrites(const std::string& dir, size_t receipts) {
+    std::string path = dir + "/unbatched.log";
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_APPEND, 0644);
+    if (fd < 0) {
+        std::perror(path.c_str());
+        return 0.0;
+    }
+    char line[ReceiptLog::MAX_LINE];
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < receipts; ++i) {
+        int n = std::snprintf(line, sizeof(line), "2026-10-18T09:31:07.123Z machine=1 order=%zu drink=Latte "
+                              "amount=4.00 method=Card ref=****1111\n", i + 1);
+        if (::write(fd, line, static_cast<size_t>(n)) != n) break;
+    }
+    double seconds = secondsSince(start);
+    ::close(fd);
+    ::unlink(path.c_str());
+    return receipts / seconds;
+}
+
+int main(int argc, char* argv[]) {
+    size_t receipts = 1000000;
+    size_t machines = 8;
+    size_t threads = 4;
+    std::string dir = "/tmp/receipt_bench";
+    long rotateMb = 4;
+    bool sync = true;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--receipts") == 0 && i + 1 < argc) {
+            receipts = static_cast<size_t>(std::max(1L, std::atol(argv[++i])));
+        } else if (std::strcmp(argv[i], "--machines") == 0 && i + 1 < argc) {
+            machines = static_cast<size_t>(std::max(1L, std::atol(argv[++i])));
+        } else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = static_cast<size_t>(std::max(1L, std::atol(argv[++i])));
+        } else if (std::strcmp(argv[i], "--dir") == 0 && i + 1 < argc) {
+            dir = argv[++i];
+        } else if (std::strcmp(argv[i], "--rotate-mb") == 0 && i + 1 < argc) {
+            rotateMb = std::max(0L, std::atol(argv[++i]));
+        } else if (std::strcmp(argv[i], "--no-sync") == 0) {
+            sync = false;
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--receipts N] [--machines N] [--threads N]\n"
+                      << "       [--dir PATH] [--rotate-mb N] [--no-sync]\n";
+            return 1;
+        }
+    }
+    threads = std::min(threads, machines);
+    ::mkdir(dir.c_str(), 0755);
+
+    ReceiptConfig config;
+    config.rotateBytes = static_cast<uint64_t>(rotateMb) << 20;
+    config.keepFiles = KEEP_FILES;
+    config.sync = sync;
+
+    // Part 1: raw append throughput, each thread feeding its own machines
+    std::vector<std::string> paths;
+    for (size_t m = 0; m < machines; ++m) {
+        paths.push_back(logPath(dir, "bench", m));
+        removeLogs(paths.back());
+    }
+    ReceiptWriter::Stats stats;
+    double seconds = 0.0;
+    {
+        ReceiptWriter writer(config);
+        std::vector<std::unique_ptr<ReceiptLog>> logs;
+        for (size_t m = 0; m < machines; ++m) {
+            logs.push_back(writer.openLog(paths[m], static_cast<uint32_t>(m + 1)));
+            if (!logs.back()) return 1;
+        }
+        const char* drinks[] = {"Espresso", "Americano", "Latte", "Cappuccino", "Mocha"};
+        const char* methods[] = {"Cash", "Card", "UPI"};
+        const char* references[] = {"", "****1111", "a***@bank"};
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> workers;
+        for (size_t t = 0; t < threads; ++t) {
+            workers.emplace_back([&, t] {
+                size_t share = receipts / threads + (t < receipts % threads ? 1 : 0);
+                for (size_t i = 0; i < share; ++i) {
+                    ReceiptLog& log = *logs[t + (i % ((machines - t + threads - 1) / threads)) * threads];
+                    int kind = static_cast<int>(i % 3);
+                    log.append({drinks[i % 5], 250 + static_cast<int64_t>(i % 5) * 50, methods[kind], references[kind]});
+                }
+            });
+        }
+        for (auto& worker : workers) worker.join();
+        writer.flush();
+        seconds = secondsSince(start);
+        stats = writer.getStats();
+    }
+    uint64_t lines = 0;
+    uint64_t gaps = 0;
+    for (const auto& path : paths) {
+        LogCheck check = checkLog(path, "");
+        lines += check.lines;
+        gaps += check.gaps;
+    }
+    size_t unbatchedCount = std::min<size_t>(receipts, 200000);
+    double unbatched = perReceiptWrites(dir, unbatchedCount);
+
+    std::cout << std::fixed << std::setprecision(0);
+    std::cout << receipts << " receipts from " << threads << " thread(s) into " << machines << " machine logs ("
+              << (sync ? "fdatasync per batch" : "no sync") << ", rotate at " << rotateMb << " MB)\n";
+    std::cout << "  batched log   : " << receipts / seconds << " receipts/s, " << stats.batches << " writev ("
+              << std::setprecision(1) << static_cast<double>(stats.receipts) / std::max<uint64_t>(stats.batches, 1)
+              << " receipts each), " << stats.syncs << " syncs, " << stats.rotations << " rotations, "
+              << stats.stalls << " stalls, " << std::setprecision(1) << stats.bytesWritten / 1048576.0 << " MB\n";
+    std::cout << std::setprecision(0) << "  write() each  : " << unbatched << " receipts/s (" << unbatchedCount
+              << " receipts, no sync)\n";
+    std::cout << "  read back     : " << lines << " lines, " << gaps << " numbering gaps\n";
+    bool ok = lines == receipts && gaps == 0 && stats.writeErrors == 0 && stats.syncErrors == 0;
+
+    // Part 2: receipts from real payments
+    const size_t perMachine = 2000;
+    const std::string cardNumber = "4111111111111111";
+    std::vector<std::string> salePaths;
+    uint64_t sold = 0;
+    {
+        ReceiptWriter writer(config);
+        std::vector<std::unique_ptr<ReceiptLog>> logs;
+        std::vector<std::unique_ptr<CoffeeMachine>> fleet;
+        ConsoleGuard quiet;
+        for (size_t m = 0; m < machines; ++m) {
+            salePaths.push_back(logPath(dir, "machine", m));
+            removeLogs(salePaths.back());
+            logs.push_back(writer.openLog(salePaths.back(), static_cast<uint32_t>(m + 1)));
+            if (!logs.back()) return 1;
+            fleet.push_back(CoffeeMachine::create());
+            fleet.back()->attachReceipts(logs.back().get());
+        }
+        for (size_t i = 0; i < perMachine; ++i) {
+            for (size_t m = 0; m < machines; ++m) {
+                CoffeeMachine& machine = *fleet[m];
+                if (i % 20 == 19) {
+                    for (const auto& [ingredient, amount] : Operator::getRefillAmounts()) {
+                        machine.getInventory()->refillIngredient(ingredient, amount);
+                    }
+                }
+                machine.selectCoffee(static_cast<int>(i % 5) + 1);
+                if (machine.getSelectedCoffee() == nullptr) continue;
+                switch (i % 3) {
+                    case 0: machine.makePayment(std::make_unique<CashPayment>(10.00)); break;
+                    case 1: machine.makePayment(std::make_unique<CardPayment>(cardNumber, "1234")); break;
+                    default: machine.makePayment(std::make_unique<UPIPayment>("alice@bank")); break;
+                }
+                sold++; // every method here pays
+            }
+        }
+        for (auto& machine : fleet) machine->attachReceipts(nullptr);
+    }
+    LogCheck sales;
+    for (const auto& path : salePaths) {
+        LogCheck check = checkLog(path, cardNumber);
+        sales.lines += check.lines;
+        sales.gaps += check.gaps;
+        sales.fullCardNumbers += check.fullCardNumbers;
+    }
+    std::cout << "\n" << machines << " machines selling " << perMachine << " rounds: " << sold << " cups sold, "
+              << sales.lines << " receipts, " << sales.gaps << " numbering gaps, " << sales.fullCardNumbers
+              << " unmasked card numbers\n";
+    ok = ok && sales.lines == sold && sales.gaps == 0 && sales.fullCardNumbers == 0;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,351 @@
+/**
+ * Coffee Vending Machine - Refill Route Benchmark (C++)
+ *
+ * Simulates a fleet of machines spread over a 24 x 24 km city, each with
+ * its own Inventory and a daily demand of 1 to 25 drinks, and compares
+ * two ways of running the refill vans:
+ *
+ *   patrol   - every van walks its share of the fleet in a fixed order,
+ *              as many machines per shift as fit, and tops each one up by
+ *              Operator::getRefillAmounts (never past the full level)
+ *   planned  - a RefillRoutePlanner reads the fleet hourly and plans the
+ *              shift's routes at 08:00; the vans fill to the planned
+ *              quantities. Low-stock alerts during the day trigger a
+ *              re-plan (at most every 30 simulated minutes), which is
+ *              timed; the vans keep the morning routes.
+ *
+ * Both policies see the same fleet and demand. The first two days are
+ * warm-up (the planner has no rates yet) and not counted. Reported: lost
+ * drinks, machine-days with a stock-out, stops, van shifts and kilometres.
+ * Then plan() is timed on fleets of 1,000 to 10,000 machines.
+ *
+ * Usage: refill_route_bench [--machines N] [--vans N] [--days N] [--seed N]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "ConsoleGuard.hpp"
+#include "Operator.hpp"
+#include "RefillRoutePlanner.hpp"
+
+static const int DAY_MINUTES = 24 * 60;
+static const int SHIFT_START = 8 * 60;
+static const int WARMUP_DAYS = 2;
+static const int64_t REPLAN_GAP_MS = 30 * 60000;
+
+struct Drink {
+    int minute;
+    uint32_t machine;
+    CoffeeType type;
+};
+
+struct Visit {
+    double minute;
+    uint32_t machine;
+    int quantity[InventorySnapshot::MAX_INGREDIENTS];
+};
+
+struct Fleet {
+    std::vector<std::unique_ptr<Inventory>> inventories;
+    std::vector<FleetSite> sites;
+    std::vector<double> demand;        // drinks per day
+};
+
+static Fleet buildFleet(size_t machines, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> coordinate(-12.0, 12.0);
+    std::lognormal_distribution<double> busy(1.0, 0.6);
+    std::discrete_distribution<int> drink({10, 20, 50, 10, 10});
+    Fleet fleet;
+    for (size_t m = 0; m < machines; ++m) {
+        fleet.inventories.push_back(std::make_unique<Inventory>());
+        Inventory* inventory = fleet.inventories.back().get();
+        fleet.sites.push_back({static_cast<uint32_t>(1000 + m), coordinate(rng), coordinate(rng), inventory});
+        fleet.demand.push_back(std::clamp(busy(rng), 1.0, 25.0));
+        // Machines were last refilled on different days
+        int served = std::uniform_int_distribution<int>(0, 8)(rng);
+        for (int d = 0; d < served; ++d) {
+            CoffeeType type = static_cast<CoffeeType>(drink(rng));
+            if (inventory->checkAvailability(type)) inventory->consumeIngredients(type);
+        }
+    }
+    return fleet;
+}
+
+static std::vector<Drink> dayOfDemand(const Fleet& fleet, std::mt19937& rng) {
+    std::uniform_int_distribution<int> minute(0, DAY_MINUTES - 1);
+    std::discrete_distribution<int> drink({10, 20, 50, 10, 10});
+    std::vector<Drink> drinks;
+    for (uint32_t m = 0; m < fleet.sites.size(); ++m) {
+        int count = std::poisson_distribution<int>(fleet.demand[m])(rng);
+        for (int c = 0; c < count; ++c) drinks.push_back({minute(rng), m, static_cast<CoffeeType>(drink(rng))});
+    }
+    std::stable_sort(drinks.begin(), drinks.end(), [](const Drink& a, const Drink& b) { return a.minute < b.minute; });
+    return drinks;
+}
+
+struct Outcome {
+    long demand = 0;
+    long lost = 0;
+    long stockoutDays = 0;             // machine-days with at least one lost drink
+    long stops = 0;
+    long vanShifts = 0;
+    double vanKm = 0.0;
+    long plans = 0;
+    double planMs = 0.0;
+    double worstPlanMs = 0.0;
+};
+
+// Fixed rounds: the fleet is split by angle around the depot, each van
+// walks its sector nearest-neighbour first and carries on the next day
+// where it stopped
+class Patrol {
+private:
+    const RefillPlannerConfig& config;
+    const Fleet& fleet;
+    std::vector<std::vector<uint32_t>> rounds;
+    std::vector<size_t> cursor;
+
+    double minutes(const FleetSite* from, const FleetSite* to) const {
+        double fx = from ? from->xKm : config.depotXKm, fy = from ? from->yKm : config.depotYKm;
+        double tx = to ? to->xKm : config.depotXKm, ty = to ? to->yKm : config.depotYKm;
+        return std::hypot(tx - fx, ty - fy) * config.roadFactor / config.speedKmh * 60.0;
+    }
+
+public:
+    Patrol(const RefillPlannerConfig& plannerConfig, const Fleet& machines)
+        : config(plannerConfig), fleet(machines), rounds(plannerConfig.vans), cursor(plannerConfig.vans, 0) {
+        std::vector<uint32_t> order(fleet.sites.size());
+        for (uint32_t m = 0; m < order.size(); ++m) order[m] = m;
+        auto angle = [&](uint32_t m) { return std::atan2(fleet.sites[m].yKm, fleet.sites[m].xKm); };
+        std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return angle(a) < angle(b); });
+        size_t vans = rounds.size();
+        for (size_t v = 0; v < vans; ++v) {
+            std::vector<uint32_t> sector(order.begin() + static_cast<std::ptrdiff_t>(order.size() * v / vans),
+                                         order.begin() + static_cast<std::ptrdiff_t>(order.size() * (v + 1) / vans));
+            const FleetSite* at = nullptr;
+            while (!sector.empty()) {
+                auto next = std::min_element(sector.begin(), sector.end(), [&](uint32_t a, uint32_t b) {
+                    return minutes(at, &fleet.sites[a]) < minutes(at, &fleet.sites[b]);
+                });
+                rounds[v].push_back(*next);
+                at = &fleet.sites[*next];
+                sector.erase(next);
+            }
+        }
+    }
+
+    void shift(const std::vector<std::string>& names, std::vector<Visit>& visits, Outcome& outcome) {
+        Visit fixed{0.0, 0, {}};
+        for (size_t i = 0; i < names.size(); ++i) {
+            for (const auto& [ingredient, amount] : Operator::getRefillAmounts()) {
+                if (ingredient == names[i]) fixed.quantity[i] = amount;
+            }
+        }
+        for (size_t v = 0; v < rounds.size(); ++v) {
+            if (rounds[v].empty()) continue;
+            double clock = 0.0;
+            int served = 0;
+            const FleetSite* at = nullptr;
+            while (true) {
+                const FleetSite* next = &fleet.sites[rounds[v][cursor[v]]];
+                double arrive = clock + minutes(at, next);
+                if (arrive + config.serviceMinutes + minutes(next, nullptr) > config.shiftMinutes) break;
+                fixed.minute = SHIFT_START + arrive;
+                fixed.machine = rounds[v][cursor[v]];
+                visits.push_back(fixed);
+                served++;
+                clock = arrive + config.serviceMinutes;
+                at = next;
+                cursor[v] = (cursor[v] + 1) % rounds[v].size();
+            }
+            if (!at) continue;
+            clock += minutes(at, nullptr);
+            outcome.stops += served;
+            outcome.vanShifts++;
+            outcome.vanKm += (clock - config.serviceMinutes * served) * config.speedKmh / 60.0;
+        }
+    }
+};
+
+static double timedPlan(RefillRoutePlanner& planner, int64_t nowMs, RefillPlan& plan) {
+    auto start = std::chrono::steady_clock::now();
+    plan = planner.plan(nowMs);
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+static Outcome simulate(bool planned, size_t machines, int vans, int days, unsigned seed) {
+    Fleet fleet = buildFleet(machines, seed);
+    RefillPlannerConfig config;
+    config.vans = vans;
+    RefillRoutePlanner planner(config);
+    const std::vector<std::string>& names = planner.getIngredientNames();
+    std::vector<std::unique_ptr<FleetAlertRelay>> relays;
+    for (size_t m = 0; m < machines; ++m) {
+        uint32_t site = planner.addSite(fleet.sites[m]);
+        if (!planned) continue;
+        relays.push_back(std::make_unique<FleetAlertRelay>(&planner, site));
+        fleet.inventories[m]->addObserver(relays.back().get());
+    }
+    Patrol patrol(planner.getConfig(), fleet);
+
+    ConsoleGuard quiet;
+    std::mt19937 rng(seed + 1);
+    Outcome total;
+    int64_t lastPlanMs = 0;
+    for (int day = 0; day < WARMUP_DAYS + days; ++day) {
+        Outcome today;
+        std::vector<Drink> drinks = dayOfDemand(fleet, rng);
+        std::vector<Visit> visits;
+        std::vector<bool> ranOut(machines, false);
+        size_t nextDrink = 0, nextVisit = 0;
+        for (int minute = 0; minute < DAY_MINUTES; ++minute) {
+            int64_t nowMs = (static_cast<int64_t>(day) * DAY_MINUTES + minute) * 60000;
+            if (planned && minute % 60 == 0) planner.observe(nowMs);
+            if (minute == SHIFT_START) {
+                if (planned) {
+                    RefillPlan plan;
+                    double ms = timedPlan(planner, nowMs, plan);
+                    lastPlanMs = nowMs;
+                    today.plans++;
+                    today.planMs += ms;
+                    today.worstPlanMs = std::max(today.worstPlanMs, ms);
+                    for (const RefillRoute& route : plan.routes) {
+                        for (const RefillStop& stop : route.stops) {
+                            Visit visit{SHIFT_START + stop.arrivalMinutes, stop.site, {}};
+                            std::copy(std::begin(stop.quantity), std::end(stop.quantity), visit.quantity);
+                            visits.push_back(visit);
+                        }
+                        today.stops += static_cast<long>(route.stops.size());
+                        today.vanKm += route.travelKm;
+                        today.vanShifts++;
+                    }
+                } else {
+                    patrol.shift(names, visits, today);
+                }
+                std::sort(visits.begin(), visits.end(), [](const Visit& a, const Visit& b) { return a.minute < b.minute; });
+            }
+            for (; nextVisit < visits.size() && visits[nextVisit].minute < minute + 1; ++nextVisit) {
+                const Visit& visit = visits[nextVisit];
+                Inventory* inventory = fleet.inventories[visit.machine].get();
+                for (size_t i = 0; i < names.size(); ++i) {
+                    int room = planner.getFullLevel(static_cast<uint32_t>(i)) - inventory->getIngredients().at(names[i]);
+                    int amount = std::min(visit.quantity[i], room);
+                    if (amount > 0) inventory->refillIngredient(names[i], amount);
+                }
+            }
+            for (; nextDrink < drinks.size() && drinks[nextDrink].minute == minute; ++nextDrink) {
+                const Drink& drink = drinks[nextDrink];
+                today.demand++;
+                Inventory* inventory = fleet.inventories[drink.machine].get();
+                if (inventory->checkAvailability(drink.type)) {
+                    inventory->consumeIngredients(drink.type);
+                } else {
+                    today.lost++;
+                    ranOut[drink.machine] = true;
+                }
+                if (planned && planner.hasPendingAlerts() && nowMs - lastPlanMs >= REPLAN_GAP_MS) {
+                    RefillPlan plan;
+                    double ms = timedPlan(planner, nowMs, plan);
+                    lastPlanMs = nowMs;
+                    today.plans++;
+                    today.planMs += ms;
+                    today.worstPlanMs = std::max(today.worstPlanMs, ms);
+                }
+            }
+        }
+        today.stockoutDays = static_cast<long>(std::count(ranOut.begin(), ranOut.end(), true));
+        if (day < WARMUP_DAYS) continue;
+        total.demand += today.demand;
+        total.lost += today.lost;
+        total.stockoutDays += today.stockoutDays;
+        total.stops += today.stops;
+        total.vanShifts += today.vanShifts;
+        total.vanKm += today.vanKm;
+        total.plans += today.plans;
+        total.planMs += today.planMs;
+        total.worstPlanMs = std::max(total.worstPlanMs, today.worstPlanMs);
+    }
+    for (size_t m = 0; m < relays.size(); ++m) fleet.inventories[m]->removeObserver(relays[m].get());
+    return total;
+}
+
+int main(int argc, char* argv[]) {
+    size_t machines = 2000;
+    int vans = 0;
+    int days = 7;
+    unsigned seed = 11;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--machines") == 0 && i + 1 < argc) {
+            machines = static_cast<size_t>(std::max(10, std::atoi(argv[++i])));
+        } else if (std::strcmp(argv[i], "--vans") == 0 && i + 1 < argc) {
+            vans = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--days") == 0 && i + 1 < argc) {
+            days = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = static_cast<unsigned>(std::atoi(argv[++i]));
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--machines N] [--vans N] [--days N] [--seed N]\n";
+            return 1;
+        }
+    }
+    if (vans == 0) vans = static_cast<int>(std::max<size_t>(1, machines / 50));
+
+    std::cout << machines << " machines, " << vans << " vans (8 h shifts), " << days << " days\n\n";
+    std::cout << std::fixed;
+    const char* labels[] = {"patrol", "planned"};
+    for (bool planned : {false, true}) {
+        Outcome o = simulate(planned, machines, vans, days, seed);
+        std::cout << std::left << std::setw(8) << labels[planned] << std::right << std::setprecision(2)
+                  << " lost drinks " << std::setw(5) << 100.0 * o.lost / std::max(1L, o.demand) << "%"
+                  << std::setprecision(1) << "  stock-outs/day " << std::setw(6) << double(o.stockoutDays) / days
+                  << "  stops/day " << std::setw(7) << double(o.stops) / days
+                  << "  van shifts/day " << std::setw(5) << double(o.vanShifts) / days
+                  << "  van km/day " << std::setw(7) << o.vanKm / days << "\n";
+        if (planned) {
+            std::cout << "         " << o.plans << " plans (morning + on alerts), " << std::setprecision(2)
+                      << o.planMs / std::max(1L, o.plans) << " ms mean, " << o.worstPlanMs << " ms worst\n";
+        }
+    }
+
+    std::cout << "\nPlanning time by fleet size (rates learned over half a day of demand)\n";
+    for (size_t size : {1000, 2000, 5000, 10000}) {
+        Fleet fleet = buildFleet(size, seed);
+        RefillPlannerConfig config;
+        config.vans = static_cast<int>(std::max<size_t>(1, size / 50));
+        RefillRoutePlanner planner(config);
+        for (const FleetSite& site : fleet.sites) planner.addSite(site);
+        std::mt19937 rng(seed + 2);
+        planner.observe(0);
+        for (const Drink& drink : dayOfDemand(fleet, rng)) {
+            if (drink.minute >= DAY_MINUTES / 2) break;
+            Inventory* inventory = fleet.inventories[drink.machine].get();
+            if (inventory->checkAvailability(drink.type)) inventory->consumeIngredients(drink.type);
+        }
+        RefillPlan plan;
+        double worst = 0.0, sum = 0.0;
+        const int runs = 5;
+        for (int r = 0; r < runs; ++r) {
+            double ms = timedPlan(planner, static_cast<int64_t>(DAY_MINUTES / 2 + r) * 60000, plan);
+            sum += ms;
+            worst = std::max(worst, ms);
+        }
+        size_t stops = 0;
+        for (const RefillRoute& route : plan.routes) stops += route.stops.size();
+        std::cout << std::setw(7) << size << " machines: " << std::setw(5) << plan.due << " due, " << std::setw(5)
+                  << stops << " stops on " << std::setw(3) << plan.routes.size() << " vans, " << std::setw(4)
+                  << plan.unserved.size() << " unserved  " << std::setprecision(2) << std::setw(7) << sum / runs
+                  << " ms mean, " << std::setw(7) << worst << " ms worst\n";
+    }
+    return 0;
+}
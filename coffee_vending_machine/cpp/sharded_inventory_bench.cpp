@@ -0,0 +1,132 @@
+/**
+ * Coffee Vending Machine - Inventory Scaling Benchmark (C++)
+ *
+ * Compares consume throughput of one mutex-guarded ShardedInventory with a
+ * single shard (every order serialised, the classic design) against the
+ * same ShardedInventory with one shard per core, as the number of order
+ * threads grows. Both columns run the same data structure, so the ratio
+ * is contention, not bookkeeping; each column's scaling is also reported
+ * against its own single-thread rate. Then checks that a sharded run
+ * against scarce stock never oversells.
+ *
+ * Usage: sharded_inventory_bench [--threads N] [--orders N]
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstring>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ConsoleGuard.hpp"
+#include "Inventory.hpp"
+#include "ShardedInventory.hpp"
+
+template <typename ConsumeFn>
+static double runThreads(int threads, long ordersPerThread, ConsumeFn consume) {
+    std::vector<std::thread> workers;
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&consume, ordersPerThread, t] {
+            for (long i = 0; i < ordersPerThread; ++i) {
+                consume(static_cast<CoffeeType>((i + t) % static_cast<long>(CoffeeType::COUNT)));
+            }
+        });
+    }
+    for (auto& worker : workers) worker.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return static_cast<double>(threads) * static_cast<double>(ordersPerThread) / seconds;
+}
+
+static std::string ratio(double value) {
+    std::ostringstream text;
+    text << std::fixed << std::setprecision(2) << value << "x";
+    return text.str();
+}
+
+static void stockInventory(Inventory& inventory, int scale) {
+    const Inventory defaults;
+    for (const auto& [ingredient, quantity] : defaults.getIngredients()) {
+        inventory.refillIngredient(ingredient, quantity * scale);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    unsigned hw = std::thread::hardware_concurrency();
+    int maxThreads = static_cast<int>(hw > 0 ? hw : 1);
+    long orders = 2000000;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            maxThreads = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--orders") == 0 && i + 1 < argc) {
+            orders = std::max(1L, std::atol(argv[++i]));
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--threads N] [--orders N]\n";
+            return 1;
+        }
+    }
+
+    std::cout << "\n========== INVENTORY CONSUME SCALING ==========\n";
+    std::cout << std::left << std::setw(10) << "Threads"
+              << std::setw(18) << "Mutex (ops/s)" << std::setw(10) << "Scaling"
+              << std::setw(18) << "Sharded (ops/s)" << std::setw(10) << "Scaling" << "Sharded/Mutex\n";
+
+    std::cout << std::fixed << std::setprecision(0);
+    double mutexBase = 0.0, shardedBase = 0.0;
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+        long perThread = orders / threads;
+        double mutexRate, shardedRate;
+        {
+            ConsoleGuard quiet;
+            // Enough stock that nothing runs out during the run
+            int scale = static_cast<int>(orders / 5) + 1;
+            Inventory seed;
+            stockInventory(seed, scale);
+
+            ShardedInventory single(seed, 1);
+            std::mutex lock;
+            mutexRate = runThreads(threads, perThread, [&](CoffeeType type) {
+                std::lock_guard<std::mutex> guard(lock);
+                single.consumeIngredients(type);
+            });
+
+            ShardedInventory sharded(seed);
+            shardedRate = runThreads(threads, perThread, [&](CoffeeType type) {
+                sharded.consumeIngredients(type);
+            });
+        }
+        if (threads == 1) {
+            mutexBase = mutexRate;
+            shardedBase = shardedRate;
+        }
+        std::cout << std::setw(10) << threads
+                  << std::setw(18) << mutexRate << std::setw(10) << ratio(mutexRate / mutexBase)
+                  << std::setw(18) << shardedRate << std::setw(10) << ratio(shardedRate / shardedBase)
+                  << ratio(shardedRate / mutexRate) << "\n";
+    }
+
+    // Oversell check: scarce stock, every thread hammering Mochas
+    ShardedInventory scarce{Inventory()};
+    std::atomic<long> served{0};
+    {
+        ConsoleGuard quiet;
+        runThreads(maxThreads, 1000, [&](CoffeeType) {
+            if (scarce.consumeIngredients(CoffeeType::MOCHA)) served++;
+        });
+    }
+    auto levels = scarce.getIngredients();
+    Inventory reference;
+    long expected = reference.getIngredients().at("Chocolate") / 30;  // chocolate bound
+    bool ok = served == expected && levels.at("Chocolate") >= 0 && levels.at("Cups") >= 0;
+
+    std::cout << "\nOversell check: served " << served << " Mochas (stock allows "
+              << expected << "), chocolate left " << levels.at("Chocolate")
+              << " -> " << (ok ? "OK" : "FAILED") << "\n";
+    std::cout << "================================================\n";
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,160 @@
+/**
+ * Coffee Vending Machine - Static vs Dynamic Machine Benchmark (C++)
+ *
+ * 1. Parity: runs the same scripted session (all payment kinds, failures,
+ *    cancellation, maintenance, depletion alerts, refills) on CoffeeMachine
+ *    and StaticCoffeeMachine and compares the captured console output.
+ * 2. Throughput: drives the same order mix through both with output muted
+ *    and reports nanoseconds per order.
+ *
+ * Usage: static_machine_bench [--orders N]
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <type_traits>
+
+#include "ConsoleGuard.hpp"
+#include "CoffeeMachine.hpp"
+#include "StaticCoffeeMachine.hpp"
+
+class RecordingObserver : public InventoryObserver {
+public:
+    void update(const std::string& ingredient, int currentLevel, int threshold) override {
+        std::cout << "[ALERT] " << ingredient << " at " << currentLevel
+                  << " (threshold: " << threshold << ")\n";
+    }
+};
+
+// Uniform helpers over the two machine flavours
+template <typename P>
+static void pay(CoffeeMachine& machine, P payment) {
+    OrderArena::Scope scope(machine.getOrderArena());
+    machine.makePayment(std::make_unique<P>(std::move(payment)));
+}
+
+template <typename P>
+static void pay(StaticCoffeeMachine& machine, P payment) {
+    machine.makePayment(std::move(payment));
+}
+
+static void refill(CoffeeMachine& machine, const std::string& ingredient, int amount) {
+    machine.getInventory()->refillIngredient(ingredient, amount);
+}
+
+static void refill(StaticCoffeeMachine& machine, const std::string& ingredient, int amount) {
+    machine.refillIngredient(ingredient, amount);
+}
+
+static void showInventory(CoffeeMachine& machine) { machine.getInventory()->displayInventory(); }
+static void showInventory(StaticCoffeeMachine& machine) { machine.displayInventory(); }
+
+template <typename Machine>
+static std::string runParityScript(Machine& machine) {
+    std::ostringstream captured;
+    std::streambuf* saved = std::cout.rdbuf(captured.rdbuf());
+    std::cout.copyfmt(std::ios(nullptr));
+    RecordingObserver observer;
+    machine.registerObserver(&observer);
+
+    machine.displayMenu();
+    machine.selectCoffee(2);
+    pay(machine, CashPayment(5.00));
+    machine.selectCoffee(3);
+    pay(machine, CardPayment("1234567890123456", "1234"));
+    machine.selectCoffee(5);
+    pay(machine, UPIPayment("alice@upi"));
+    machine.selectCoffee(1);
+    pay(machine, CashPayment(1.00));
+    pay(machine, CardPayment("123", "1"));
+    machine.selectCoffee(4);
+    machine.displayStatus();
+    machine.cancelOrder();
+    machine.cancelOrder();
+    pay(machine, CashPayment(5.00));
+    machine.selectCoffee(9);
+    machine.selectCoffee(0);
+    machine.setOperational(false);
+    machine.selectCoffee(1);
+    machine.setOperational(true);
+    for (int i = 0; i < 12; ++i) {
+        machine.selectCoffee(i % 2 == 0 ? 5 : 3);
+        pay(machine, CashPayment(10.00));
+    }
+    showInventory(machine);
+    refill(machine, "Milk", 800);
+    refill(machine, "Chocolate", 150);
+    refill(machine, "Sugar", 10);
+    showInventory(machine);
+    machine.displayStatus();
+
+    machine.removeObserver(&observer);
+    std::cout.rdbuf(saved);
+    return captured.str();
+}
+
+template <typename Machine>
+static double nanosPerOrder(Machine& machine, long orders) {
+    auto start = std::chrono::steady_clock::now();
+    for (long i = 0; i < orders; ++i) {
+        machine.selectCoffee(static_cast<int>(i % 5) + 1);
+        pay(machine, CashPayment(10.00));
+        if (i % 5 == 4) {
+            refill(machine, "Coffee Beans", 100);
+            refill(machine, "Water", 300);
+            refill(machine, "Milk", 400);
+            refill(machine, "Chocolate", 30);
+            refill(machine, "Cups", 5);
+        }
+    }
+    auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start);
+    return elapsed.count() / static_cast<double>(orders);
+}
+
+int main(int argc, char* argv[]) {
+    long orders = 1000000;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--orders") == 0 && i + 1 < argc) {
+            orders = std::max(1L, std::atol(argv[++i]));
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--orders N]\n";
+            return 1;
+        }
+    }
+
+    bool identical;
+    {
+        auto dynamicMachine = CoffeeMachine::create();
+        StaticCoffeeMachine staticMachine;
+        std::string dynamicOutput = runParityScript(*dynamicMachine);
+        std::string staticOutput = runParityScript(staticMachine);
+        identical = dynamicOutput == staticOutput;
+        if (!identical) {
+            std::cout << "---- CoffeeMachine ----\n" << dynamicOutput
+                      << "---- StaticCoffeeMachine ----\n" << staticOutput;
+        }
+    }
+
+    double dynamicNs, staticNs;
+    {
+        auto dynamicMachine = CoffeeMachine::create();
+        StaticCoffeeMachine staticMachine;
+        ConsoleGuard quiet;
+        dynamicNs = nanosPerOrder(*dynamicMachine, orders);
+        staticNs = nanosPerOrder(staticMachine, orders);
+    }
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "\n========== STATIC VS DYNAMIC MACHINE ==========\n";
+    std::cout << "Behaviour parity      : " << (identical ? "identical output" : "MISMATCH") << "\n";
+    std::cout << "Orders per machine    : " << orders << "\n";
+    std::cout << "CoffeeMachine         : " << dynamicNs << " ns/order\n";
+    std::cout << "StaticCoffeeMachine   : " << staticNs << " ns/order\n";
+    std::cout << "Speedup               : " << dynamicNs / staticNs << "x\n";
+    std::cout << "================================================\n";
+    return identical ? 0 : 1;
+}
@@ -0,0 +1,271 @@
+/**
+ * Coffee Vending Machine - Multithreaded Contention Stress Harness (C++)
+ *
+ * Drives orders from N threads and reports a throughput scaling curve
+ * (1, 2, 4 ... N threads) plus per-lock wait statistics from ProfiledMutex.
+ *
+ * The machine core is single-threaded by design, so every order runs under
+ * its machine's lock. With --machines 1 all threads share the singleton
+ * (one lock, worst case); with --machines M threads are spread over M
+ * standalone machines, each with its own lock. --lookups calls
+ * CoffeeMachine::getInstance() on every order, as a User/Operator per order
+ * would, to expose the singleton mutex. --monitors K adds threads that poll
+ * the seqlock snapshots the whole time.
+ *
+ * Usage: stress_harness [--threads N] [--orders N] [--machines M]
+ *                       [--mix E,C,L,A,M] [--payments CASH,CARD,UPI]
+ *                       [--monitors K] [--lookups]
+ *   --orders    orders per thread per step (default 20000)
+ *   --mix       relative weights of the five drinks (default 30,25,25,10,10)
+ *   --payments  relative weights of payment kinds (default 60,30,10)
+ *
+ * 'make tsan' builds a ThreadSanitizer-instrumented binary and runs it
+ * with two machines and a monitor.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ConsoleGuard.hpp"
+#include "CoffeeMachine.hpp"
+#include "Operator.hpp"
+#include "ProfiledMutex.hpp"
+
+struct MachineSlot {
+    CoffeeMachine* machine;
+    ProfiledMutex lock;
+
+    MachineSlot(CoffeeMachine* m, const std::string& name) : machine(m), lock(name) {}
+};
+
+struct StepResult {
+    int threads = 0;
+    double seconds = 0.0;
+    uint64_t served = 0;
+    uint64_t refills = 0;
+    uint64_t monitorReads = 0;
+};
+
+static std::vector<double> parseWeights(const char* text, size_t expected) {
+    std::vector<double> weights;
+    std::stringstream ss(text);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        weights.push_back(std::atof(item.c_str()));
+    }
+    if (weights.size() != expected) {
+        std::cerr << "Expected " << expected << " comma-separated weights, got '" << text << "'\n";
+        std::exit(1);
+    }
+    return weights;
+}
+
+static std::unique_ptr<PaymentStrategy> makePayment(int kind) {
+    switch (kind) {
+        case 0: return std::make_unique<CashPayment>(10.00);
+        case 1: return std::make_unique<CardPayment>("1234567890123456", "1234");
+        default: return std::make_unique<UPIPayment>("stress@upi");
+    }
+}
+
+// One order under the machine lock; refills and retries once if unavailable
+static bool placeOrder(MachineSlot& slot, int choice, int paymentKind, uint64_t& refills) {
+    std::lock_guard<ProfiledMutex> guard(slot.lock);
+    CoffeeMachine* machine = slot.machine;
+    machine->selectCoffee(choice);
+    if (machine->getSelectedCoffee() == nullptr) {
+        for (const auto& [ingredient, amount] : Operator::getRefillAmounts()) {
+            machine->getInventory()->refillIngredient(ingredient, amount);
+        }
+        refills++;
+        machine->selectCoffee(choice);
+        if (machine->getSelectedCoffee() == nullptr) return false;
+    }
+    OrderArena::Scope scope(machine->getOrderArena());
+    machine->makePayment(makePayment(paymentKind));
+    return machine->getSelectedCoffee() == nullptr;
+}
+
+static StepResult runStep(std::vector<std::unique_ptr<MachineSlot>>& slots, int threads, long ordersPerThread,
+                          const std::vector<double>& mix, const std::vector<double>& payments,
+                          int monitors, bool lookups) {
+    StepResult result;
+    result.threads = threads;
+    std::atomic<uint64_t> served{0}, refills{0}, monitorReads{0};
+    std::atomic<bool> workersDone{false};
+
+    std::vector<std::thread> monitorThreads;
+    for (int m = 0; m < monitors; ++m) {
+        monitorThreads.emplace_back([&] {
+            uint64_t reads = 0;
+            while (!workersDone.load(std::memory_order_relaxed)) {
+                for (auto& slot : slots) {
+                    InventorySnapshot inv = slot->machine->getInventory()->readSnapshot();
+                    MachineStatusSnapshot status = slot->machine->readStatus();
+                    reads += (inv.count > 0) + (status.stateName[0] != '\0');
+                }
+            }
+            monitorReads += reads;
+        });
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            std::mt19937 rng(static_cast<unsigned>(t) * 7919u + 17u);
+            std::discrete_distribution<int> drink(mix.begin(), mix.end());
+            std::discrete_distribution<int> payment(payments.begin(), payments.end());
+            MachineSlot& slot = *slots[static_cast<size_t>(t) % slots.size()];
+            uint64_t localServed = 0, localRefills = 0;
+
+            for (long i = 0; i < ordersPerThread; ++i) {
+                if (lookups) {
+                    CoffeeMachine::getInstance();
+                }
+                if (placeOrder(slot, drink(rng) + 1, payment(rng), localRefills)) {
+                    localServed++;
+                }
+            }
+            served += localServed;
+            refills += localRefills;
+        });
+    }
+    for (auto& worker : workers) worker.join();
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    workersDone = true;
+    for (auto& monitor : monitorThreads) monitor.join();
+
+    result.served = served;
+    result.refills = refills;
+    result.monitorReads = monitorReads;
+    return result;
+}
+
+static void printLock(const std::string& name, const ProfiledMutex::Stats& stats) {
+    double contendedPct = stats.acquisitions
+        ? 100.0 * static_cast<double>(stats.contended) / static_cast<double>(stats.acquisitions) : 0.0;
+    double avgWait = stats.contended
+        ? static_cast<double>(stats.waitNanos) / static_cast<double>(stats.contended) : 0.0;
+    std::cout << "  " << std::left << std::setw(28) << name << std::right
+              << std::setw(12) << stats.acquisitions
+              << std::setw(10) << std::setprecision(1) << contendedPct << "%"
+              << std::setw(12) << std::setprecision(2) << static_cast<double>(stats.waitNanos) / 1e6
+              << std::setw(12) << std::setprecision(0) << avgWait
+              << std::setw(12) << std::setprecision(1) << static_cast<double>(stats.maxWaitNanos) / 1e3 << "\n";
+}
+
+int main(int argc, char* argv[]) {
+    unsigned hw = std::thread::hardware_concurrency();
+    int maxThreads = static_cast<int>(hw > 0 ? hw : 1);
+    long orders = 20000;
+    int machineCount = 1;
+    int monitors = 0;
+    bool lookups = false;
+    std::vector<double> mix = {30, 25, 25, 10, 10};
+    std::vector<double> payments = {60, 30, 10};
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            maxThreads = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--orders") == 0 && i + 1 < argc) {
+            orders = std::max(1L, std::atol(argv[++i]));
+        } else if (std::strcmp(argv[i], "--machines") == 0 && i + 1 < argc) {
+            machineCount = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--mix") == 0 && i + 1 < argc) {
+            mix = parseWeights(argv[++i], 5);
+        } else if (std::strcmp(argv[i], "--payments") == 0 && i + 1 < argc) {
+            payments = parseWeights(argv[++i], 3);
+        } else if (std::strcmp(argv[i], "--monitors") == 0 && i + 1 < argc) {
+            monitors = std::max(0, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--lookups") == 0) {
+            lookups = true;
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--threads N] [--orders N] [--machines M]"
+                      << " [--mix E,C,L,A,M] [--payments CASH,CARD,UPI] [--monitors K] [--lookups]\n";
+            return 1;
+        }
+    }
+
+    // --machines 1 shares the singleton; more machines are standalone
+    std::vector<std::unique_ptr<CoffeeMachine>> owned;
+    std::vector<std::unique_ptr<MachineSlot>> slots;
+    if (machineCount == 1) {
+        slots.push_back(std::make_unique<MachineSlot>(CoffeeMachine::getInstance(), "machine[singleton]"));
+    } else {
+        for (int m = 0; m < machineCount; ++m) {
+            owned.push_back(CoffeeMachine::create());
+            slots.push_back(std::make_unique<MachineSlot>(owned.back().get(),
+                                                          "machine[" + std::to_string(m) + "]"));
+        }
+    }
+
+    std::cout << "\n========== CONTENTION STRESS ==========\n";
+    std::cout << "Machines: " << machineCount << ", orders/thread: " << orders
+              << ", monitors: " << monitors << (lookups ? ", getInstance per order" : "") << "\n";
+
+    std::vector<StepResult> curve;
+    for (int threads = 1; ; threads *= 2) {
+        threads = std::min(threads, maxThreads);
+        for (auto& slot : slots) slot->lock.resetStats();
+        auto instanceBefore = CoffeeMachine::getInstanceLockStats();
+
+        StepResult step;
+        {
+            ConsoleGuard quiet;
+            step = runStep(slots, threads, orders, mix, payments, monitors, lookups);
+        }
+        curve.push_back(step);
+
+        ProfiledMutex::Stats instance = CoffeeMachine::getInstanceLockStats();
+        instance.acquisitions -= instanceBefore.acquisitions;
+        instance.contended -= instanceBefore.contended;
+        instance.waitNanos -= instanceBefore.waitNanos;
+
+        double rate = static_cast<double>(step.served) / step.seconds;
+        std::cout << std::fixed << std::setprecision(0);
+        std::cout << "\n[" << threads << " thread(s)] " << rate << " orders/s, served "
+                  << step.served << ", refills " << step.refills;
+        if (monitors > 0) {
+            std::cout << ", monitor reads/s " << static_cast<double>(step.monitorReads) / step.seconds;
+        }
+        std::cout << "\n  " << std::left << std::setw(28) << "lock" << std::right
+                  << std::setw(12) << "acquired" << std::setw(11) << "contended"
+                  << std::setw(12) << "wait ms" << std::setw(12) << "avg ns" << std::setw(12) << "max us" << "\n";
+        size_t shown = 0;
+        for (auto& slot : slots) {
+            if (shown++ == 8) {
+                std::cout << "  ... " << slots.size() - 8 << " more machine locks\n";
+                break;
+            }
+            printLock(slot->lock.getName(), slot->lock.getStats());
+        }
+        if (lookups) printLock("CoffeeMachine::getInstance", instance);
+
+        if (threads == maxThreads) break;
+    }
+
+    std::cout << "\nScaling curve (orders/s, relative to 1 thread):\n";
+    double base = static_cast<double>(curve.front().served) / curve.front().seconds;
+    for (const auto& step : curve) {
+        double rate = static_cast<double>(step.served) / step.seconds;
+        std::cout << "  " << std::setw(4) << step.threads << " threads  "
+                  << std::setw(12) << std::setprecision(0) << rate
+                  << "  " << std::setprecision(2) << rate / base << "x\n";
+    }
+    std::cout << "========================================\n";
+
+    CoffeeMachine::destroyInstance();
+    return 0;
+}
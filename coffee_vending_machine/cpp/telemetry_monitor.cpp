@@ -0,0 +1,133 @@
+/**
+ * Coffee Vending Machine - Shared-Memory Telemetry Monitor (C++)
+ *
+ * External monitoring process: maps a telemetry segment published by
+ * 'order_server --telemetry NAME' read-only and reports every machine's
+ * state, ingredient levels and counters without talking to the server.
+ *
+ * Usage: telemetry_monitor [--name NAME] [--limit N] [--watch MS] [--bench ROUNDS]
+ *   --name    segment name (default /coffee_telemetry)
+ *   --limit   machines listed individually (default 20; totals cover all)
+ *   --watch   refresh every MS milliseconds until interrupted
+ *   --bench   poll every record ROUNDS times and report the cost per read
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "TelemetrySegment.hpp"
+
+static const char* TYPE_NAMES[] = {"Espresso", "Cappuccino", "Latte", "Americano", "Mocha"};
+
+static void printReport(const TelemetrySegment& segment, uint32_t limit) {
+    uint32_t machines = segment.getMachineCount();
+    uint32_t ingredients = segment.getIngredientCount();
+    uint64_t accepted = 0;
+    uint64_t declined = 0;
+    uint64_t dispensed = 0;
+    int64_t revenueCents = 0;
+    uint32_t inMaintenance = 0;
+    uint32_t lowStock = 0;
+
+    std::cout << "\n=== Telemetry " << segment.getName() << " (writer pid " << segment.getWriterPid()
+              << ", " << machines << "/" << segment.getCapacity() << " machines) ===\n";
+    std::cout << std::left << std::setw(8) << "Machine" << std::setw(12) << "State"
+              << std::setw(5) << "Op" << std::setw(12) << "Selected";
+    for (uint32_t i = 0; i < ingredients; ++i) {
+        std::cout << std::setw(14) << segment.getIngredientName(i);
+    }
+    std::cout << std::right << std::setw(8) << "Served" << std::setw(12) << "Revenue" << "\n";
+
+    for (uint32_t m = 0; m < machines; ++m) {
+        TelemetryRecord record = segment.read(m);
+        accepted += record.paymentsAccepted;
+        declined += record.paymentsDeclined;
+        dispensed += record.dispensed + record.queued;
+        revenueCents += record.revenueCents;
+        if (!record.operational) inMaintenance++;
+        bool low = false;
+        for (uint16_t i = 0; i < record.ingredientCount; ++i) {
+            if (record.levels[i] <= record.thresholds[i]) low = true;
+        }
+        if (low) lowStock++;
+        if (m >= limit) continue;
+
+        std::cout << std::left << std::setw(8) << record.machineId << std::setw(12) << record.stateName
+                  << std::setw(5) << (record.operational ? "yes" : "no")
+                  << std::setw(12) << (record.selectedType >= 0 && record.selectedType < 5
+                                           ? TYPE_NAMES[record.selectedType] : "-");
+        for (uint16_t i = 0; i < record.ingredientCount; ++i) {
+            std::string cell = std::to_string(record.levels[i]);
+            if (record.levels[i] <= record.thresholds[i]) cell += " LOW";
+            std::cout << std::setw(14) << cell;
+        }
+        std::cout << std::right << std::setw(8) << record.dispensed + record.queued
+                  << std::setw(9) << "$" << record.revenueCents / 100 << "."
+                  << std::setfill('0') << std::setw(2) << record.revenueCents % 100
+                  << std::setfill(' ') << "\n";
+    }
+    if (machines > limit) {
+        std::cout << "... " << machines - limit << " more\n";
+    }
+    std::cout << "Fleet: " << dispensed << " served, " << accepted << " payments accepted, "
+              << declined << " declined, revenue $" << revenueCents / 100 << "."
+              << std::setfill('0') << std::setw(2) << revenueCents % 100 << std::setfill(' ')
+              << ", " << inMaintenance << " in maintenance, " << lowStock << " low on stock\n";
+}
+
+int main(int argc, char* argv[]) {
+    std::string name = "/coffee_telemetry";
+    uint32_t limit = 20;
+    long watchMs = 0;
+    long benchRounds = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--name") == 0 && i + 1 < argc) {
+            name = argv[++i];
+        } else if (std::strcmp(argv[i], "--limit") == 0 && i + 1 < argc) {
+            limit = static_cast<uint32_t>(std::max(0, std::atoi(argv[++i])));
+        } else if (std::strcmp(argv[i], "--watch") == 0 && i + 1 < argc) {
+            watchMs = std::max(1L, std::atol(argv[++i]));
+        } else if (std::strcmp(argv[i], "--bench") == 0 && i + 1 < argc) {
+            benchRounds = std::max(1L, std::atol(argv[++i]));
+        } else {
+            std::cerr << "Usage: " << argv[0]
+                      << " [--name NAME] [--limit N] [--watch MS] [--bench ROUNDS]\n";
+            return 1;
+        }
+    }
+
+    auto segment = TelemetrySegment::open(name);
+    if (!segment) {
+        return 1;
+    }
+
+    if (benchRounds > 0) {
+        uint32_t machines = segment->getMachineCount();
+        uint64_t checksum = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (long r = 0; r < benchRounds; ++r) {
+            for (uint32_t m = 0; m < machines; ++m) {
+                checksum += segment->read(m).dispensed;
+            }
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        double reads = static_cast<double>(benchRounds) * machines;
+        std::cout << "Polled " << machines << " machines x " << benchRounds << " rounds: "
+                  << std::fixed << std::setprecision(1) << seconds * 1e9 / reads << " ns/record, "
+                  << std::setprecision(3) << seconds * 1e3 / benchRounds << " ms per full sweep"
+                  << " (checksum " << checksum << ")\n";
+        return 0;
+    }
+
+    do {
+        printReport(*segment, limit);
+        if (watchMs > 0) std::this_thread::sleep_for(std::chrono::milliseconds(watchMs));
+    } while (watchMs > 0);
+    return 0;
+}
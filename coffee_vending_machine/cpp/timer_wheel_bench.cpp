@@ -0,0 +1,212 @@
+/**
+ * Coffee Vending Machine - Timer Wheel Benchmark (C++)
+ *
+ * Part 1 schedules millions of session-style deadlines (1 s - 10 min, most
+ * cancelled before they fire, as paid selections cancel their timeout) on
+ * the TimerWheel and on a binary heap with lazy cancellation, the usual
+ * alternative, and reports the cost per operation.
+ *
+ * Part 2 runs a fleet of machines on one wheel in simulated time. Every
+ * machine gets a customer who pays promptly, pays after a declined card, or
+ * walks away; customer actions are timers on the same wheel. Abandoned
+ * selections must be cancelled by their timeout, with every ingredient
+ * hold released and every machine back in Idle.
+ *
+ * Usage: timer_wheel_bench [--timers N] [--machines N] [--timeout S] [--seed N]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <queue>
+#include <random>
+#include <unordered_set>
+#include <vector>
+
+#include "ConsoleGuard.hpp"
+#include "CoffeeMachine.hpp"
+#include "TimerWheel.hpp"
+
+static uint64_t firedSink = 0;
+static void countFire(void*, uint64_t arg) { firedSink += arg; }
+
+struct Timing {
+    double scheduleNs = 0.0;
+    double cancelNs = 0.0;
+    double advanceMs = 0.0;
+    uint64_t fired = 0;
+};
+
+static double nsSince(std::chrono::steady_clock::time_point start, size_t ops) {
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / ops;
+}
+
+static Timing runWheel(const std::vector<int64_t>& delays, const std::vector<size_t>& cancels, int64_t horizonMs) {
+    Timing t;
+    TimerWheel wheel(10);
+    wheel.reserve(delays.size());
+    std::vector<TimerWheel::TimerId> ids(delays.size());
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < delays.size(); ++i) ids[i] = wheel.scheduleAfter(delays[i], &countFire, nullptr, 1);
+    t.scheduleNs = nsSince(start, delays.size());
+
+    start = std::chrono::steady_clock::now();
+    for (size_t i : cancels) wheel.cancel(ids[i]);
+    t.cancelNs = nsSince(start, cancels.size());
+
+    start = std::chrono::steady_clock::now();
+    for (int64_t now = 0; now <= horizonMs; now += 100) wheel.advance(now);
+    t.advanceMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    t.fired = wheel.getStats().fired;
+    return t;
+}
+
+// Min-heap of (due, id); cancelled ids are skipped when they surface
+static Timing runHeap(const std::vector<int64_t>& delays, const std::vector<size_t>& cancels, int64_t horizonMs) {
+    using Entry = std::pair<int64_t, uint64_t>;
+    Timing t;
+    std::vector<Entry> storage;
+    storage.reserve(delays.size());
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> heap(std::greater<Entry>(), std::move(storage));
+    std::unordered_set<uint64_t> cancelled;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < delays.size(); ++i) heap.push({delays[i], i});
+    t.scheduleNs = nsSince(start, delays.size());
+
+    start = std::chrono::steady_clock::now();
+    for (size_t i : cancels) cancelled.insert(i);
+    t.cancelNs = nsSince(start, cancels.size());
+
+    start = std::chrono::steady_clock::now();
+    for (int64_t now = 0; now <= horizonMs; now += 100) {
+        while (!heap.empty() && heap.top().first <= now) {
+            uint64_t id = heap.top().second;
+            heap.pop();
+            if (cancelled.erase(id)) continue;
+            countFire(nullptr, 1);
+            t.fired++;
+        }
+    }
+    t.advanceMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return t;
+}
+
+// --- Part 2: a fleet of machines sharing one wheel ---
+
+enum class Customer { PAYS, DECLINED_THEN_PAYS, WALKS_AWAY };
+
+struct Kiosk {
+    std::unique_ptr<CoffeeMachine> machine;
+    Customer customer;
+    bool declinedOnce = false;
+};
+
+static void customerActs(void* context, uint64_t) {
+    Kiosk* kiosk = static_cast<Kiosk*>(context);
+    if (kiosk->customer == Customer::DECLINED_THEN_PAYS && !kiosk->declinedOnce) {
+        kiosk->declinedOnce = true;
+        kiosk->machine->makePayment(std::make_unique<CardPayment>("4111", "1234"));
+        return;
+    }
+    kiosk->machine->makePayment(std::make_unique<CashPayment>(10.00));
+}
+
+int main(int argc, char* argv[]) {
+    size_t timers = 2000000;
+    size_t machines = 20000;
+    long timeoutSeconds = 60;
+    unsigned seed = 5;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--timers") == 0 && i + 1 < argc) {
+            timers = static_cast<size_t>(std::max(1L, std::atol(argv[++i])));
+        } else if (std::strcmp(argv[i], "--machines") == 0 && i + 1 < argc) {
+            machines = static_cast<size_t>(std::max(1L, std::atol(argv[++i])));
+        } else if (std::strcmp(argv[i], "--timeout") == 0 && i + 1 < argc) {
+            timeoutSeconds = std::max(1L, std::atol(argv[++i]));
+        } else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = static_cast<unsigned>(std::atol(argv[++i]));
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--timers N] [--machines N] [--timeout S] [--seed N]\n";
+            return 1;
+        }
+    }
+
+    std::mt19937 rng(seed);
+    const int64_t horizonMs = 600000;
+    std::uniform_int_distribution<int64_t> delay(1000, horizonMs);
+    std::vector<int64_t> delays(timers);
+    for (auto& d : delays) d = delay(rng);
+    std::vector<size_t> cancels;
+    std::uniform_int_distribution<int> percent(0, 99);
+    for (size_t i = 0; i < timers; ++i) {
+        if (percent(rng) < 90) cancels.push_back(i);
+    }
+
+    Timing wheel = runWheel(delays, cancels, horizonMs);
+    Timing heap = runHeap(delays, cancels, horizonMs);
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << timers << " deadlines over 10 min, " << cancels.size() << " cancelled before firing\n";
+    std::cout << "  timer wheel : schedule " << wheel.scheduleNs << " ns, cancel " << wheel.cancelNs
+              << " ns, advance 10 min in 100 ms steps " << wheel.advanceMs << " ms (" << wheel.fired << " fired)\n";
+    std::cout << "  binary heap : schedule " << heap.scheduleNs << " ns, cancel " << heap.cancelNs
+              << " ns, advance 10 min in 100 ms steps " << heap.advanceMs << " ms (" << heap.fired << " fired)\n";
+
+    // Fleet: everyone selects at once, customers act within the timeout
+    SessionTimeoutConfig config;
+    config.selectionTimeoutMs = timeoutSeconds * 1000;
+    config.paymentRetryMs = config.selectionTimeoutMs / 2;
+    TimerWheel fleetWheel(10);
+    std::vector<std::unique_ptr<Kiosk>> fleet;
+    std::uniform_int_distribution<int64_t> think(1000, config.selectionTimeoutMs / 2);
+    size_t walkAways = 0;
+    size_t peakReserved = 0;
+    auto start = std::chrono::steady_clock::now();
+    {
+        ConsoleGuard quiet;
+        for (size_t i = 0; i < machines; ++i) {
+            auto kiosk = std::make_unique<Kiosk>();
+            kiosk->machine = CoffeeMachine::create();
+            kiosk->machine->attachTimers(&fleetWheel, config);
+            int p = percent(rng);
+            kiosk->customer = p < 60 ? Customer::PAYS : p < 75 ? Customer::DECLINED_THEN_PAYS : Customer::WALKS_AWAY;
+            kiosk->machine->selectCoffee(static_cast<int>(i % 5) + 1);
+            peakReserved += static_cast<size_t>(kiosk->machine->getInventory()->getReservedCups());
+            if (kiosk->customer == Customer::WALKS_AWAY) {
+                walkAways++;
+            } else {
+                int64_t first = think(rng);
+                fleetWheel.scheduleAfter(first, &customerActs, kiosk.get());
+                if (kiosk->customer == Customer::DECLINED_THEN_PAYS) {
+                    // second try inside the retry window the decline opens
+                    fleetWheel.scheduleAfter(first + think(rng) / 2, &customerActs, kiosk.get());
+                }
+            }
+            fleet.push_back(std::move(kiosk));
+        }
+        for (int64_t now = 0; fleetWheel.size() > 0; now += 100) fleetWheel.advance(now);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    uint64_t timeouts = 0;
+    size_t stuck = 0;
+    size_t held = 0;
+    for (const auto& kiosk : fleet) {
+        timeouts += kiosk->machine->getSessionTimeouts();
+        if (kiosk->machine->getCurrentState()->getPhase() != OrderPathPhase::IDLE) stuck++;
+        held += static_cast<size_t>(kiosk->machine->getInventory()->getReservedCups());
+    }
+    const TimerWheel::Stats& s = fleetWheel.getStats();
+    std::cout << "\n" << machines << " machines on one wheel (timeout " << timeoutSeconds << " s): "
+              << timeouts << " selections timed out (" << walkAways << " walked away), " << stuck
+              << " machines not idle, " << held << " cups still held (" << peakReserved << " right after selecting)\n";
+    std::cout << "  wheel: " << s.scheduled << " scheduled, " << s.cancelled << " cancelled, " << s.fired
+              << " fired, " << s.cascaded << " cascades, peak " << s.peakLive << " live; "
+              << std::setprecision(3) << seconds << " s wall\n";
+    return timeouts == walkAways && stuck == 0 && held == 0 ? 0 : 1;
+}
@@ -0,0 +1,191 @@
+/**
+ * Coffee Vending Machine - Prepaid Wallet Benchmark (C++)
+ *
+ * Opens a population of prepaid wallets, times single debits, then lets
+ * several threads charge random wallets while a settlement thread applies
+ * top-ups in batches. Afterwards it checks that money is conserved, that no
+ * balance went negative and that the ledger agrees with the balances.
+ * Finally it runs orders end to end through User::walletPayment().
+ *
+ * Usage: wallet_bench [--users N] [--threads N] [--debits N] [--orders N]
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ConsoleGuard.hpp"
+#include "Operator.hpp"
+#include "User.hpp"
+
+static std::string userIdFor(long i) {
+    return "U" + std::to_string(100000 + i);
+}
+
+int main(int argc, char* argv[]) {
+    long users = 10000;
+    long threads = 4;
+    long debits = 200000;
+    long orders = 20000;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--users") == 0 && i + 1 < argc) {
+            users = std::max(1L, std::atol(argv[++i]));
+        } else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = std::max(1L, std::atol(argv[++i]));
+        } else if (std::strcmp(argv[i], "--debits") == 0 && i + 1 < argc) {
+            debits = std::max(1L, std::atol(argv[++i]));
+        } else if (std::strcmp(argv[i], "--orders") == 0 && i + 1 < argc) {
+            orders = std::max(1L, std::atol(argv[++i]));
+        } else {
+            std::cerr << "Usage: " << argv[0]
+                      << " [--users N] [--threads N] [--debits N] [--orders N]\n";
+            return 1;
+        }
+    }
+
+    const int64_t opening = 2000; // $20.00 each
+    WalletStore wallets(static_cast<size_t>(users));
+    std::vector<std::string> ids;
+    for (long i = 0; i < users; ++i) {
+        ids.push_back(userIdFor(i));
+        if (!wallets.openAccount(ids.back(), opening)) {
+            std::cerr << "Could not open wallet " << ids.back() << "\n";
+            return 1;
+        }
+    }
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "Opened " << wallets.getAccountCount() << " wallets\n";
+
+    // Single-threaded debit cost (lookup + CAS + ledger append)
+    {
+        auto start = std::chrono::steady_clock::now();
+        long accepted = 0;
+        for (long i = 0; i < debits; ++i) {
+            if (wallets.debit(ids[static_cast<size_t>(i % users)], 1)) accepted++;
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "Debit: " << seconds * 1e9 / debits << " ns/debit (" << accepted << " accepted)\n";
+    }
+    int64_t baseline = 0;
+    for (const auto& id : ids) baseline += wallets.balance(id);
+
+    // Concurrent debits while top-ups settle in batches
+    std::atomic<bool> done{false};
+    std::atomic<int64_t> debitedCents{0};
+    std::atomic<long> acceptedDebits{0};
+    std::atomic<long> declinedDebits{0};
+    int64_t toppedUpCents = 0;
+    long batches = 0;
+
+    uint64_t ledgerBefore = wallets.getLedgerSize();
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (long t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            std::mt19937 rng(static_cast<unsigned>(t + 1));
+            std::uniform_int_distribution<long> pick(0, users - 1);
+            std::uniform_int_distribution<int64_t> price(250, 450);
+            int64_t local = 0;
+            long ok = 0;
+            long no = 0;
+            for (long i = 0; i < debits; ++i) {
+                int64_t amount = price(rng);
+                if (wallets.debit(ids[static_cast<size_t>(pick(rng))], amount)) {
+                    local += amount;
+                    ok++;
+                } else {
+                    no++;
+                }
+            }
+            debitedCents.fetch_add(local);
+            acceptedDebits.fetch_add(ok);
+            declinedDebits.fetch_add(no);
+        });
+    }
+    std::thread settler([&] {
+        std::mt19937 rng(99);
+        std::uniform_int_distribution<long> pick(0, users - 1);
+        while (!done.load(std::memory_order_relaxed)) {
+            for (int i = 0; i < 256; ++i) {
+                wallets.requestTopUp(ids[static_cast<size_t>(pick(rng))], 1000);
+            }
+            WalletStore::Settlement settled = wallets.settleTopUps();
+            toppedUpCents += settled.totalCents;
+            batches++;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        toppedUpCents += wallets.settleTopUps().totalCents;
+    });
+    for (auto& worker : workers) worker.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    done.store(true);
+    settler.join();
+
+    long total = threads * debits;
+    std::cout << "Concurrent: " << threads << " threads x " << debits << " debits in "
+              << std::setprecision(3) << seconds << " s (" << std::setprecision(1)
+              << total / seconds / 1e6 << " M debits/s), " << acceptedDebits.load() << " accepted, "
+              << declinedDebits.load() << " declined; " << batches << " top-up batches\n";
+
+    // Conservation and ledger consistency
+    bool ok = true;
+    int64_t final = 0;
+    for (const auto& id : ids) {
+        int64_t balance = wallets.balance(id);
+        if (balance < 0) ok = false;
+        final += balance;
+    }
+    int64_t expected = baseline + toppedUpCents - debitedCents.load();
+    long ledgerDebits = 0;
+    int64_t ledgerNet = 0;
+    std::vector<WalletStore::LedgerEntry> entries = wallets.ledger();
+    for (const auto& entry : entries) {
+        if (entry.sequence < ledgerBefore) continue;
+        if (entry.type == WalletStore::EntryType::DEBIT) {
+            ledgerDebits++;
+            ledgerNet -= entry.amountCents;
+        } else if (entry.type == WalletStore::EntryType::TOPUP) {
+            ledgerNet += entry.amountCents;
+        }
+    }
+    if (final != expected || ledgerDebits != acceptedDebits.load() || ledgerNet != final - baseline) ok = false;
+    std::cout << "Balances: $" << std::setprecision(2) << final / 100.0 << " held, $" << expected / 100.0
+              << " expected; ledger " << entries.size() << " entries, net $" << ledgerNet / 100.0
+              << (ok ? " - consistent" : " - MISMATCH") << "\n";
+
+    // End to end: User orders paid from the wallet
+    {
+        User regular(ids[0], "Regular");
+        wallets.requestTopUp(regular.getUserId(), 1000000);
+        wallets.settleTopUps();
+        CoffeeMachine* machine = CoffeeMachine::getInstance();
+        auto orderStart = std::chrono::steady_clock::now();
+        {
+            ConsoleGuard quiet;
+            for (long i = 0; i < orders; ++i) {
+                int choice = static_cast<int>(i % 5) + 1;
+                if (!machine->getInventory()->checkAvailability(static_cast<CoffeeType>(choice - 1))) {
+                    for (const auto& [ingredient, amount] : Operator::getRefillAmounts()) {
+                        machine->getInventory()->refillIngredient(ingredient, amount);
+                    }
+                }
+                regular.selectCoffee(choice);
+                regular.makePayment(regular.walletPayment(wallets));
+            }
+        }
+        double orderSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - orderStart).count();
+        std::cout << "Orders: " << orders << " wallet-paid orders, " << std::setprecision(2)
+                  << orderSeconds * 1e6 / orders << " us/order; " << regular.getUserId()
+                  << " balance $" << wallets.balance(regular.getUserId()) / 100.0 << ", "
+                  << wallets.ledger(regular.getUserId()).size() << " ledger entries\n";
+    }
+    return ok ? 0 : 1;
+}
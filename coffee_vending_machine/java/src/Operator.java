@@ -1,5 +1,8 @@
 import java.util.ArrayList;
+import java.util.Collections;
+import java.util.LinkedHashMap;
 import java.util.List;
+import java.util.Map;
 
 // Operator Actor - Manages and maintains the Coffee Machine
 // Implements Observer Pattern to receive inventory alerts
@@ -77,14 +80,29 @@ public class Operator implements InventoryObserver {
         System.out.println("Alerts cleared.");
     }
 
+    // Standard top-up applied by refillAll
+    private static final Map<String, Integer> REFILL_AMOUNTS;
+
+    static {
+        Map<String, Integer> amounts = new LinkedHashMap<>();
+        amounts.put("Coffee Beans", 400);
+        amounts.put("Water", 1500);
+        amounts.put("Milk", 800);
+        amounts.put("Chocolate", 150);
+        amounts.put("Cups", 40);
+        REFILL_AMOUNTS = Collections.unmodifiableMap(amounts);
+    }
+
+    public static Map<String, Integer> getRefillAmounts() {
+        return REFILL_AMOUNTS;
+    }
+
     // Refill all ingredients to maximum
     public void refillAll() {
         System.out.println("\nOperator " + name + " refilling all ingredients...");
-        refillIngredient("Coffee Beans", 400);
-        refillIngredient("Water", 1500);
-        refillIngredient("Milk", 800);
-        refillIngredient("Chocolate", 150);
-        refillIngredient("Cups", 40);
+        for (Map.Entry<String, Integer> entry : REFILL_AMOUNTS.entrySet()) {
+            refillIngredient(entry.getKey(), entry.getValue());
+        }
         System.out.println("All ingredients refilled.");
     }
 
@@ -0,0 +1,255 @@
+import java.io.IOException;
+import java.io.OutputStream;
+import java.io.PrintStream;
+import java.nio.file.Files;
+import java.nio.file.Paths;
+import java.util.ArrayList;
+import java.util.Arrays;
+import java.util.HashMap;
+import java.util.List;
+import java.util.Locale;
+import java.util.Map;
+
+/**
+ * Coffee Vending Machine - Cross-Language Parity Driver (Java)
+ *
+ * Runs the shared workload in parity/workload.conf headless against this
+ * implementation and prints one PARITY line in the format shared with the
+ * C++ driver (cpp/parity_driver.cpp):
+ *
+ *   PARITY impl=java orders=N completed=N cancelled=N declined=N refills=N
+ *          revenue=D seconds=D orders_per_sec=D p50_us=D p90_us=D p99_us=D
+ *          p999_us=D max_us=D peak_rss_kb=N
+ *
+ * Startup time is measured from outside by parity/run_parity.sh, which
+ * launches the driver with --startup (build the machine, serve one order,
+ * exit) so that JVM start-up is included.
+ *
+ * Usage: java ParityDriver [--workload FILE] [--orders N] [--startup]
+ */
+public class ParityDriver {
+
+    static class Workload {
+        long seed;
+        long warmupOrders;
+        long orders;
+        long[] orderMix;
+        long[] paymentMix;
+        long cancelPercent;
+        long declinePercent;
+        long refillEvery;
+    }
+
+    static class Counters {
+        long completed;
+        long cancelled;
+        long declined;
+        long refills;
+        long revenueCents;
+    }
+
+    // key = value lines, '#' comments; values are whitespace-separated integers
+    static Workload loadWorkload(String path) throws IOException {
+        Map<String, List<Long>> values = new HashMap<>();
+        for (String line : Files.readAllLines(Paths.get(path))) {
+            int hash = line.indexOf('#');
+            if (hash >= 0) line = line.substring(0, hash);
+            int eq = line.indexOf('=');
+            if (eq < 0) continue;
+            List<Long> list = values.computeIfAbsent(line.substring(0, eq).trim(), k -> new ArrayList<>());
+            for (String token : line.substring(eq + 1).trim().split("\\s+")) {
+                if (!token.isEmpty()) list.add(Long.parseLong(token));
+            }
+        }
+        Workload workload = new Workload();
+        workload.seed = scalar(values, "seed");
+        workload.warmupOrders = scalar(values, "warmup_orders");
+        workload.orders = scalar(values, "orders");
+        workload.cancelPercent = scalar(values, "cancel_percent");
+        workload.declinePercent = scalar(values, "decline_percent");
+        workload.refillEvery = Math.max(1, scalar(values, "refill_every"));
+        workload.orderMix = weights(values, "order_mix", 5);
+        workload.paymentMix = weights(values, "payment_mix", 3);
+        return workload;
+    }
+
+    private static long scalar(Map<String, List<Long>> values, String name) {
+        List<Long> list = values.get(name);
+        if (list == null || list.size() != 1) {
+            throw new IllegalArgumentException("Workload: '" + name + "' needs one value");
+        }
+        return list.get(0);
+    }
+
+    private static long[] weights(Map<String, List<Long>> values, String name, int count) {
+        List<Long> list = values.get(name);
+        if (list == null || list.size() != count) {
+            throw new IllegalArgumentException("Workload: " + name + " needs " + count + " weights");
+        }
+        return list.stream().mapToLong(Long::longValue).toArray();
+    }
+
+    // splitmix64, identical to the C++ driver's
+    static class ParityRandom {
+        private long state;
+
+        ParityRandom(long seed) {
+            this.state = seed;
+        }
+
+        long next() {
+            long z = (state += 0x9E3779B97F4A7C15L);
+            z = (z ^ (z >>> 30)) * 0xBF58476D1CE4E5B9L;
+            z = (z ^ (z >>> 27)) * 0x94D049BB133111EBL;
+            return (z ^ (z >>> 31)) >>> 1;
+        }
+    }
+
+    static int pickWeighted(long[] weights, long r) {
+        long total = 0;
+        for (long w : weights) total += w;
+        long target = r % total;
+        for (int i = 0; i < weights.length; i++) {
+            if (target < weights[i]) return i;
+            target -= weights[i];
+        }
+        return weights.length - 1;
+    }
+
+    static void refillAll(CoffeeMachine machine) {
+        for (Map.Entry<String, Integer> entry : Operator.getRefillAmounts().entrySet()) {
+            machine.getInventory().refillIngredient(entry.getKey(), entry.getValue());
+        }
+    }
+
+    static void runOrder(CoffeeMachine machine, Workload workload, ParityRandom rng,
+                         long index, Counters counters) {
+        int choice = pickWeighted(workload.orderMix, rng.next()) + 1;
+        boolean cancel = rng.next() % 100 < workload.cancelPercent;
+        int method = pickWeighted(workload.paymentMix, rng.next());
+        boolean shortCash = rng.next() % 100 < workload.declinePercent;
+
+        if (index > 0 && index % workload.refillEvery == 0) {
+            refillAll(machine);
+            counters.refills++;
+        }
+        if (!machine.getInventory().checkAvailability(CoffeeFactory.CoffeeType.values()[choice - 1])) {
+            refillAll(machine);
+            counters.refills++;
+        }
+
+        machine.selectCoffee(choice);
+        if (cancel) {
+            machine.cancelOrder();
+            counters.cancelled++;
+            return;
+        }
+        long priceCents = Math.round(machine.getSelectedCoffee().getPrice() * 100);
+        switch (method) {
+            case 0:
+                if (shortCash) {
+                    machine.makePayment(new CashPayment(0.50));
+                    counters.declined++;
+                }
+                machine.makePayment(new CashPayment(10.00));
+                break;
+            case 1:
+                machine.makePayment(new CardPayment("4111111111111111", "1234"));
+                break;
+            default:
+                machine.makePayment(new UPIPayment("parity@bank"));
+                break;
+        }
+        if (machine.getSelectedCoffee() == null) {
+            counters.completed++;
+            counters.revenueCents += priceCents;
+        }
+    }
+
+    // Peak resident set from the kernel, read the same way by both drivers
+    static long peakRssKb() {
+        try {
+            for (String line : Files.readAllLines(Paths.get("/proc/self/status"))) {
+                if (line.startsWith("VmHWM:")) {
+                    return Long.parseLong(line.substring(6).trim().split("\\s+")[0]);
+                }
+            }
+        } catch (IOException | NumberFormatException e) {
+            // not Linux
+        }
+        return -1;
+    }
+
+    static double percentileUs(long[] sorted, double q) {
+        int index = (int) Math.min(sorted.length - 1, (long) (sorted.length * q));
+        return sorted[index] / 1000.0;
+    }
+
+    public static void main(String[] args) throws IOException {
+        String path = "../../parity/workload.conf"; // from java/bin
+        long ordersOverride = 0;
+        boolean startupOnly = false;
+
+        for (int i = 0; i < args.length; i++) {
+            if (args[i].equals("--workload") && i + 1 < args.length) {
+                path = args[++i];
+            } else if (args[i].equals("--orders") && i + 1 < args.length) {
+                ordersOverride = Math.max(1, Long.parseLong(args[++i]));
+            } else if (args[i].equals("--startup")) {
+                startupOnly = true;
+            } else {
+                System.err.println("Usage: java ParityDriver [--workload FILE] [--orders N] [--startup]");
+                System.exit(1);
+            }
+        }
+
+        Workload workload;
+        try {
+            workload = loadWorkload(path);
+        } catch (IOException | IllegalArgumentException e) {
+            System.err.println("Cannot load workload " + path + ": " + e.getMessage());
+            System.exit(1);
+            return;
+        }
+        if (ordersOverride > 0) workload.orders = ordersOverride;
+
+        CoffeeMachine machine = CoffeeMachine.getInstance();
+        ParityRandom rng = new ParityRandom(workload.seed);
+        Counters counters = new Counters();
+        PrintStream console = System.out;
+        PrintStream quiet = new PrintStream(OutputStream.nullOutputStream());
+
+        if (startupOnly) {
+            System.setOut(quiet);
+            runOrder(machine, workload, rng, 0, counters);
+            System.setOut(console);
+            System.out.println("PARITY impl=java ready completed=" + counters.completed);
+            return;
+        }
+
+        long[] latencies = new long[(int) workload.orders];
+        System.setOut(quiet);
+        for (long i = 0; i < workload.warmupOrders; i++) {
+            runOrder(machine, workload, rng, i, counters);
+        }
+        counters = new Counters();
+        long start = System.nanoTime();
+        for (int i = 0; i < workload.orders; i++) {
+            long begin = System.nanoTime();
+            runOrder(machine, workload, rng, workload.warmupOrders + i, counters);
+            latencies[i] = System.nanoTime() - begin;
+        }
+        double seconds = (System.nanoTime() - start) / 1e9;
+        System.setOut(console);
+
+        Arrays.sort(latencies);
+        System.out.println(String.format(Locale.ROOT,
+            "PARITY impl=java orders=%d completed=%d cancelled=%d declined=%d refills=%d "
+            + "revenue=%d.%02d seconds=%.3f orders_per_sec=%.0f p50_us=%.2f p90_us=%.2f p99_us=%.2f "
+            + "p999_us=%.2f max_us=%.2f peak_rss_kb=%d",
+            workload.orders, counters.completed, counters.cancelled, counters.declined,
+            counters.refills, counters.revenueCents / 100, counters.revenueCents % 100, seconds, workload.orders / seconds,
+            percentileUs(latencies, 0.50), percentileUs(latencies, 0.90), percentileUs(latencies, 0.99),
+            percentileUs(latencies, 0.999), latencies[latencies.length - 1] / 1000.0, peakRssKb()));
+    }
+}
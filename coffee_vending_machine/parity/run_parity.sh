@@ -0,0 +1,84 @@
+#!/bin/bash
+# Coffee Vending Machine - C++ vs Java Parity Run
+#
+# Builds both headless drivers, runs the shared workload through each, and
+# prints their PARITY lines with startup_ms appended, then a side-by-side
+# table. startup_ms is the median wall time of STARTUP_RUNS launches with
+# --startup (process/JVM start, machine construction, one order, exit).
+#
+# Usage: parity/run_parity.sh [WORKLOAD]   (default parity/workload.conf)
+
+cd "$(dirname "$0")/.."
+ROOT="$(pwd)"
+WORKLOAD="$(realpath "${1:-parity/workload.conf}")"
+STARTUP_RUNS=${STARTUP_RUNS:-5}
+
+# Median wall-clock milliseconds of STARTUP_RUNS launches of "$@"
+startup_ms() {
+    for _ in $(seq "$STARTUP_RUNS"); do
+        local start end
+        start=$(date +%s%N)
+        "$@" > /dev/null || return 1
+        end=$(date +%s%N)
+        echo $(( (end - start) / 1000 ))
+    done | sort -n | awk '{ t[NR] = $1 } END { printf "%.1f", t[int((NR + 1) / 2)] / 1000 }'
+}
+
+RESULTS=()
+
+echo "Workload: $WORKLOAD"
+echo ""
+
+if make -s -C "$ROOT/cpp" parity_driver; then
+    line=$("$ROOT/cpp/parity_driver" --workload "$WORKLOAD")
+    startup=$(startup_ms "$ROOT/cpp/parity_driver" --workload "$WORKLOAD" --startup)
+    RESULTS+=("$line startup_ms=$startup")
+else
+    echo "C++ build failed; skipping C++."
+fi
+
+if command -v javac > /dev/null && command -v java > /dev/null; then
+    if "$ROOT/java/build.sh" > /dev/null; then
+        line=$(java -cp "$ROOT/java/bin" ParityDriver --workload "$WORKLOAD")
+        startup=$(startup_ms java -cp "$ROOT/java/bin" ParityDriver --workload "$WORKLOAD" --startup)
+        RESULTS+=("$line startup_ms=$startup")
+    else
+        echo "Java build failed; skipping Java."
+    fi
+else
+    echo "No JDK on PATH; skipping Java."
+fi
+
+echo ""
+for line in "${RESULTS[@]}"; do
+    echo "$line"
+done
+
+# Side-by-side table; counters must agree for the timings to be comparable
+printf '%s\n' "${RESULTS[@]}" | awk '
+{
+    for (i = 2; i <= NF; i++) {
+        split($i, kv, "=")
+        if (!(kv[1] in seen)) { seen[kv[1]] = 1; keys[++nkeys] = kv[1] }
+        value[NR, kv[1]] = kv[2]
+    }
+    rows = NR
+}
+END {
+    if (rows == 0) exit 1
+    printf "\n%-16s", "metric"
+    for (r = 1; r <= rows; r++) printf "%14s", value[r, "impl"]
+    printf "\n"
+    for (k = 2; k <= nkeys; k++) {
+        printf "%-16s", keys[k]
+        for (r = 1; r <= rows; r++) printf "%14s", value[r, keys[k]]
+        printf "\n"
+    }
+    if (rows > 1) {
+        split("orders completed cancelled declined refills revenue", checked, " ")
+        same = 1
+        for (c in checked) if (value[1, checked[c]] != value[2, checked[c]]) same = 0
+        print (same ? "\nWorkload parity: counters match" : "\nWorkload parity: COUNTERS DIFFER")
+        exit same ? 0 : 1
+    }
+}'